@@ -158,6 +158,9 @@ macro(write_configtable)
   string(APPEND out "MPI Support                   : ")
   check_on_or_off("${NS3_MPI}" "${MPI_FOUND}")
 
+  string(APPEND out "Multithreaded Simulation      : ")
+  check_on_or_off("${NS3_MTP}" "${NS3_MTP}")
+
   string(APPEND out "ns-3 Click Integration        : ")
   check_on_or_off("ON" "${NS3_CLICK}")
 
@@ -176,6 +179,12 @@ macro(write_configtable)
   string(APPEND out "SQLite support                : ")
   check_on_or_off("${NS3_SQLITE}" "${ENABLE_SQLITE}")
 
+  string(APPEND out "pcap gzip compression         : ")
+  check_on_or_off("${NS3_PCAP_COMPRESSION}" "${ENABLE_ZLIB}")
+
+  string(APPEND out "pcap zstd compression         : ")
+  check_on_or_off("${NS3_PCAP_COMPRESSION}" "${ENABLE_ZSTD}")
+
   string(APPEND out "Eigen3 support                : ")
   check_on_or_off("${NS3_EIGEN}" "${ENABLE_EIGEN}")
 
@@ -660,6 +660,32 @@ macro(process_options)
     endif()
   endif()
 
+  set(ENABLE_ZLIB False)
+  set(ENABLE_ZSTD False)
+  if(${NS3_PCAP_COMPRESSION})
+    find_external_library(DEPENDENCY_NAME ZLIB HEADER_NAME zlib.h LIBRARY_NAME z)
+
+    if(${ZLIB_FOUND})
+      set(ENABLE_ZLIB True)
+      add_definitions(-DHAVE_ZLIB)
+      include_directories(${ZLIB_INCLUDE_DIRS})
+    else()
+      message(${HIGHLIGHTED_STATUS} "zlib was not found")
+    endif()
+
+    find_external_library(
+      DEPENDENCY_NAME ZSTD HEADER_NAME zstd.h LIBRARY_NAME zstd
+    )
+
+    if(${ZSTD_FOUND})
+      set(ENABLE_ZSTD True)
+      add_definitions(-DHAVE_ZSTD)
+      include_directories(${ZSTD_INCLUDE_DIRS})
+    else()
+      message(${HIGHLIGHTED_STATUS} "zstd was not found")
+    endif()
+  endif()
+
   if(${NS3_NATIVE_OPTIMIZATIONS} AND ${GCC})
     add_compile_options(-march=native -mtune=native)
   endif()
@@ -1025,6 +1051,10 @@ macro(process_options)
     endif()
   endif()
 
+  if(${NS3_MTP})
+    add_definitions(-DNS3_MTP)
+  endif()
+
   mark_as_advanced(Boost_INCLUDE_DIR)
   find_package(Boost)
   if(${Boost_FOUND})
@@ -1351,6 +1381,10 @@ macro(process_options)
     list(REMOVE_ITEM libs_to_build mpi)
   endif()
 
+  if(NOT ${NS3_MTP})
+    list(REMOVE_ITEM libs_to_build mtp)
+  endif()
+
   if(NOT ${ENABLE_VISUALIZER})
     list(REMOVE_ITEM libs_to_build visualizer)
   endif()
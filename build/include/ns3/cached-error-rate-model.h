@@ -0,0 +1 @@
+#include "/root/repo/src/wifi/model/cached-error-rate-model.h"
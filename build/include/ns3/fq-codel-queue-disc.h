@@ -0,0 +1 @@
+#include "/root/repo/src/traffic-control/model/fq-codel-queue-disc.h"
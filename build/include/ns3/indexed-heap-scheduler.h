@@ -0,0 +1 @@
+#include "/root/repo/src/core/model/indexed-heap-scheduler.h"
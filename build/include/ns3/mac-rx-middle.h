@@ -0,0 +1 @@
+#include "/root/repo/src/wifi/model/mac-rx-middle.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/wifi/model/rate-control/minstrel-wifi-manager.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/spectrum/model/non-communicating-net-device.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/mobility/helper/ns2-mobility-helper.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/propagation/model/okumura-hata-propagation-loss-model.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/wifi/model/wifi-radio-energy-model.h"
@@ -20,6 +20,7 @@
 #include "default-simulator-impl.h"
 
 #include "assert.h"
+#include "boolean.h"
 #include "log.h"
 #include "scheduler.h"
 #include "simulator.h"
@@ -48,11 +49,22 @@ DefaultSimulatorImpl::GetTypeId()
     static TypeId tid = TypeId("ns3::DefaultSimulatorImpl")
                             .SetParent<SimulatorImpl>()
                             .SetGroupName("Core")
-                            .AddConstructor<DefaultSimulatorImpl>();
+                            .AddConstructor<DefaultSimulatorImpl>()
+                            .AddAttribute("PurgeCancelledEvents",
+                                          "Remove cancelled events from the event list right "
+                                          "away, as Simulator::Remove() does, instead of leaving "
+                                          "them in the list until they expire. This is cheap with "
+                                          "schedulers supporting fast removal, such as "
+                                          "ns3::IndexedHeapScheduler.",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(
+                                              &DefaultSimulatorImpl::m_purgeCancelled),
+                                          MakeBooleanChecker());
     return tid;
 }
 
 DefaultSimulatorImpl::DefaultSimulatorImpl()
+    : m_eventsWithContext(EVENTS_WITH_CONTEXT_CAPACITY)
 {
     NS_LOG_FUNCTION(this);
     m_stop = false;
@@ -62,7 +74,8 @@ DefaultSimulatorImpl::DefaultSimulatorImpl()
     m_currentContext = Simulator::NO_CONTEXT;
     m_unscheduledEvents = 0;
     m_eventCount = 0;
-    m_eventsWithContextEmpty = true;
+    m_cancelledEvents = 0;
+    m_purgeCancelled = false;
     m_mainThreadId = std::this_thread::get_id();
 }
 
@@ -136,6 +149,11 @@ DefaultSimulatorImpl::ProcessOneEvent()
     NS_ASSERT(next.key.m_ts >= m_currentTs);
     m_unscheduledEvents--;
     m_eventCount++;
+    if (next.impl->IsCancelled())
+    {
+        NS_ASSERT(m_cancelledEvents > 0);
+        m_cancelledEvents--;
+    }
 
     NS_LOG_LOGIC("handle " << next.key.m_ts);
     m_currentTs = next.key.m_ts;
@@ -156,22 +174,12 @@ DefaultSimulatorImpl::IsFinished() const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext()
 {
-    if (m_eventsWithContextEmpty)
+    if (m_eventsWithContext.IsEmpty())
     {
         return;
     }
 
-    // swap queues
-    EventsWithContext eventsWithContext;
-    {
-        std::unique_lock lock{m_eventsWithContextMutex};
-        m_eventsWithContext.swap(eventsWithContext);
-        m_eventsWithContextEmpty = true;
-    }
-    while (!eventsWithContext.empty())
-    {
-        EventWithContext event = eventsWithContext.front();
-        eventsWithContext.pop_front();
+    m_eventsWithContext.Drain([this](const EventWithContext& event) {
         Scheduler::Event ev;
         ev.impl = event.event;
         ev.key.m_ts = m_currentTs + event.timestamp;
@@ -180,7 +188,7 @@ DefaultSimulatorImpl::ProcessEventsWithContext()
         m_uid++;
         m_unscheduledEvents++;
         m_events->Insert(ev);
-    }
+    });
 }
 
 void
@@ -264,11 +272,7 @@ DefaultSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, E
         // Current time added in ProcessEventsWithContext()
         ev.timestamp = delay.GetTimeStep();
         ev.event = event;
-        {
-            std::unique_lock lock{m_eventsWithContextMutex};
-            m_eventsWithContext.push_back(ev);
-            m_eventsWithContextEmpty = false;
-        }
+        m_eventsWithContext.Push(ev);
     }
 }
 
@@ -349,9 +353,19 @@ DefaultSimulatorImpl::Remove(const EventId& id)
 void
 DefaultSimulatorImpl::Cancel(const EventId& id)
 {
-    if (!IsExpired(id))
+    if (IsExpired(id))
     {
-        id.PeekEventImpl()->Cancel();
+        return;
+    }
+    if (m_purgeCancelled)
+    {
+        Remove(id);
+        return;
+    }
+    id.PeekEventImpl()->Cancel();
+    if (id.GetUid() != EventId::UID::DESTROY)
+    {
+        m_cancelledEvents++;
     }
 }
 
@@ -405,4 +419,10 @@ DefaultSimulatorImpl::GetEventCount() const
     return m_eventCount;
 }
 
+uint64_t
+DefaultSimulatorImpl::GetCancelledEventCount() const
+{
+    return m_cancelledEvents;
+}
+
 } // namespace ns3
@@ -20,10 +20,10 @@
 #ifndef DEFAULT_SIMULATOR_IMPL_H
 #define DEFAULT_SIMULATOR_IMPL_H
 
+#include "mpsc-queue.h"
 #include "simulator-impl.h"
 
 #include <list>
-#include <mutex>
 #include <thread>
 
 /**
@@ -77,6 +77,7 @@ class DefaultSimulatorImpl : public SimulatorImpl
     uint32_t GetSystemId() const override;
     uint32_t GetContext() const override;
     uint64_t GetEventCount() const override;
+    uint64_t GetCancelledEventCount() const override;
 
   private:
     void DoDispose() override;
@@ -96,17 +97,10 @@ class DefaultSimulatorImpl : public SimulatorImpl
         /** The event implementation. */
         EventImpl* event;
     };
-    /** Container type for the events from a different context. */
-    typedef std::list<struct EventWithContext> EventsWithContext;
-    /** The container of events from a different context. */
-    EventsWithContext m_eventsWithContext;
-    /**
-     * Flag \c true if all events with context have been moved to the
-     * primary event queue.
-     */
-    bool m_eventsWithContextEmpty;
-    /** Mutex to control access to the list of events with context. */
-    std::mutex m_eventsWithContextMutex;
+    /** Number of events scheduled from other threads held without locking. */
+    static const uint32_t EVENTS_WITH_CONTEXT_CAPACITY = 1024;
+    /** The queue of events scheduled from other threads. */
+    MpscQueue<EventWithContext> m_eventsWithContext;
 
     /** Container type for the events to run at Simulator::Destroy() */
     typedef std::list<EventId> DestroyEvents;
@@ -127,6 +121,10 @@ class DefaultSimulatorImpl : public SimulatorImpl
     uint32_t m_currentContext;
     /** The event count. */
     uint64_t m_eventCount;
+    /** Number of cancelled events still in the event list. */
+    uint64_t m_cancelledEvents;
+    /** Whether Cancel() removes the event from the event list. */
+    bool m_purgeCancelled;
     /**
      * Number of events that have been inserted but not yet scheduled,
      *  not counting the Destroy events; this is used for validation
@@ -21,6 +21,9 @@
 
 #include "log.h"
 
+#include <mutex>
+#include <vector>
+
 /**
  * \file
  * \ingroup events
@@ -32,13 +35,191 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+namespace
+{
+
+/**
+ * \ingroup events
+ * A free list arena of fixed size blocks for EventImpl instances.
+ *
+ * Blocks are carved out of large chunks, and released blocks are kept
+ * in one free list per size class.  Chunks are never returned to the
+ * system, since blocks may be released by another thread than the one
+ * which allocated them.
+ */
+class EventArena
+{
+  public:
+    /**
+     * Allocate a block.
+     * \param [in] size The size of the block.
+     * \returns The block.
+     */
+    void* Allocate(std::size_t size);
+    /**
+     * Release a block.
+     * \param [in] ptr The block.
+     * \param [in] size The size of the block.
+     */
+    void Release(void* ptr, std::size_t size);
+
+    /** Size class granularity, and alignment of the blocks. */
+    static constexpr std::size_t GRANULARITY = alignof(std::max_align_t);
+    /** Number of size classes. */
+    static constexpr std::size_t CLASSES = 16;
+    /** Size of the chunks the blocks are carved from. */
+    static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+    /** A released block. */
+    struct FreeBlock
+    {
+        FreeBlock* next; //!< The next block of the free list.
+    };
+
+    FreeBlock* m_free[CLASSES] = {}; //!< The free lists, per size class.
+    char* m_cursor{nullptr};         //!< Start of the unused part of the current chunk.
+    char* m_end{nullptr};            //!< End of the current chunk.
+    std::vector<char*> m_chunks;     //!< The chunks.
+    int64_t m_live{0};               //!< Allocations minus releases.
+    uint64_t m_allocations{0};       //!< Number of allocations.
+    uint64_t m_hits{0};              //!< Number of allocations served by a free list.
+};
+
+void*
+EventArena::Allocate(std::size_t size)
+{
+    m_live++;
+    m_allocations++;
+    std::size_t index = (size - 1) / GRANULARITY;
+    if (index >= CLASSES)
+    {
+        return ::operator new(size);
+    }
+    FreeBlock* block = m_free[index];
+    if (block != nullptr)
+    {
+        m_hits++;
+        m_free[index] = block->next;
+        return block;
+    }
+    std::size_t blockSize = (index + 1) * GRANULARITY;
+    if (static_cast<std::size_t>(m_end - m_cursor) < blockSize)
+    {
+        m_cursor = static_cast<char*>(::operator new(CHUNK_SIZE));
+        m_end = m_cursor + CHUNK_SIZE;
+        m_chunks.push_back(m_cursor);
+    }
+    void* ptr = m_cursor;
+    m_cursor += blockSize;
+    return ptr;
+}
+
+void
+EventArena::Release(void* ptr, std::size_t size)
+{
+    m_live--;
+    std::size_t index = (size - 1) / GRANULARITY;
+    if (index >= CLASSES)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = m_free[index];
+    m_free[index] = block;
+}
+
+/**
+ * Get the mutex protecting the arena lists.
+ * \returns The mutex.
+ */
+std::mutex&
+GetArenasMutex()
+{
+    // Never deleted: events may be released during static destruction.
+    static std::mutex* mutex = new std::mutex;
+    return *mutex;
+}
+
+/**
+ * Get all the arenas ever created.
+ * \returns The arenas.
+ */
+std::vector<EventArena*>&
+GetArenas()
+{
+    static std::vector<EventArena*>* arenas = new std::vector<EventArena*>;
+    return *arenas;
+}
+
+/**
+ * Get the arenas of the threads which exited, ready to be reused.
+ * \returns The idle arenas.
+ */
+std::vector<EventArena*>&
+GetIdleArenas()
+{
+    static std::vector<EventArena*>* arenas = new std::vector<EventArena*>;
+    return *arenas;
+}
+
+/** The arena of the current thread. */
+thread_local EventArena* t_arena = nullptr;
+
+/**
+ * Hand the arena of a thread over to the idle list when the thread exits.
+ */
+struct EventArenaGuard
+{
+    /** Mark the guard as used, so that it is destroyed at thread exit. */
+    void Attach()
+    {
+    }
+
+    ~EventArenaGuard()
+    {
+        std::unique_lock lock(GetArenasMutex());
+        GetIdleArenas().push_back(t_arena);
+        t_arena = nullptr;
+    }
+};
+
+/**
+ * Get the arena of the current thread, creating it if needed.
+ * \returns The arena.
+ */
+EventArena*
+GetArena()
+{
+    if (t_arena == nullptr)
+    {
+        static thread_local EventArenaGuard guard;
+        guard.Attach();
+        std::unique_lock lock(GetArenasMutex());
+        if (GetIdleArenas().empty())
+        {
+            t_arena = new EventArena;
+            GetArenas().push_back(t_arena);
+        }
+        else
+        {
+            t_arena = GetIdleArenas().back();
+            GetIdleArenas().pop_back();
+        }
+    }
+    return t_arena;
+}
+
+} // unnamed namespace
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
 }
 
 EventImpl::EventImpl()
-    : m_cancel(false)
+    : m_cancel(false),
+      m_slot(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -67,4 +248,52 @@ EventImpl::IsCancelled()
     return m_cancel;
 }
 
+void*
+EventImpl::operator new(std::size_t size)
+{
+    return GetArena()->Allocate(size);
+}
+
+void*
+EventImpl::operator new(std::size_t size, std::align_val_t align)
+{
+    return ::operator new(size, align);
+}
+
+void
+EventImpl::operator delete(void* ptr, std::size_t size)
+{
+    GetArena()->Release(ptr, size);
+}
+
+void
+EventImpl::operator delete(void* ptr, std::size_t size, std::align_val_t align)
+{
+    ::operator delete(ptr, size, align);
+}
+
+double
+EventImpl::AllocationStats::GetHitRate() const
+{
+    return allocations == 0 ? 0 : static_cast<double>(hits) / allocations;
+}
+
+EventImpl::AllocationStats
+EventImpl::GetAllocationStats()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    AllocationStats stats = {0, 0, 0, 0};
+    int64_t live = 0;
+    std::unique_lock lock(GetArenasMutex());
+    for (const auto arena : GetArenas())
+    {
+        live += arena->m_live;
+        stats.arenaBytes += arena->m_chunks.size() * EventArena::CHUNK_SIZE;
+        stats.allocations += arena->m_allocations;
+        stats.hits += arena->m_hits;
+    }
+    stats.liveEvents = live;
+    return stats;
+}
+
 } // namespace ns3
@@ -21,6 +21,8 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
+#include <new>
 #include <stdint.h>
 
 /**
@@ -66,6 +68,86 @@ class EventImpl : public SimpleRefCount<EventImpl>
      * Checked by the simulation engine before calling Invoke().
      */
     bool IsCancelled();
+    /**
+     * Get the slot of the event in the scheduler holding it.
+     *
+     * Schedulers which need to locate an event in constant time, such as
+     * IndexedHeapScheduler, record its position in the event itself.
+     *
+     * \returns The slot, as set by SetSchedulerSlot().
+     */
+    inline uint32_t GetSchedulerSlot() const;
+    /**
+     * Record the slot of the event in the scheduler holding it.
+     *
+     * \param [in] slot The slot.
+     */
+    inline void SetSchedulerSlot(uint32_t slot);
+
+    /**
+     * Allocate storage for an event.
+     *
+     * Events are allocated from a per thread arena of fixed size blocks,
+     * grouped by size class, and recycled when their reference count
+     * drops to zero.  This covers the EventImpl subclasses created by
+     * the MakeEvent() functions, whatever the size of their bound
+     * arguments.  Events larger than the largest size class are
+     * allocated with the global operator new.
+     *
+     * \param [in] size The size of the event.
+     * \returns The storage for the event.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Allocate storage for an over-aligned event,
+     * with the global operator new.
+     *
+     * \param [in] size The size of the event.
+     * \param [in] align The alignment of the event.
+     * \returns The storage for the event.
+     */
+    static void* operator new(std::size_t size, std::align_val_t align);
+    /**
+     * Release the storage of an event to the arena.
+     *
+     * \param [in] ptr The storage of the event.
+     * \param [in] size The size of the event.
+     */
+    static void operator delete(void* ptr, std::size_t size);
+    /**
+     * Release the storage of an over-aligned event.
+     *
+     * \param [in] ptr The storage of the event.
+     * \param [in] size The size of the event.
+     * \param [in] align The alignment of the event.
+     */
+    static void operator delete(void* ptr, std::size_t size, std::align_val_t align);
+
+    /** Event allocation statistics. */
+    struct AllocationStats
+    {
+        uint64_t liveEvents;  //!< Number of events currently allocated.
+        uint64_t arenaBytes;  //!< Number of bytes reserved by the arenas.
+        uint64_t allocations; //!< Total number of event allocations.
+        uint64_t hits;        //!< Number of allocations served by a free list.
+
+        /**
+         * Get the fraction of allocations which reused a recycled block.
+         * \returns The hit rate, between 0 and 1.
+         */
+        double GetHitRate() const;
+    };
+
+    /**
+     * Get the event allocation statistics, summed over all threads.
+     *
+     * The statistics of the threads running events are only consistent
+     * while these threads are stopped, for instance before or after
+     * Simulator::Run().
+     *
+     * \returns The event allocation statistics.
+     */
+    static AllocationStats GetAllocationStats();
 
   protected:
     /**
@@ -77,9 +159,26 @@ class EventImpl : public SimpleRefCount<EventImpl>
     virtual void Notify() = 0;
 
   private:
-    bool m_cancel; /**< Has this event been cancelled. */
+    bool m_cancel;   /**< Has this event been cancelled. */
+    uint32_t m_slot; /**< Slot of the event in its scheduler. */
 };
 
+/*************************************************
+ **  Inline implementations
+ ************************************************/
+
+uint32_t
+EventImpl::GetSchedulerSlot() const
+{
+    return m_slot;
+}
+
+void
+EventImpl::SetSchedulerSlot(uint32_t slot)
+{
+    m_slot = slot;
+}
+
 } // namespace ns3
 
 #endif /* EVENT_IMPL_H */
@@ -0,0 +1,166 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "indexed-heap-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::IndexedHeapScheduler implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("IndexedHeapScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(IndexedHeapScheduler);
+
+TypeId
+IndexedHeapScheduler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::IndexedHeapScheduler")
+                            .SetParent<Scheduler>()
+                            .SetGroupName("Core")
+                            .AddConstructor<IndexedHeapScheduler>();
+    return tid;
+}
+
+IndexedHeapScheduler::IndexedHeapScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+IndexedHeapScheduler::~IndexedHeapScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+IndexedHeapScheduler::Place(std::size_t pos, const Scheduler::Event& ev)
+{
+    m_heap[pos] = ev;
+    ev.impl->SetSchedulerSlot(static_cast<uint32_t>(pos));
+}
+
+void
+IndexedHeapScheduler::SiftUp(std::size_t pos, const Scheduler::Event& ev)
+{
+    while (pos > 0)
+    {
+        std::size_t parent = (pos - 1) / 2;
+        if (!(ev.key < m_heap[parent].key))
+        {
+            break;
+        }
+        Place(pos, m_heap[parent]);
+        pos = parent;
+    }
+    Place(pos, ev);
+}
+
+void
+IndexedHeapScheduler::SiftDown(std::size_t pos, const Scheduler::Event& ev)
+{
+    std::size_t size = m_heap.size();
+    while (true)
+    {
+        std::size_t child = 2 * pos + 1;
+        if (child >= size)
+        {
+            break;
+        }
+        if (child + 1 < size && m_heap[child + 1].key < m_heap[child].key)
+        {
+            child++;
+        }
+        if (!(m_heap[child].key < ev.key))
+        {
+            break;
+        }
+        Place(pos, m_heap[child]);
+        pos = child;
+    }
+    Place(pos, ev);
+}
+
+void
+IndexedHeapScheduler::RemoveAt(std::size_t pos)
+{
+    Scheduler::Event last = m_heap.back();
+    m_heap.pop_back();
+    if (pos == m_heap.size())
+    {
+        return;
+    }
+    if (pos > 0 && last.key < m_heap[(pos - 1) / 2].key)
+    {
+        SiftUp(pos, last);
+    }
+    else
+    {
+        SiftDown(pos, last);
+    }
+}
+
+void
+IndexedHeapScheduler::Insert(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    NS_ASSERT_MSG(m_heap.size() < UINT32_MAX, "Too many events");
+    m_heap.push_back(ev);
+    SiftUp(m_heap.size() - 1, ev);
+}
+
+bool
+IndexedHeapScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_heap.empty();
+}
+
+Scheduler::Event
+IndexedHeapScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    return m_heap.front();
+}
+
+Scheduler::Event
+IndexedHeapScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    Scheduler::Event next = m_heap.front();
+    RemoveAt(0);
+    return next;
+}
+
+void
+IndexedHeapScheduler::Remove(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    std::size_t pos = ev.impl->GetSchedulerSlot();
+    NS_ASSERT_MSG(pos < m_heap.size() && m_heap[pos].key.m_uid == ev.key.m_uid,
+                  "Event not found");
+    RemoveAt(pos);
+}
+
+} // namespace ns3
@@ -0,0 +1,121 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef INDEXED_HEAP_SCHEDULER_H
+#define INDEXED_HEAP_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::IndexedHeapScheduler declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a binary heap event scheduler with constant time event lookup
+ *
+ * This is a binary heap on a `std::vector`, like HeapScheduler, except
+ * that the position of each event in the heap is recorded in the event
+ * itself with EventImpl::SetSchedulerSlot(), and updated whenever the
+ * event moves.  Remove() can therefore locate the event directly,
+ * instead of searching the whole heap.
+ *
+ * This makes Simulator::Remove() cheap, so that it can be used instead
+ * of Simulator::Cancel() to keep cancelled events out of the event list.
+ * See the DefaultSimulatorImpl::PurgeCancelledEvents attribute.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | Logarithmic     | Heapify
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Heap kept sorted
+ * Remove()     | Logarithmic     | Slot lookup, heapify
+ * RemoveNext() | Logarithmic     | Heapify
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | 3 x `sizeof (*)`<br/>(24 bytes)  | `std::vector`
+ * Per Event | 0                                | Events stored in `std::vector` directly
+ */
+class IndexedHeapScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    IndexedHeapScheduler();
+    /** Destructor. */
+    ~IndexedHeapScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  private:
+    /**
+     * Store an event at a given position, and record the position
+     * in the event.
+     *
+     * \param [in] pos The position.
+     * \param [in] ev The event.
+     */
+    inline void Place(std::size_t pos, const Scheduler::Event& ev);
+    /**
+     * Move an event up to its proper position.
+     *
+     * \param [in] pos The current position of the event.
+     * \param [in] ev The event.
+     */
+    void SiftUp(std::size_t pos, const Scheduler::Event& ev);
+    /**
+     * Move an event down to its proper position.
+     *
+     * \param [in] pos The current position of the event.
+     * \param [in] ev The event.
+     */
+    void SiftDown(std::size_t pos, const Scheduler::Event& ev);
+    /**
+     * Remove the event at a given position.
+     *
+     * \param [in] pos The position.
+     */
+    void RemoveAt(std::size_t pos);
+
+    /** The event list, managed as a heap rooted at index 0. */
+    std::vector<Scheduler::Event> m_heap;
+};
+
+} // namespace ns3
+
+#endif /* INDEXED_HEAP_SCHEDULER_H */
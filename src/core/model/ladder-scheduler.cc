@@ -0,0 +1,278 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+
+#include <algorithm>
+#include <functional>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::LadderScheduler")
+                            .SetParent<Scheduler>()
+                            .SetGroupName("Core")
+                            .AddConstructor<LadderScheduler>();
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topMin(0),
+      m_topMax(0),
+      m_topStart(0),
+      m_rungs(MAX_RUNGS),
+      m_nRungs(0),
+      m_qSize(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint64_t
+LadderScheduler::CurrentStart(const Rung& rung)
+{
+    return rung.start + rung.current * rung.width;
+}
+
+void
+LadderScheduler::Spawn(Bucket& events, uint64_t start, uint64_t end)
+{
+    NS_LOG_FUNCTION(this << events.size() << start << end);
+    NS_ASSERT(m_nRungs < MAX_RUNGS);
+    NS_ASSERT(end > start);
+
+    Rung& rung = m_rungs[m_nRungs];
+    uint64_t span = end - start;
+    uint64_t n = std::min<uint64_t>(std::max<std::size_t>(events.size(), 1), MAX_BUCKETS);
+    rung.width = std::max<uint64_t>((span + n - 1) / n, 1);
+    rung.nBuckets = (span + rung.width - 1) / rung.width;
+    rung.start = start;
+    rung.current = 0;
+    rung.count = events.size();
+    if (rung.buckets.size() < rung.nBuckets)
+    {
+        rung.buckets.resize(rung.nBuckets);
+    }
+    for (const auto& ev : events)
+    {
+        NS_ASSERT(ev.key.m_ts >= start && ev.key.m_ts < end);
+        rung.buckets[(ev.key.m_ts - start) / rung.width].push_back(ev);
+    }
+    events.clear();
+    m_nRungs++;
+}
+
+void
+LadderScheduler::InsertBottom(const Scheduler::Event& ev)
+{
+    // The Bottom is sorted in decreasing order, so that the earliest event
+    // can be popped from the back.
+    auto pos = std::upper_bound(m_bottom.begin(),
+                                m_bottom.end(),
+                                ev,
+                                std::greater<Scheduler::Event>());
+    m_bottom.insert(pos, ev);
+}
+
+void
+LadderScheduler::Refill()
+{
+    while (m_bottom.empty() && m_qSize != 0)
+    {
+        if (m_nRungs == 0)
+        {
+            NS_ASSERT(!m_top.empty());
+            // The whole Top becomes the first rung.
+            m_topStart = m_topMax + 1;
+            Spawn(m_top, m_topMin, m_topStart);
+            continue;
+        }
+
+        Rung& rung = m_rungs[m_nRungs - 1];
+        while (rung.current < rung.nBuckets && rung.buckets[rung.current].empty())
+        {
+            rung.current++;
+        }
+        if (rung.current == rung.nBuckets)
+        {
+            NS_ASSERT(rung.count == 0);
+            m_nRungs--;
+            continue;
+        }
+
+        Bucket& bucket = rung.buckets[rung.current];
+        uint64_t bucketStart = CurrentStart(rung);
+        rung.current++;
+        rung.count -= bucket.size();
+        if (bucket.size() > THRESHOLD && rung.width > 1 && m_nRungs < MAX_RUNGS)
+        {
+            Spawn(bucket, bucketStart, bucketStart + rung.width);
+        }
+        else
+        {
+            m_bottom.swap(bucket);
+            std::sort(m_bottom.begin(), m_bottom.end(), std::greater<Scheduler::Event>());
+        }
+    }
+}
+
+void
+LadderScheduler::Insert(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    m_qSize++;
+    uint64_t ts = ev.key.m_ts;
+    if (ts >= m_topStart)
+    {
+        if (m_top.empty())
+        {
+            m_topMin = ts;
+            m_topMax = ts;
+        }
+        else
+        {
+            m_topMin = std::min(m_topMin, ts);
+            m_topMax = std::max(m_topMax, ts);
+        }
+        m_top.push_back(ev);
+    }
+    else
+    {
+        uint32_t i = 0;
+        while (i < m_nRungs && ts < CurrentStart(m_rungs[i]))
+        {
+            i++;
+        }
+        if (i < m_nRungs)
+        {
+            Rung& rung = m_rungs[i];
+            uint64_t bucket = (ts - rung.start) / rung.width;
+            NS_ASSERT(bucket < rung.nBuckets);
+            rung.buckets[bucket].push_back(ev);
+            rung.count++;
+        }
+        else
+        {
+            InsertBottom(ev);
+        }
+    }
+    Refill();
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    return m_bottom.back();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    Scheduler::Event ev = m_bottom.back();
+    m_bottom.pop_back();
+    m_qSize--;
+    Refill();
+    NS_LOG_DEBUG("remove " << ev.key.m_ts << ", " << ev.key.m_uid << ", " << ev.key.m_context
+                           << ", " << ev.impl);
+    return ev;
+}
+
+void
+LadderScheduler::Remove(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    NS_ASSERT(!IsEmpty());
+    uint64_t ts = ev.key.m_ts;
+    auto sameEvent = [&ev](const Scheduler::Event& other) {
+        return other.key.m_uid == ev.key.m_uid;
+    };
+
+    Bucket* bucket = &m_bottom;
+    Rung* rung = nullptr;
+    if (ts >= m_topStart)
+    {
+        bucket = &m_top;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < m_nRungs; ++i)
+        {
+            if (ts >= CurrentStart(m_rungs[i]))
+            {
+                rung = &m_rungs[i];
+                bucket = &rung->buckets[(ts - rung->start) / rung->width];
+                break;
+            }
+        }
+    }
+
+    if (bucket == &m_bottom)
+    {
+        // Sorted: keep the order.
+        auto i = std::lower_bound(m_bottom.begin(),
+                                  m_bottom.end(),
+                                  ev,
+                                  std::greater<Scheduler::Event>());
+        NS_ASSERT(i != m_bottom.end() && sameEvent(*i));
+        m_bottom.erase(i);
+    }
+    else
+    {
+        // Unsorted: swap with the last element.
+        auto i = std::find_if(bucket->begin(), bucket->end(), sameEvent);
+        NS_ASSERT(i != bucket->end());
+        *i = bucket->back();
+        bucket->pop_back();
+        if (rung != nullptr)
+        {
+            rung->count--;
+        }
+    }
+    m_qSize--;
+    Refill();
+}
+
+} // namespace ns3
@@ -0,0 +1,167 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by W. T. Tang, R. S. M. Goh and
+ * I. L.-J. Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * Events are kept in three tiers:
+ *
+ * - \c Top: an unsorted array holding the events far in the future,
+ *   with a timestamp larger than or equal to \c m_topStart;
+ * - \c Ladder: a stack of rungs, each one an array of buckets covering
+ *   a uniform time span.  Events are appended unsorted to their bucket.
+ *   Each rung covers the span of one bucket of the rung above it;
+ * - \c Bottom: a short sorted array holding the earliest events.
+ *
+ * When the Bottom is empty, the first non empty bucket of the lowest rung
+ * is either split into a new, finer, rung if it holds more than
+ * \c THRESHOLD events, or sorted into the Bottom.  When the ladder is
+ * empty, the whole Top becomes the first rung.  Events are therefore
+ * sorted lazily, only when they are about to be dequeued, and there is
+ * never a global resize of the structure as in CalendarScheduler.
+ *
+ * Buckets and rungs are recycled: once allocated they keep their
+ * storage, so that in steady state no memory allocation is needed.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to Top or bucket; Bottom is short
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Last element of the Bottom
+ * Remove()     | ~Constant       | Search within bucket; Linear in Top
+ * RemoveNext() | ~Constant       | Amortized bucket sorting and rung spawning
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                            | Reason
+ * :-------- | :-------------------------------- | :-----
+ * Overhead  | 560 bytes                         | 8 rungs, plus one `std::vector` per bucket
+ * Per Event | 0                                 | Events stored in `std::vector` directly
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  private:
+    /** Bucket type: an unsorted array of events. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /** A rung of the ladder. */
+    struct Rung
+    {
+        uint64_t start;              //!< Timestamp of the start of the first bucket.
+        uint64_t width;              //!< Duration of a bucket, in dimensionless time units.
+        uint32_t current;            //!< Index of the first bucket not yet dequeued.
+        uint32_t nBuckets;           //!< Number of buckets in use.
+        uint32_t count;              //!< Number of events in the rung.
+        std::vector<Bucket> buckets; //!< The buckets, recycled across spawns.
+    };
+
+    /**
+     * Get the timestamp of the first bucket not yet dequeued of a rung.
+     *
+     * \param [in] rung The rung.
+     * \returns The start of the current bucket.
+     */
+    static uint64_t CurrentStart(const Rung& rung);
+    /**
+     * Create a new rung below the lowest one.
+     *
+     * \param [in] events The events to move in the new rung.
+     * \param [in] start The start of the span covered by the new rung.
+     * \param [in] end The end of the span covered by the new rung.
+     */
+    void Spawn(Bucket& events, uint64_t start, uint64_t end);
+    /**
+     * Insert an event in the Bottom, keeping it sorted.
+     *
+     * \param [in] ev The event.
+     */
+    void InsertBottom(const Scheduler::Event& ev);
+    /** Make sure the Bottom holds the earliest event, if any. */
+    void Refill();
+
+    /** Maximum number of events sorted into the Bottom at once. */
+    static const uint32_t THRESHOLD = 50;
+    /** Maximum number of rungs. */
+    static const uint32_t MAX_RUNGS = 8;
+    /** Maximum number of buckets in a rung. */
+    static const uint32_t MAX_BUCKETS = 1 << 20;
+
+    /** Top events, unsorted. */
+    Bucket m_top;
+    /** Smallest timestamp in the Top. */
+    uint64_t m_topMin;
+    /** Largest timestamp in the Top. */
+    uint64_t m_topMax;
+    /** Events with a timestamp larger than or equal to this one go to the Top. */
+    uint64_t m_topStart;
+    /** The rungs; only the first m_nRungs ones are in use. */
+    std::vector<Rung> m_rungs;
+    /** Number of rungs in use. */
+    uint32_t m_nRungs;
+    /** Bottom events, sorted in decreasing order. */
+    Bucket m_bottom;
+    /** Number of events in queue. */
+    uint32_t m_qSize;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -0,0 +1,230 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MpscQueue declaration and template implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup simulator
+ * \brief A multiple producer, single consumer FIFO queue.
+ *
+ * Items are pushed into a bounded ring without taking any lock: each
+ * slot carries a sequence number telling whether it is free, being
+ * written, or ready to be consumed (see D. Vyukov, "Bounded MPMC
+ * queue").  The consumer drains all the ready items at once.
+ *
+ * When the ring is full, producers fall back to a list protected by
+ * a mutex, which the consumer drains after the ring.  While this
+ * overflow list is in use, all the producers append to it, so that the
+ * items pushed by a given thread are always consumed in order.
+ *
+ * The simulator implementations use it to hand over the events
+ * scheduled by threads other than the one running the simulation.
+ *
+ * \tparam T \explicit The type of the items.
+ */
+template <typename T>
+class MpscQueue
+{
+  public:
+    /**
+     * Constructor.
+     * \param [in] capacity The minimum number of items the ring can
+     *             hold; it is rounded up to a power of two.
+     */
+    explicit MpscQueue(std::size_t capacity);
+
+    /**
+     * Add an item to the queue.  This can be called from any thread.
+     * \param [in] item The item.
+     */
+    void Push(const T& item);
+
+    /**
+     * Check whether there are items ready to be consumed.
+     * This must be called from the consumer thread only.
+     * \returns \c true if no item is ready.
+     */
+    bool IsEmpty() const;
+
+    /**
+     * Consume all the items ready.
+     * This must be called from the consumer thread only.
+     *
+     * \tparam F \deduced The type of the function consuming an item.
+     * \param [in] consume The function called for each item.
+     * \returns The number of items consumed.
+     */
+    template <typename F>
+    std::size_t Drain(F consume);
+
+  private:
+    /** A slot of the ring. */
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence; //!< The slot state.
+        T item;                            //!< The item.
+    };
+
+    /**
+     * Try to add an item to the ring.
+     * \param [in] item The item.
+     * \returns \c false if the ring is full.
+     */
+    bool TryPush(const T& item);
+
+    std::vector<Cell> m_ring;                    //!< The ring.
+    std::size_t m_mask;                          //!< Ring size minus one.
+    alignas(64) std::atomic<std::size_t> m_tail; //!< Next slot to write.
+    alignas(64) std::size_t m_head;              //!< Next slot to read.
+    std::atomic<bool> m_overflowing;             //!< Whether m_overflow is in use.
+    std::mutex m_overflowMutex;                  //!< Mutex protecting m_overflow.
+    std::list<T> m_overflow;                     //!< Items which did not fit in the ring.
+};
+
+} // namespace ns3
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3
+{
+
+template <typename T>
+MpscQueue<T>::MpscQueue(std::size_t capacity)
+    : m_tail(0),
+      m_head(0),
+      m_overflowing(false)
+{
+    std::size_t size = 2;
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+    m_ring = std::vector<Cell>(size);
+    m_mask = size - 1;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        m_ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool
+MpscQueue<T>::TryPush(const T& item)
+{
+    std::size_t pos = m_tail.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Cell& cell = m_ring[pos & m_mask];
+        std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell.item = item;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+void
+MpscQueue<T>::Push(const T& item)
+{
+    if (!m_overflowing.load(std::memory_order_acquire) && TryPush(item))
+    {
+        return;
+    }
+    std::unique_lock lock{m_overflowMutex};
+    m_overflow.push_back(item);
+    m_overflowing.store(true, std::memory_order_release);
+}
+
+template <typename T>
+bool
+MpscQueue<T>::IsEmpty() const
+{
+    const Cell& cell = m_ring[m_head & m_mask];
+    return cell.sequence.load(std::memory_order_acquire) != m_head + 1 &&
+           !m_overflowing.load(std::memory_order_acquire);
+}
+
+template <typename T>
+template <typename F>
+std::size_t
+MpscQueue<T>::Drain(F consume)
+{
+    std::size_t count = 0;
+    while (true)
+    {
+        Cell& cell = m_ring[m_head & m_mask];
+        if (cell.sequence.load(std::memory_order_acquire) != m_head + 1)
+        {
+            break;
+        }
+        T item = cell.item;
+        cell.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+        m_head++;
+        consume(item);
+        count++;
+    }
+    if (m_overflowing.load(std::memory_order_acquire))
+    {
+        std::list<T> overflow;
+        {
+            std::unique_lock lock{m_overflowMutex};
+            overflow.swap(m_overflow);
+            m_overflowing.store(false, std::memory_order_release);
+        }
+        for (const auto& item : overflow)
+        {
+            consume(item);
+            count++;
+        }
+    }
+    return count;
+}
+
+} // namespace ns3
+
+#endif /* MPSC_QUEUE_H */
@@ -30,6 +30,7 @@
 #include "synchronizer.h"
 #include "wall-clock-synchronizer.h"
 
+#include <algorithm>
 #include <cmath>
 #include <mutex>
 #include <thread>
@@ -74,6 +75,7 @@ RealtimeSimulatorImpl::GetTypeId()
 }
 
 RealtimeSimulatorImpl::RealtimeSimulatorImpl()
+    : m_eventsWithContext(EVENTS_WITH_CONTEXT_CAPACITY)
 {
     NS_LOG_FUNCTION(this);
 
@@ -102,6 +104,10 @@ void
 RealtimeSimulatorImpl::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    {
+        std::unique_lock lock{m_mutex};
+        ProcessEventsWithContext();
+    }
     while (!m_events->IsEmpty())
     {
         Scheduler::Event next = m_events->RemoveNext();
@@ -217,6 +223,15 @@ RealtimeSimulatorImpl::ProcessOneEvent()
                 m_synchronizer->Realtime(),
                 "RealtimeSimulatorImpl::ProcessOneEvent (): Synchronizer reports not Realtime ()");
 
+            //
+            // Events scheduled from other threads do not take the critical
+            // section: they are queued, and the synchronizer is signaled.  So
+            // we reset the synchronizer before collecting them, to make sure
+            // that any event queued afterwards interrupts the wait below.
+            //
+            m_synchronizer->SetCondition(false);
+            ProcessEventsWithContext();
+
             //
             // tsNow is set to the normalized current real time.  When the simulation was
             // started, the current real time was effectively set to zero; so tsNow is
@@ -249,10 +264,9 @@ RealtimeSimulatorImpl::ProcessOneEvent()
             // We've figured out how long we need to delay in order to pace the
             // simulation time with the real time.  We're going to sleep, but need
             // to work with the synchronizer to make sure we're awakened if something
-            // external happens (like a packet is received).  This next line resets
-            // the synchronizer so that any future event will cause it to interrupt.
+            // external happens (like a packet is received).  The synchronizer was
+            // reset above so that any future event will cause it to interrupt.
             //
-            m_synchronizer->SetCondition(false);
         }
 
         //
@@ -322,6 +336,7 @@ RealtimeSimulatorImpl::ProcessOneEvent()
         // event we're working on won't be on the list and so subsequent operations won't
         // mess with us.
         //
+        ProcessEventsWithContext();
         NS_ASSERT_MSG(m_events->IsEmpty() == false,
                       "RealtimeSimulatorImpl::ProcessOneEvent(): event queue is empty");
         next = m_events->RemoveNext();
@@ -442,6 +457,7 @@ RealtimeSimulatorImpl::Run()
         {
             std::unique_lock lock{m_mutex};
 
+            ProcessEventsWithContext();
             if (!m_events->IsEmpty())
             {
                 process = true;
@@ -542,24 +558,20 @@ RealtimeSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay,
 {
     NS_LOG_FUNCTION(this << context << delay << impl);
 
+    if (m_main != std::this_thread::get_id())
     {
-        std::unique_lock lock{m_mutex};
-        uint64_t ts;
-
-        if (m_main == std::this_thread::get_id())
-        {
-            ts = m_currentTs + delay.GetTimeStep();
-        }
-        else
-        {
-            //
-            // If the simulator is running, we're pacing and have a meaningful
-            // realtime clock.  If we're not, then m_currentTs is where we stopped.
-            //
-            ts = m_running ? m_synchronizer->GetCurrentRealtime() : m_currentTs;
-            ts += delay.GetTimeStep();
-        }
+        //
+        // If the simulator is running, we're pacing and have a meaningful
+        // realtime clock.  If we're not, then m_currentTs is where we stopped.
+        //
+        uint64_t ts = m_running ? m_synchronizer->GetCurrentRealtime() : m_currentTs;
+        ScheduleFromOtherThread(context, ts + delay.GetTimeStep(), impl);
+        return;
+    }
 
+    {
+        std::unique_lock lock{m_mutex};
+        uint64_t ts = m_currentTs + delay.GetTimeStep();
         NS_ASSERT_MSG(ts >= m_currentTs,
                       "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
         Scheduler::Event ev;
@@ -574,6 +586,42 @@ RealtimeSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay,
     }
 }
 
+void
+RealtimeSimulatorImpl::ScheduleFromOtherThread(uint32_t context, uint64_t ts, EventImpl* impl)
+{
+    NS_LOG_FUNCTION(this << context << ts << impl);
+    EventWithContext ev;
+    ev.context = context;
+    ev.timestamp = ts;
+    ev.event = impl;
+    m_eventsWithContext.Push(ev);
+    m_synchronizer->Signal();
+}
+
+void
+RealtimeSimulatorImpl::ProcessEventsWithContext()
+{
+    if (m_eventsWithContext.IsEmpty())
+    {
+        return;
+    }
+
+    m_eventsWithContext.Drain([this](const EventWithContext& event) {
+        //
+        // The realtime clock was read by the other thread, which may have been
+        // preempted while we executed later events: never go back in time.
+        //
+        Scheduler::Event ev;
+        ev.impl = event.event;
+        ev.key.m_ts = std::max(event.timestamp, m_currentTs);
+        ev.key.m_context = event.context;
+        ev.key.m_uid = m_uid;
+        m_uid++;
+        m_unscheduledEvents++;
+        m_events->Insert(ev);
+    });
+}
+
 EventId
 RealtimeSimulatorImpl::ScheduleNow(EventImpl* impl)
 {
@@ -597,6 +645,13 @@ RealtimeSimulatorImpl::ScheduleRealtimeWithContext(uint32_t context,
 {
     NS_LOG_FUNCTION(this << context << time << impl);
 
+    if (m_main != std::this_thread::get_id())
+    {
+        uint64_t ts = m_synchronizer->GetCurrentRealtime() + time.GetTimeStep();
+        ScheduleFromOtherThread(context, ts, impl);
+        return;
+    }
+
     {
         std::unique_lock lock{m_mutex};
 
@@ -606,6 +661,7 @@ RealtimeSimulatorImpl::ScheduleRealtimeWithContext(uint32_t context,
         Scheduler::Event ev;
         ev.impl = impl;
         ev.key.m_ts = ts;
+        ev.key.m_context = context;
         ev.key.m_uid = m_uid;
         m_uid++;
         m_unscheduledEvents++;
@@ -625,13 +681,21 @@ void
 RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext(uint32_t context, EventImpl* impl)
 {
     NS_LOG_FUNCTION(this << context << impl);
-    {
-        std::unique_lock lock{m_mutex};
 
+    if (m_main != std::this_thread::get_id())
+    {
         //
         // If the simulator is running, we're pacing and have a meaningful
         // realtime clock.  If we're not, then m_currentTs is were we stopped.
         //
+        uint64_t ts = m_running ? m_synchronizer->GetCurrentRealtime() : m_currentTs;
+        ScheduleFromOtherThread(context, ts, impl);
+        return;
+    }
+
+    {
+        std::unique_lock lock{m_mutex};
+
         uint64_t ts = m_running ? m_synchronizer->GetCurrentRealtime() : m_currentTs;
         NS_ASSERT_MSG(ts >= m_currentTs,
                       "RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext(): schedule for time "
@@ -21,11 +21,13 @@
 #include "assert.h"
 #include "event-impl.h"
 #include "log.h"
+#include "mpsc-queue.h"
 #include "ptr.h"
 #include "scheduler.h"
 #include "simulator-impl.h"
 #include "synchronizer.h"
 
+#include <atomic>
 #include <list>
 #include <mutex>
 #include <thread>
@@ -181,6 +183,19 @@ class RealtimeSimulatorImpl : public SimulatorImpl
     uint64_t NextTs() const;
     /** Process the next event. */
     void ProcessOneEvent();
+    /**
+     * Move the events scheduled from other threads into the event list.
+     * Must be called with #m_mutex locked.
+     */
+    void ProcessEventsWithContext();
+    /**
+     * Hand an event scheduled from another thread over to the main thread.
+     *
+     * \param [in] context The event context.
+     * \param [in] ts The event timestamp.
+     * \param [in] impl The event implementation.
+     */
+    void ScheduleFromOtherThread(uint32_t context, uint64_t ts, EventImpl* impl);
     /** Destructor implementation. */
     void DoDispose() override;
 
@@ -191,7 +206,7 @@ class RealtimeSimulatorImpl : public SimulatorImpl
     /** Has the stopping condition been reached? */
     bool m_stop;
     /** Is the simulator currently running. */
-    bool m_running;
+    std::atomic<bool> m_running;
 
     /**
      * \name Mutex-protected variables.
@@ -218,6 +233,22 @@ class RealtimeSimulatorImpl : public SimulatorImpl
     /** Mutex to control access to key state. */
     mutable std::mutex m_mutex;
 
+    /** An event scheduled from another thread. */
+    struct EventWithContext
+    {
+        /** The event context. */
+        uint32_t context;
+        /** Event timestamp. */
+        uint64_t timestamp;
+        /** The event implementation. */
+        EventImpl* event;
+    };
+
+    /** Number of events scheduled from other threads held without locking. */
+    static const uint32_t EVENTS_WITH_CONTEXT_CAPACITY = 16384;
+    /** The queue of events scheduled from other threads. */
+    MpscQueue<EventWithContext> m_eventsWithContext;
+
     /** The synchronizer in use to track real time. */
     Ptr<Synchronizer> m_synchronizer;
 
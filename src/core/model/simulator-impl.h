@@ -100,6 +100,16 @@ class SimulatorImpl : public Object
     virtual uint32_t GetContext() const = 0;
     /** \copydoc Simulator::GetEventCount */
     virtual uint64_t GetEventCount() const = 0;
+    /**
+     * \copydoc Simulator::GetCancelledEventCount
+     *
+     * Implementations which do not keep track of the cancelled events
+     * return 0.
+     */
+    virtual uint64_t GetCancelledEventCount() const
+    {
+        return 0;
+    }
 
     /**
      * Hook called before processing each event.
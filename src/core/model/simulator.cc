@@ -317,6 +317,18 @@ Simulator::GetEventCount()
     return GetImpl()->GetEventCount();
 }
 
+uint64_t
+Simulator::GetCancelledEventCount()
+{
+    return GetImpl()->GetCancelledEventCount();
+}
+
+EventImpl::AllocationStats
+Simulator::GetEventAllocationStats()
+{
+    return EventImpl::GetAllocationStats();
+}
+
 uint32_t
 Simulator::GetSystemId()
 {
@@ -208,6 +208,26 @@ class Simulator
      */
     static uint64_t GetEventCount();
 
+    /**
+     * Get the number of cancelled events which are still in the event list.
+     *
+     * Simulator::Cancel() only marks an event as cancelled, and the event
+     * stays in the event list until its time is reached; these events
+     * are included in the count returned by GetEventCount() when they
+     * expire.  Simulator::Remove() removes the event from the list.
+     *
+     * \returns The number of cancelled events not yet expired.
+     */
+    static uint64_t GetCancelledEventCount();
+
+    /**
+     * Get the event allocation statistics: number of live events,
+     * bytes reserved by the event arenas, and free list hit rate.
+     * \returns The event allocation statistics.
+     * \see EventImpl::GetAllocationStats()
+     */
+    static EventImpl::AllocationStats GetEventAllocationStats();
+
     /**
      * @name Schedule events (in the same context) to run at a future time.
      */
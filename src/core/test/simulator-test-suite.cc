@@ -16,14 +16,21 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include "ns3/boolean.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/indexed-heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/simulator-impl.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 
+#include <array>
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -717,6 +724,180 @@ SimulatorTemplateTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the recycling of events by the event arena.
+ */
+class SimulatorEventArenaTestCase : public TestCase
+{
+  public:
+    SimulatorEventArenaTestCase();
+
+  private:
+    void DoRun() override;
+    /**
+     * Reschedule itself, with a closure in a larger size class.
+     * \param n The number of events left.
+     * \param payload An argument making the event larger than the small ones.
+     */
+    void Large(uint32_t n, std::array<uint64_t, 8> payload);
+    /**
+     * Reschedule itself, and schedule a lambda.
+     * \param n The number of events left.
+     */
+    void Small(uint32_t n);
+};
+
+SimulatorEventArenaTestCase::SimulatorEventArenaTestCase()
+    : TestCase("Check that events are recycled by the event arena")
+{
+}
+
+void
+SimulatorEventArenaTestCase::Large(uint32_t n, std::array<uint64_t, 8> payload)
+{
+    if (n > 0)
+    {
+        Simulator::Schedule(NanoSeconds(1),
+                            &SimulatorEventArenaTestCase::Large,
+                            this,
+                            n - 1,
+                            payload);
+    }
+}
+
+void
+SimulatorEventArenaTestCase::Small(uint32_t n)
+{
+    if (n > 0)
+    {
+        Simulator::Schedule(NanoSeconds(1), &SimulatorEventArenaTestCase::Small, this, n - 1);
+    }
+    Simulator::Schedule(NanoSeconds(1), []() {});
+}
+
+void
+SimulatorEventArenaTestCase::DoRun()
+{
+    Simulator::Schedule(Seconds(0), &SimulatorEventArenaTestCase::Small, this, 100);
+    Simulator::Schedule(Seconds(0),
+                        &SimulatorEventArenaTestCase::Large,
+                        this,
+                        100,
+                        std::array<uint64_t, 8>{});
+    Simulator::Run();
+    EventImpl::AllocationStats before = Simulator::GetEventAllocationStats();
+
+    Simulator::Schedule(Seconds(0), &SimulatorEventArenaTestCase::Small, this, 100);
+    Simulator::Schedule(Seconds(0),
+                        &SimulatorEventArenaTestCase::Large,
+                        this,
+                        100,
+                        std::array<uint64_t, 8>{});
+    Simulator::Run();
+    EventImpl::AllocationStats after = Simulator::GetEventAllocationStats();
+
+    NS_TEST_EXPECT_MSG_EQ(after.liveEvents, before.liveEvents, "All the events were released");
+    NS_TEST_EXPECT_MSG_EQ(after.arenaBytes, before.arenaBytes, "Events should be recycled");
+    NS_TEST_EXPECT_MSG_EQ(after.allocations - before.allocations,
+                          303,
+                          "Unexpected allocation count");
+    NS_TEST_EXPECT_MSG_EQ(after.hits - before.hits, 303, "Events should be recycled");
+    NS_TEST_EXPECT_MSG_GT(after.GetHitRate(), 0, "Events should be recycled");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the count of cancelled events, and their purge.
+ */
+class SimulatorCancelledEventsTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param purge Whether to purge cancelled events.
+     */
+    SimulatorCancelledEventsTestCase(bool purge);
+
+  private:
+    void DoRun() override;
+    /** Event which should never run. */
+    void Cancelled();
+    /** Check the count of cancelled events. */
+    void Check();
+
+    bool m_purge;   //!< Whether to purge cancelled events.
+    bool m_ran;     //!< Whether a cancelled event ran.
+    bool m_checked; //!< Whether Check() ran.
+};
+
+SimulatorCancelledEventsTestCase::SimulatorCancelledEventsTestCase(bool purge)
+    : TestCase(std::string("Check cancelled events, ") + (purge ? "purged" : "not purged")),
+      m_purge(purge),
+      m_ran(false),
+      m_checked(false)
+{
+}
+
+void
+SimulatorCancelledEventsTestCase::Cancelled()
+{
+    m_ran = true;
+}
+
+void
+SimulatorCancelledEventsTestCase::Check()
+{
+    m_checked = true;
+    NS_TEST_EXPECT_MSG_EQ(Simulator::GetCancelledEventCount(),
+                          (m_purge ? 0 : 5),
+                          "Unexpected number of cancelled events");
+}
+
+void
+SimulatorCancelledEventsTestCase::DoRun()
+{
+    ObjectFactory factory("ns3::DefaultSimulatorImpl");
+    factory.Set("PurgeCancelledEvents", BooleanValue(m_purge));
+    Simulator::SetImplementation(factory.Create<SimulatorImpl>());
+    Simulator::SetScheduler(ObjectFactory("ns3::IndexedHeapScheduler"));
+
+    std::vector<EventId> events;
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        events.push_back(Simulator::Schedule(Seconds(i + 2),
+                                             &SimulatorCancelledEventsTestCase::Cancelled,
+                                             this));
+    }
+    Simulator::Schedule(Seconds(1), &SimulatorCancelledEventsTestCase::Check, this);
+    for (uint32_t i = 0; i < 10; i += 2)
+    {
+        events[i].Cancel();
+        events[i].Cancel();
+        Simulator::Remove(events[i + 1]);
+    }
+    EventId destroy =
+        Simulator::ScheduleDestroy(&SimulatorCancelledEventsTestCase::Cancelled, this);
+    Simulator::Cancel(destroy);
+    NS_TEST_EXPECT_MSG_EQ(Simulator::GetCancelledEventCount(),
+                          (m_purge ? 0 : 5),
+                          "Unexpected number of cancelled events");
+
+    uint64_t count = Simulator::GetEventCount();
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(m_checked, true, "Check() should have run");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::GetCancelledEventCount(), 0, "Cancelled events expired");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::GetEventCount() - count,
+                          (m_purge ? 1 : 6),
+                          "Cancelled events are counted when they expire");
+    Simulator::Destroy();
+    NS_TEST_EXPECT_MSG_EQ(m_ran, false, "Cancelled events should not run");
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -740,6 +921,13 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(IndexedHeapScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        AddTestCase(new SimulatorEventArenaTestCase(), TestCase::QUICK);
+        AddTestCase(new SimulatorCancelledEventsTestCase(false), TestCase::QUICK);
+        AddTestCase(new SimulatorCancelledEventsTestCase(true), TestCase::QUICK);
     }
 };
 
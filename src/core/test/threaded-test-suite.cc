@@ -21,6 +21,7 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/map-scheduler.h"
+#include "ns3/mpsc-queue.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
@@ -30,6 +31,7 @@
 #include <list>
 #include <thread> // sleep_for
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -278,6 +280,74 @@ ThreadedSimulatorEventsTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * \ingroup threaded-tests
+ *
+ * \brief Check that MpscQueue keeps the items of each producer in order,
+ * including when the ring overflows.
+ */
+class MpscQueueTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param capacity The capacity of the ring.
+     * \param producers The number of producer threads.
+     */
+    MpscQueueTestCase(std::size_t capacity, unsigned int producers);
+
+  private:
+    void DoRun() override;
+
+    std::size_t m_capacity;   //!< The capacity of the ring.
+    unsigned int m_producers; //!< The number of producer threads.
+};
+
+MpscQueueTestCase::MpscQueueTestCase(std::size_t capacity, unsigned int producers)
+    : TestCase("Check MpscQueue with capacity " + std::to_string(capacity) + " and " +
+               std::to_string(producers) + " producers"),
+      m_capacity(capacity),
+      m_producers(producers)
+{
+}
+
+void
+MpscQueueTestCase::DoRun()
+{
+    const uint32_t items = 20000;
+    MpscQueue<std::pair<unsigned int, uint32_t>> queue(m_capacity);
+    std::vector<uint32_t> next(m_producers, 0);
+    bool ordered = true;
+    uint32_t consumed = 0;
+    auto consume = [&next, &ordered](const std::pair<unsigned int, uint32_t>& item) {
+        ordered = ordered && item.second == next[item.first];
+        next[item.first] = item.second + 1;
+    };
+
+    std::list<std::thread> threads;
+    for (unsigned int i = 0; i < m_producers; ++i)
+    {
+        threads.emplace_back([&queue, i]() {
+            for (uint32_t j = 0; j < items; ++j)
+            {
+                queue.Push(std::make_pair(i, j));
+            }
+        });
+    }
+    while (consumed < items * m_producers)
+    {
+        consumed += queue.Drain(consume);
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    NS_TEST_EXPECT_MSG_EQ(queue.IsEmpty(), true, "All the items should have been consumed");
+    NS_TEST_EXPECT_MSG_EQ(consumed, items * m_producers, "Unexpected number of items");
+    NS_TEST_EXPECT_MSG_EQ(ordered, true, "Items of a producer were reordered");
+}
+
 /**
  * \ingroup threaded-tests
  *
@@ -315,6 +385,8 @@ class ThreadedSimulatorTestSuite : public TestSuite
                 }
             }
         }
+        AddTestCase(new MpscQueueTestCase(1024, 4), TestCase::QUICK);
+        AddTestCase(new MpscQueueTestCase(4, 4), TestCase::QUICK);
     }
 };
 
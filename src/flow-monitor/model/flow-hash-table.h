@@ -0,0 +1,326 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_HASH_TABLE_H
+#define FLOW_HASH_TABLE_H
+
+#include <functional>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup flow-monitor
+ * ns3::FlowHashTable declaration and template implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup flow-monitor
+ * \brief An open addressing hash table, used to look up flows and
+ * tracked packets.
+ *
+ * The entries are stored contiguously in a power of two sized array,
+ * which is doubled when it becomes half full.  Collisions are resolved
+ * by linear probing from the slot selected by the upper bits of the
+ * hash multiplied by a large odd constant, so that hash functions which
+ * return the key itself, like std::hash for integers, spread keys
+ * differing only in their upper bits.  Erasing an entry moves the
+ * following entries of its cluster back, so that no tombstone is left
+ * behind and lookups never slow down as entries come and go.
+ *
+ * The pointers returned by Find() and Insert() are invalidated by the
+ * next call to Insert(), Erase(), EraseIf() or Clear().
+ *
+ * \tparam K \explicit The key type, which must be copyable and equality comparable.
+ * \tparam V \explicit The value type, which must be default constructible.
+ * \tparam H \explicit The function object type hashing the keys.
+ */
+template <typename K, typename V, typename H = std::hash<K>>
+class FlowHashTable
+{
+  public:
+    /** Constructor. */
+    FlowHashTable();
+
+    /**
+     * Find the value of a key.
+     * \param [in] key The key.
+     * \returns The value, or nullptr if \pname{key} is not in the table.
+     */
+    V* Find(const K& key);
+    /**
+     * Find the value of a key.
+     * \param [in] key The key.
+     * \returns The value, or nullptr if \pname{key} is not in the table.
+     */
+    const V* Find(const K& key) const;
+    /**
+     * Insert a key with a default constructed value, unless it is
+     * already in the table.
+     * \param [in] key The key.
+     * \returns The value of \pname{key}, and whether it was inserted.
+     */
+    std::pair<V*, bool> Insert(const K& key);
+    /**
+     * Erase a key.
+     * \param [in] key The key.
+     * \returns \c true if \pname{key} was in the table.
+     */
+    bool Erase(const K& key);
+    /**
+     * Erase all the entries matching a predicate.
+     *
+     * An entry may be presented twice to \pname{pred} when a cluster
+     * wraps around the end of the array, so \pname{pred} must return
+     * the same answer for the same entry.
+     *
+     * \param [in] pred The predicate, called as pred(key, value).
+     */
+    template <typename F>
+    void EraseIf(F pred);
+    /**
+     * Call a function for each entry, in no particular order.
+     * \param [in] f The function, called as f(key, value).
+     */
+    template <typename F>
+    void ForEach(F f) const;
+    /**
+     * Get the number of entries.
+     * \returns The number of entries.
+     */
+    std::size_t GetSize() const;
+    /** Erase all the entries. */
+    void Clear();
+
+  private:
+    /** An entry of the table. */
+    struct Entry
+    {
+        K key;     //!< The key.
+        V value;   //!< The value.
+        bool used; //!< Whether this slot holds an entry.
+    };
+
+    /**
+     * Get the home slot of a key.
+     * \param [in] key The key.
+     * \returns The index of the slot where the probing for \pname{key} starts.
+     */
+    std::size_t GetHome(const K& key) const;
+    /**
+     * Find the slot of a key.
+     * \param [in] key The key.
+     * \returns The index of the slot of \pname{key}, or of the free
+     *          slot ending its probe sequence.
+     */
+    std::size_t FindSlot(const K& key) const;
+    /**
+     * Erase the entry of a slot, and move back the following entries
+     * of its cluster.
+     * \param [in] i The index of the slot.
+     */
+    void EraseAt(std::size_t i);
+    /** Double the number of slots, and insert all the entries again. */
+    void Grow();
+
+    std::vector<Entry> m_entries; //!< The slots.
+    std::size_t m_size;           //!< The number of entries.
+    uint32_t m_shift;             //!< 64 minus the log2 of the number of slots.
+    H m_hash;                     //!< The hash function.
+};
+
+/*************************************************
+ **  Template implementation
+ ************************************************/
+
+template <typename K, typename V, typename H>
+FlowHashTable<K, V, H>::FlowHashTable()
+    : m_entries(16),
+      m_size(0),
+      m_shift(64 - 4)
+{
+}
+
+template <typename K, typename V, typename H>
+std::size_t
+FlowHashTable<K, V, H>::GetHome(const K& key) const
+{
+    // Fibonacci hashing: keep the upper bits of the product
+    uint64_t h = static_cast<uint64_t>(m_hash(key));
+    return (h * 0x9e3779b97f4a7c15ULL) >> m_shift;
+}
+
+template <typename K, typename V, typename H>
+std::size_t
+FlowHashTable<K, V, H>::FindSlot(const K& key) const
+{
+    std::size_t mask = m_entries.size() - 1;
+    std::size_t i = GetHome(key);
+    while (m_entries[i].used && !(m_entries[i].key == key))
+    {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+template <typename K, typename V, typename H>
+V*
+FlowHashTable<K, V, H>::Find(const K& key)
+{
+    Entry& entry = m_entries[FindSlot(key)];
+    return entry.used ? &entry.value : nullptr;
+}
+
+template <typename K, typename V, typename H>
+const V*
+FlowHashTable<K, V, H>::Find(const K& key) const
+{
+    const Entry& entry = m_entries[FindSlot(key)];
+    return entry.used ? &entry.value : nullptr;
+}
+
+template <typename K, typename V, typename H>
+std::pair<V*, bool>
+FlowHashTable<K, V, H>::Insert(const K& key)
+{
+    std::size_t i = FindSlot(key);
+    if (m_entries[i].used)
+    {
+        return std::make_pair(&m_entries[i].value, false);
+    }
+    if (2 * (m_size + 1) > m_entries.size())
+    {
+        Grow();
+        i = FindSlot(key);
+    }
+    Entry& entry = m_entries[i];
+    entry.key = key;
+    entry.value = V();
+    entry.used = true;
+    m_size++;
+    return std::make_pair(&entry.value, true);
+}
+
+template <typename K, typename V, typename H>
+bool
+FlowHashTable<K, V, H>::Erase(const K& key)
+{
+    std::size_t i = FindSlot(key);
+    if (!m_entries[i].used)
+    {
+        return false;
+    }
+    EraseAt(i);
+    return true;
+}
+
+template <typename K, typename V, typename H>
+template <typename F>
+void
+FlowHashTable<K, V, H>::EraseIf(F pred)
+{
+    std::size_t i = 0;
+    while (i < m_entries.size())
+    {
+        Entry& entry = m_entries[i];
+        if (entry.used && pred(entry.key, entry.value))
+        {
+            // EraseAt moves the next entry of the cluster, if any, in slot i
+            EraseAt(i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+template <typename K, typename V, typename H>
+template <typename F>
+void
+FlowHashTable<K, V, H>::ForEach(F f) const
+{
+    for (const Entry& entry : m_entries)
+    {
+        if (entry.used)
+        {
+            f(entry.key, entry.value);
+        }
+    }
+}
+
+template <typename K, typename V, typename H>
+std::size_t
+FlowHashTable<K, V, H>::GetSize() const
+{
+    return m_size;
+}
+
+template <typename K, typename V, typename H>
+void
+FlowHashTable<K, V, H>::Clear()
+{
+    m_entries.assign(16, Entry());
+    m_size = 0;
+    m_shift = 64 - 4;
+}
+
+template <typename K, typename V, typename H>
+void
+FlowHashTable<K, V, H>::EraseAt(std::size_t i)
+{
+    std::size_t mask = m_entries.size() - 1;
+    std::size_t hole = i;
+    std::size_t j = (hole + 1) & mask;
+    while (m_entries[j].used)
+    {
+        // The entry of slot j can fill the hole if its home slot is not
+        // cyclically in (hole, j]
+        std::size_t home = GetHome(m_entries[j].key);
+        if (((j - home) & mask) >= ((j - hole) & mask))
+        {
+            m_entries[hole] = std::move(m_entries[j]);
+            hole = j;
+        }
+        j = (j + 1) & mask;
+    }
+    m_entries[hole].used = false;
+    m_entries[hole].value = V();
+    m_size--;
+}
+
+template <typename K, typename V, typename H>
+void
+FlowHashTable<K, V, H>::Grow()
+{
+    std::vector<Entry> old(2 * m_entries.size());
+    old.swap(m_entries);
+    m_shift--;
+    for (Entry& entry : old)
+    {
+        if (entry.used)
+        {
+            m_entries[FindSlot(entry.key)] = std::move(entry);
+        }
+    }
+}
+
+} // namespace ns3
+
+#endif /* FLOW_HASH_TABLE_H */
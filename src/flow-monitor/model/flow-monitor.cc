@@ -22,6 +22,7 @@
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <fstream>
 #include <sstream>
@@ -35,6 +36,18 @@ NS_LOG_COMPONENT_DEFINE("FlowMonitor");
 
 NS_OBJECT_ENSURE_REGISTERED(FlowMonitor);
 
+/**
+ * Get the key of a tracked packet.
+ * \param flowId the flow identification
+ * \param packetId the packet identification
+ * \returns the key of the packet in the tracked packets table
+ */
+static inline uint64_t
+GetTrackedPacketKey(FlowId flowId, FlowPacketId packetId)
+{
+    return (static_cast<uint64_t>(flowId) << 32) | packetId;
+}
+
 TypeId
 FlowMonitor::GetTypeId()
 {
@@ -80,7 +93,15 @@ FlowMonitor::GetTypeId()
                 ("The minimum inter-arrival time that is considered a flow interruption."),
                 TimeValue(Seconds(0.5)),
                 MakeTimeAccessor(&FlowMonitor::m_flowInterruptionsMinTime),
-                MakeTimeChecker());
+                MakeTimeChecker())
+            .AddAttribute("SamplingInterval",
+                          "Track only 1 in N packets of each flow (and the packet preceding "
+                          "it, to measure the jitter), and estimate the delay, jitter, "
+                          "forwarding and loss statistics from these samples.  "
+                          "1 tracks all the packets.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&FlowMonitor::m_samplingInterval),
+                          MakeUintegerChecker<uint32_t>(1));
     return tid;
 }
 
@@ -91,7 +112,8 @@ FlowMonitor::GetInstanceTypeId() const
 }
 
 FlowMonitor::FlowMonitor()
-    : m_enabled(false)
+    : m_samplingInterval(1),
+      m_enabled(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -116,15 +138,16 @@ FlowMonitor::DoDispose()
     Object::DoDispose();
 }
 
-inline FlowMonitor::FlowStats&
-FlowMonitor::GetStatsForFlow(FlowId flowId)
+inline FlowMonitor::FlowRecord&
+FlowMonitor::GetRecordForFlow(FlowId flowId)
 {
     NS_LOG_FUNCTION(this);
-    FlowStatsContainerI iter;
-    iter = m_flowStats.find(flowId);
-    if (iter == m_flowStats.end())
+    std::pair<FlowRecord*, bool> record = m_flowRecords.Insert(flowId);
+    if (record.second)
     {
         FlowMonitor::FlowStats& ref = m_flowStats[flowId];
+        record.first->stats = &ref;
+        record.first->lastRxPacketId = 0;
         ref.delaySum = Seconds(0);
         ref.jitterSum = Seconds(0);
         ref.lastDelay = Seconds(0);
@@ -138,12 +161,31 @@ FlowMonitor::GetStatsForFlow(FlowId flowId)
         ref.jitterHistogram.SetDefaultBinWidth(m_jitterBinWidth);
         ref.packetSizeHistogram.SetDefaultBinWidth(m_packetSizeBinWidth);
         ref.flowInterruptionsHistogram.SetDefaultBinWidth(m_flowInterruptionsBinWidth);
-        return ref;
     }
-    else
+    return *record.first;
+}
+
+inline FlowMonitor::FlowStats&
+FlowMonitor::GetStatsForFlow(FlowId flowId)
+{
+    return *GetRecordForFlow(flowId).stats;
+}
+
+inline bool
+FlowMonitor::IsTracked(FlowPacketId packetId) const
+{
+    if (m_samplingInterval == 1)
     {
-        return iter->second;
+        return true;
     }
+    uint32_t phase = packetId % m_samplingInterval;
+    return phase == 0 || phase == m_samplingInterval - 1;
+}
+
+inline bool
+FlowMonitor::IsSample(FlowPacketId packetId) const
+{
+    return packetId % m_samplingInterval == 0;
 }
 
 void
@@ -159,12 +201,16 @@ FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
         return;
     }
     Time now = Simulator::Now();
-    TrackedPacket& tracked = m_trackedPackets[std::make_pair(flowId, packetId)];
-    tracked.firstSeenTime = now;
-    tracked.lastSeenTime = tracked.firstSeenTime;
-    tracked.timesForwarded = 0;
-    NS_LOG_DEBUG("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId="
-                                                                 << packetId << ").");
+    if (IsTracked(packetId))
+    {
+        TrackedPacket& tracked =
+            *m_trackedPackets.Insert(GetTrackedPacketKey(flowId, packetId)).first;
+        tracked.firstSeenTime = now;
+        tracked.lastSeenTime = tracked.firstSeenTime;
+        tracked.timesForwarded = 0;
+        NS_LOG_DEBUG("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId="
+                                                                     << packetId << ").");
+    }
 
     probe->AddPacketStats(flowId, packetSize, Seconds(0));
 
@@ -190,20 +236,31 @@ FlowMonitor::ReportForwarding(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    std::pair<FlowId, FlowPacketId> key(flowId, packetId);
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(key);
-    if (tracked == m_trackedPackets.end())
+    if (!IsSample(packetId))
+    {
+        // the delay of this packet is accounted for by the samples
+        probe->AddPacketStats(flowId, packetSize, Seconds(0));
+        if (!IsTracked(packetId))
+        {
+            return;
+        }
+    }
+    TrackedPacket* tracked = m_trackedPackets.Find(GetTrackedPacketKey(flowId, packetId));
+    if (tracked == nullptr)
     {
         NS_LOG_WARN("Received packet forward report (flowId="
                     << flowId << ", packetId=" << packetId << ") but not known to be transmitted.");
         return;
     }
 
-    tracked->second.timesForwarded++;
-    tracked->second.lastSeenTime = Simulator::Now();
+    tracked->timesForwarded++;
+    tracked->lastSeenTime = Simulator::Now();
 
-    Time delay = (Simulator::Now() - tracked->second.firstSeenTime);
-    probe->AddPacketStats(flowId, packetSize, delay);
+    if (IsSample(packetId))
+    {
+        Time delay = (Simulator::Now() - tracked->firstSeenTime);
+        probe->AddPacketStats(flowId, packetSize, delay * m_samplingInterval);
+    }
 }
 
 void
@@ -218,36 +275,64 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
-    if (tracked == m_trackedPackets.end())
+    uint64_t key = GetTrackedPacketKey(flowId, packetId);
+    TrackedPacket* tracked = nullptr;
+    if (IsTracked(packetId))
     {
-        NS_LOG_WARN("Received packet last-tx report (flowId="
-                    << flowId << ", packetId=" << packetId << ") but not known to be transmitted.");
-        return;
+        tracked = m_trackedPackets.Find(key);
+        if (tracked == nullptr)
+        {
+            NS_LOG_WARN("Received packet last-tx report (flowId="
+                        << flowId << ", packetId=" << packetId
+                        << ") but not known to be transmitted.");
+            return;
+        }
     }
 
     Time now = Simulator::Now();
-    Time delay = (now - tracked->second.firstSeenTime);
-    probe->AddPacketStats(flowId, packetSize, delay);
-
-    FlowStats& stats = GetStatsForFlow(flowId);
-    stats.delaySum += delay;
-    stats.delayHistogram.AddValue(delay.GetSeconds());
-    if (stats.rxPackets > 0)
+    FlowRecord& record = GetRecordForFlow(flowId);
+    FlowStats& stats = *record.stats;
+    if (tracked != nullptr && IsSample(packetId))
     {
-        Time jitter = stats.lastDelay - delay;
-        if (jitter > Seconds(0))
+        Time delay = (now - tracked->firstSeenTime);
+        probe->AddPacketStats(flowId, packetSize, delay * m_samplingInterval);
+
+        stats.delaySum += delay * m_samplingInterval;
+        stats.delayHistogram.AddValue(delay.GetSeconds());
+        // When sampling, only the preceding packet gives a jitter sample
+        bool hasJitter = (m_samplingInterval == 1)
+                             ? stats.rxPackets > 0
+                             : packetId > 0 && record.lastRxPacketId == packetId - 1;
+        if (hasJitter)
         {
-            stats.jitterSum += jitter;
-            stats.jitterHistogram.AddValue(jitter.GetSeconds());
+            Time jitter = stats.lastDelay - delay;
+            if (jitter > Seconds(0))
+            {
+                stats.jitterSum += jitter * m_samplingInterval;
+                stats.jitterHistogram.AddValue(jitter.GetSeconds());
+            }
+            else
+            {
+                stats.jitterSum -= jitter * m_samplingInterval;
+                stats.jitterHistogram.AddValue(-jitter.GetSeconds());
+            }
         }
-        else
+        stats.lastDelay = delay;
+        stats.timesForwarded += tracked->timesForwarded * m_samplingInterval;
+    }
+    else
+    {
+        // the delay of this packet is accounted for by the samples
+        probe->AddPacketStats(flowId, packetSize, Seconds(0));
+        if (tracked != nullptr)
         {
-            stats.jitterSum -= jitter;
-            stats.jitterHistogram.AddValue(-jitter.GetSeconds());
+            stats.lastDelay = now - tracked->firstSeenTime;
         }
     }
-    stats.lastDelay = delay;
+    if (tracked != nullptr)
+    {
+        record.lastRxPacketId = packetId;
+    }
 
     stats.rxBytes += packetSize;
     stats.packetSizeHistogram.AddValue((double)packetSize);
@@ -266,12 +351,14 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         }
     }
     stats.timeLastRxPacket = now;
-    stats.timesForwarded += tracked->second.timesForwarded;
 
-    NS_LOG_DEBUG("ReportLastTx: removing tracked packet (flowId=" << flowId << ", packetId="
-                                                                  << packetId << ").");
+    if (tracked != nullptr)
+    {
+        NS_LOG_DEBUG("ReportLastTx: removing tracked packet (flowId=" << flowId << ", packetId="
+                                                                      << packetId << ").");
 
-    m_trackedPackets.erase(tracked); // we don't need to track this packet anymore
+        m_trackedPackets.Erase(key); // we don't need to track this packet anymore
+    }
 }
 
 void
@@ -302,14 +389,12 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
     NS_LOG_DEBUG("++stats.packetsDropped["
                  << reasonCode << "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
-    if (tracked != m_trackedPackets.end())
+    if (m_trackedPackets.Erase(GetTrackedPacketKey(flowId, packetId)))
     {
         // we don't need to track this packet anymore
         // FIXME: this will not necessarily be true with broadcast/multicast
-        NS_LOG_DEBUG("ReportDrop: removing tracked packet (flowId=" << flowId << ", packetId="
-                                                                    << packetId << ").");
-        m_trackedPackets.erase(tracked);
+        NS_LOG_DEBUG("ReportDrop: removed tracked packet (flowId=" << flowId << ", packetId="
+                                                                   << packetId << ").");
     }
 }
 
@@ -325,24 +410,23 @@ FlowMonitor::CheckForLostPackets(Time maxDelay)
     NS_LOG_FUNCTION(this << maxDelay.As(Time::S));
     Time now = Simulator::Now();
 
-    for (TrackedPacketMap::iterator iter = m_trackedPackets.begin();
-         iter != m_trackedPackets.end();)
-    {
-        if (now - iter->second.lastSeenTime >= maxDelay)
+    m_trackedPackets.EraseIf([this, now, maxDelay](uint64_t key, TrackedPacket& tracked) {
+        if (now - tracked.lastSeenTime < maxDelay)
         {
-            // packet is considered lost, add it to the loss statistics
-            FlowStatsContainerI flow = m_flowStats.find(iter->first.first);
-            NS_ASSERT(flow != m_flowStats.end());
-            flow->second.lostPackets++;
-
-            // we won't track it anymore
-            m_trackedPackets.erase(iter++);
+            return false;
         }
-        else
+        // packet is considered lost, add it to the loss statistics
+        // (a packet preceding a sample is only tracked for the jitter)
+        FlowRecord* flow = m_flowRecords.Find(key >> 32);
+        NS_ASSERT(flow != nullptr);
+        if (IsSample(key & 0xffffffff))
         {
-            iter++;
+            flow->stats->lostPackets += m_samplingInterval;
         }
-    }
+
+        // we won't track it anymore
+        return true;
+    });
 }
 
 void
@@ -22,6 +22,7 @@
 
 #include "ns3/event-id.h"
 #include "ns3/flow-classifier.h"
+#include "ns3/flow-hash-table.h"
 #include "ns3/flow-probe.h"
 #include "ns3/histogram.h"
 #include "ns3/nstime.h"
@@ -46,6 +47,22 @@ namespace ns3
  * The FlowMonitor class is responsible for coordinating efforts
  * regarding probes, and collects end-to-end flow statistics.
  *
+ * The flows and the packets in transit are looked up in open addressing
+ * hash tables, so that the cost of a report does not grow with the
+ * number of flows.
+ *
+ * With the SamplingInterval attribute set to N > 1, only the packets
+ * whose FlowPacketId is a multiple of N, and the packets preceding them,
+ * are tracked from probe to probe.  The packet and byte counters, the
+ * drops and the packet size histogram still account for every packet.
+ * The delay and jitter sums, the per-probe delays, the number of times
+ * forwarded and the packets found lost by CheckForLostPackets() are
+ * estimated from the tracked packets: each sample counts for N packets,
+ * so that these sums remain unbiased estimates of the sums over all the
+ * packets.  A jitter sample is only taken between a tracked packet and
+ * the packet preceding it, so that it measures the delay variation
+ * between consecutive packets.  The delay and jitter histograms hold the
+ * samples only.
  */
 class FlowMonitor : public Object
 {
@@ -73,7 +90,7 @@ class FlowMonitor : public Object
         Time timeLastRxPacket;
 
         /// Contains the sum of all end-to-end delays for all received
-        /// packets of the flow.
+        /// packets of the flow (estimated when packets are sampled).
         Time delaySum; // delayCount == rxPackets
 
         /// Contains the sum of all end-to-end delay jitter (delay
@@ -286,13 +303,23 @@ class FlowMonitor : public Object
         uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
     };
 
+    /// Bookkeeping of a flow, indexed by FlowId
+    struct FlowRecord
+    {
+        FlowStats* stats;            //!< the flow statistics, stored in m_flowStats
+        FlowPacketId lastRxPacketId; //!< identifier of the last tracked packet received
+    };
+
     /// FlowId --> FlowStats
     FlowStatsContainer m_flowStats;
+    /// FlowId --> FlowRecord
+    FlowHashTable<FlowId, FlowRecord> m_flowRecords;
 
     /// (FlowId,PacketId) --> TrackedPacket
-    typedef std::map<std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+    typedef FlowHashTable<uint64_t, TrackedPacket> TrackedPacketMap;
     TrackedPacketMap m_trackedPackets; //!< Tracked packets
     Time m_maxPerHopDelay;             //!< Minimum per-hop delay
+    uint32_t m_samplingInterval;       //!< Track 1 in N packets of each flow
     FlowProbeContainer m_flowProbes;   //!< all the FlowProbes
 
     // note: this is needed only for serialization
@@ -307,11 +334,27 @@ class FlowMonitor : public Object
     double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
     Time m_flowInterruptionsMinTime;    //!< Flow interruptions minimum time
 
+    /// Get the bookkeeping for a given flow, creating its stats if needed
+    /// \param flowId the Flow identification
+    /// \returns the record of the flow
+    FlowRecord& GetRecordForFlow(FlowId flowId);
+
     /// Get the stats for a given flow
     /// \param flowId the Flow identification
     /// \returns the stats of the flow
     FlowStats& GetStatsForFlow(FlowId flowId);
 
+    /// Check whether a packet is tracked from probe to probe
+    /// \param packetId the Packet ID
+    /// \returns true if the packet is tracked
+    bool IsTracked(FlowPacketId packetId) const;
+
+    /// Check whether a tracked packet is a delay sample, rather than
+    /// the predecessor of one, which is only tracked to measure the jitter
+    /// \param packetId the Packet ID
+    /// \returns true if the packet is a delay sample
+    bool IsSample(FlowPacketId packetId) const;
+
     /// Periodic function to check for lost packets and prune statistics
     void PeriodicCheckForLostPackets();
 };
@@ -52,10 +52,21 @@ FlowProbe::DoDispose()
     Object::DoDispose();
 }
 
+FlowProbe::FlowStats&
+FlowProbe::GetStatsForFlow(FlowId flowId)
+{
+    std::pair<FlowStats**, bool> index = m_statsIndex.Insert(flowId);
+    if (index.second)
+    {
+        *index.first = &m_stats[flowId];
+    }
+    return **index.first;
+}
+
 void
 FlowProbe::AddPacketStats(FlowId flowId, uint32_t packetSize, Time delayFromFirstProbe)
 {
-    FlowStats& flow = m_stats[flowId];
+    FlowStats& flow = GetStatsForFlow(flowId);
     flow.delayFromFirstProbeSum += delayFromFirstProbe;
     flow.bytes += packetSize;
     ++flow.packets;
@@ -64,7 +75,7 @@ FlowProbe::AddPacketStats(FlowId flowId, uint32_t packetSize, Time delayFromFirs
 void
 FlowProbe::AddPacketDropStats(FlowId flowId, uint32_t packetSize, uint32_t reasonCode)
 {
-    FlowStats& flow = m_stats[flowId];
+    FlowStats& flow = GetStatsForFlow(flowId);
 
     if (flow.packetsDropped.size() < reasonCode + 1)
     {
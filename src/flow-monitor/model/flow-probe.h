@@ -21,6 +21,7 @@
 #define FLOW_PROBE_H
 
 #include "ns3/flow-classifier.h"
+#include "ns3/flow-hash-table.h"
 #include "ns3/nstime.h"
 #include "ns3/object.h"
 
@@ -107,6 +108,15 @@ class FlowProbe : public Object
   protected:
     Ptr<FlowMonitor> m_flowMonitor; //!< the FlowMonitor instance
     Stats m_stats;                  //!< The flow stats
+
+  private:
+    /// Get the stats of a flow, creating them if needed
+    /// \param flowId the flow Identifier
+    /// \returns the stats of the flow
+    FlowStats& GetStatsForFlow(FlowId flowId);
+
+    /// FlowId --> stats of the flow, stored in m_stats
+    FlowHashTable<FlowId, FlowStats*> m_statsIndex;
 };
 
 } // namespace ns3
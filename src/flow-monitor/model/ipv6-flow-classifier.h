@@ -22,10 +22,12 @@
 #define IPV6_FLOW_CLASSIFIER_H
 
 #include "ns3/flow-classifier.h"
+#include "ns3/flow-hash-table.h"
 #include "ns3/ipv6-header.h"
 
 #include <map>
 #include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
@@ -93,12 +95,27 @@ class Ipv6FlowClassifier : public FlowClassifier
     void SerializeToXmlStream(std::ostream& os, uint16_t indent) const override;
 
   private:
+    /// Hash function object of a FiveTuple
+    struct FiveTupleHash
+    {
+        /// \param t the FiveTuple to hash
+        /// \returns the hash of the FiveTuple
+        std::size_t operator()(const FiveTuple& t) const;
+    };
+
+    /// Record of a flow
+    struct FlowRecord
+    {
+        FiveTuple tuple;           //!< Flow identifiers
+        FlowPacketId lastPacketId; //!< Identifier of the last packet of the flow
+        /// (DSCP value, packet count) pairs
+        std::map<Ipv6Header::DscpType, uint32_t> dscpCounts;
+    };
+
     /// Map to Flows Identifiers to FlowIds
-    std::map<FiveTuple, FlowId> m_flowMap;
-    /// Map to FlowIds to FlowPacketId
-    std::map<FlowId, FlowPacketId> m_flowPktIdMap;
-    /// Map FlowIds to (DSCP value, packet count) pairs
-    std::map<FlowId, std::map<Ipv6Header::DscpType, uint32_t>> m_flowDscpMap;
+    FlowHashTable<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
+    /// Records of the flows, FlowId - 1 --> FlowRecord
+    std::vector<FlowRecord> m_flows;
 };
 
 /**
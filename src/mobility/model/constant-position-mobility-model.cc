@@ -18,6 +18,8 @@
  */
 #include "constant-position-mobility-model.h"
 
+#include "ns3/simulator.h"
+
 namespace ns3
 {
 
@@ -35,6 +37,7 @@ ConstantPositionMobilityModel::GetTypeId()
 
 ConstantPositionMobilityModel::ConstantPositionMobilityModel()
 {
+    EnablePositionStore();
 }
 
 ConstantPositionMobilityModel::~ConstantPositionMobilityModel()
@@ -51,6 +54,7 @@ void
 ConstantPositionMobilityModel::DoSetPosition(const Vector& position)
 {
     m_position = position;
+    GetPositionStore().Set(GetPositionIndex(), position, Vector(0, 0, 0), Simulator::Now());
     NotifyCourseChange();
 }
 
@@ -37,6 +37,7 @@ ConstantVelocityMobilityModel::GetTypeId()
 
 ConstantVelocityMobilityModel::ConstantVelocityMobilityModel()
 {
+    EnablePositionStore();
 }
 
 ConstantVelocityMobilityModel::~ConstantVelocityMobilityModel()
@@ -46,30 +47,32 @@ ConstantVelocityMobilityModel::~ConstantVelocityMobilityModel()
 void
 ConstantVelocityMobilityModel::SetVelocity(const Vector& speed)
 {
-    m_helper.Update();
-    m_helper.SetVelocity(speed);
-    m_helper.Unpause();
+    Time now = Simulator::Now();
+    MobilityPositionStore& store = GetPositionStore();
+    store.Advance(GetPositionIndex(), now);
+    store.Set(GetPositionIndex(), store.GetPosition(GetPositionIndex()), speed, now);
     NotifyCourseChange();
 }
 
 Vector
 ConstantVelocityMobilityModel::DoGetPosition() const
 {
-    m_helper.Update();
-    return m_helper.GetCurrentPosition();
+    MobilityPositionStore& store = GetPositionStore();
+    store.Advance(GetPositionIndex(), Simulator::Now());
+    return store.GetPosition(GetPositionIndex());
 }
 
 void
 ConstantVelocityMobilityModel::DoSetPosition(const Vector& position)
 {
-    m_helper.SetPosition(position);
+    GetPositionStore().Set(GetPositionIndex(), position, Vector(0, 0, 0), Simulator::Now());
     NotifyCourseChange();
 }
 
 Vector
 ConstantVelocityMobilityModel::DoGetVelocity() const
 {
-    return m_helper.GetVelocity();
+    return GetPositionStore().GetVelocity(GetPositionIndex());
 }
 
 } // namespace ns3
@@ -19,7 +19,6 @@
 #ifndef CONSTANT_VELOCITY_MOBILITY_MODEL_H
 #define CONSTANT_VELOCITY_MOBILITY_MODEL_H
 
-#include "constant-velocity-helper.h"
 #include "mobility-model.h"
 
 #include "ns3/nstime.h"
@@ -34,6 +33,8 @@ namespace ns3
  *
  * \brief Mobility model for which the current speed does not change once it has been set and until
  * it is set again explicitly to a new value.
+ *
+ * The position and the velocity are kept in the MobilityPositionStore.
  */
 class ConstantVelocityMobilityModel : public MobilityModel
 {
@@ -62,7 +63,6 @@ class ConstantVelocityMobilityModel : public MobilityModel
     Vector DoGetPosition() const override;
     void DoSetPosition(const Vector& position) override;
     Vector DoGetVelocity() const override;
-    ConstantVelocityHelper m_helper; //!< helper object for this model
 };
 
 } // namespace ns3
@@ -0,0 +1,293 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mobility-grid-index.h"
+
+#include "mobility-model.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MobilityGridIndex");
+
+namespace
+{
+
+/**
+ * Remove an element from an unordered vector.
+ * \param v the vector
+ * \param value the element
+ */
+template <typename T>
+void
+EraseUnordered(std::vector<T>& v, const T& value)
+{
+    auto it = std::find(v.begin(), v.end(), value);
+    NS_ASSERT(it != v.end());
+    *it = v.back();
+    v.pop_back();
+}
+
+/**
+ * \param coordinate a coordinate
+ * \param cellSize the length of the sides of the cells
+ * \returns the index of the cell of the coordinate along its axis
+ */
+int32_t
+GetCellIndex(double coordinate, double cellSize)
+{
+    double index = std::floor(coordinate / cellSize);
+    return static_cast<int32_t>(std::clamp<double>(index, INT32_MIN, INT32_MAX));
+}
+
+/**
+ * \param x the index of a cell along the x axis
+ * \param y the index of a cell along the y axis
+ * \returns the key of the cell
+ */
+uint64_t
+GetCellKey(int32_t x, int32_t y)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+} // namespace
+
+MobilityGridIndex::MobilityGridIndex(double cellSize)
+    : m_cellSize(cellSize)
+{
+    NS_LOG_FUNCTION(this << cellSize);
+    NS_ASSERT_MSG(cellSize > 0 && std::isfinite(cellSize), "Invalid cell size " << cellSize);
+}
+
+MobilityGridIndex::~MobilityGridIndex()
+{
+    NS_LOG_FUNCTION(this);
+    Clear();
+}
+
+void
+MobilityGridIndex::Add(uint32_t id, Ptr<MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << id << mobility);
+    NS_ASSERT_MSG(m_items.find(id) == m_items.end(), "Item " << id << " already in the index");
+    m_items[id] = PeekPointer(mobility);
+    if (!mobility)
+    {
+        m_unlocated.push_back(id);
+        return;
+    }
+    auto [it, inserted] = m_locations.try_emplace(PeekPointer(mobility));
+    if (inserted)
+    {
+        it->second.mobility = mobility;
+        Insert(it->second);
+        mobility->TraceConnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&MobilityGridIndex::CourseChanged, this));
+    }
+    it->second.ids.push_back(id);
+}
+
+void
+MobilityGridIndex::Remove(uint32_t id)
+{
+    NS_LOG_FUNCTION(this << id);
+    auto item = m_items.find(id);
+    if (item == m_items.end())
+    {
+        return;
+    }
+    if (!item->second)
+    {
+        EraseUnordered(m_unlocated, id);
+        m_items.erase(item);
+        return;
+    }
+    auto it = m_locations.find(item->second);
+    NS_ASSERT(it != m_locations.end());
+    m_items.erase(item);
+    EraseUnordered(it->second.ids, id);
+    if (it->second.ids.empty())
+    {
+        Extract(it->second);
+        it->second.mobility->TraceDisconnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&MobilityGridIndex::CourseChanged, this));
+        m_locations.erase(it);
+    }
+}
+
+void
+MobilityGridIndex::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& [model, location] : m_locations)
+    {
+        location.mobility->TraceDisconnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&MobilityGridIndex::CourseChanged, this));
+    }
+    m_locations.clear();
+    m_cells.clear();
+    m_moving.clear();
+    m_movingModels.clear();
+    m_unlocated.clear();
+    m_items.clear();
+}
+
+std::size_t
+MobilityGridIndex::GetN() const
+{
+    return m_items.size();
+}
+
+double
+MobilityGridIndex::GetCellSize() const
+{
+    return m_cellSize;
+}
+
+void
+MobilityGridIndex::GetNeighbors(const Vector& position,
+                                double range,
+                                std::vector<uint32_t>& ids) const
+{
+    NS_LOG_FUNCTION(this << position << range);
+    ids.assign(m_unlocated.begin(), m_unlocated.end());
+
+    MobilityModel::GetDistances(position, m_movingModels, m_distances);
+    for (std::size_t i = 0; i < m_moving.size(); ++i)
+    {
+        if (m_distances[i] <= range)
+        {
+            ids.insert(ids.end(), m_moving[i]->ids.begin(), m_moving[i]->ids.end());
+        }
+    }
+
+    auto addCell = [&ids, &position, range](const std::vector<const Location*>& cell) {
+        for (const Location* location : cell)
+        {
+            if (CalculateDistance(location->position, position) <= range)
+            {
+                ids.insert(ids.end(), location->ids.begin(), location->ids.end());
+            }
+        }
+    };
+
+    // visit the cells overlapping the bounding square of the range, unless
+    // there are fewer non-empty cells than that
+    double nCells = std::numeric_limits<double>::infinity();
+    if (std::isfinite(range))
+    {
+        nCells = (std::floor((position.x + range) / m_cellSize) -
+                  std::floor((position.x - range) / m_cellSize) + 1) *
+                 (std::floor((position.y + range) / m_cellSize) -
+                  std::floor((position.y - range) / m_cellSize) + 1);
+    }
+    if (nCells > m_cells.size())
+    {
+        for (const auto& [key, cell] : m_cells)
+        {
+            addCell(cell);
+        }
+    }
+    else
+    {
+        int32_t xMax = GetCellIndex(position.x + range, m_cellSize);
+        int32_t yMin = GetCellIndex(position.y - range, m_cellSize);
+        int32_t yMax = GetCellIndex(position.y + range, m_cellSize);
+        for (int64_t x = GetCellIndex(position.x - range, m_cellSize); x <= xMax; ++x)
+        {
+            for (int64_t y = yMin; y <= yMax; ++y)
+            {
+                auto cell = m_cells.find(GetCellKey(x, y));
+                if (cell != m_cells.end())
+                {
+                    addCell(cell->second);
+                }
+            }
+        }
+    }
+
+    std::sort(ids.begin(), ids.end());
+}
+
+uint64_t
+MobilityGridIndex::GetCell(const Vector& position) const
+{
+    return GetCellKey(GetCellIndex(position.x, m_cellSize), GetCellIndex(position.y, m_cellSize));
+}
+
+void
+MobilityGridIndex::Insert(Location& location)
+{
+    location.position = location.mobility->GetPosition();
+    location.moving = location.mobility->GetVelocity().GetLength() > 0;
+    if (location.moving)
+    {
+        m_moving.push_back(&location);
+        m_movingModels.push_back(location.mobility);
+    }
+    else
+    {
+        location.cell = GetCell(location.position);
+        m_cells[location.cell].push_back(&location);
+    }
+}
+
+void
+MobilityGridIndex::Extract(const Location& location)
+{
+    if (location.moving)
+    {
+        auto it = std::find(m_moving.begin(), m_moving.end(), &location);
+        NS_ASSERT(it != m_moving.end());
+        std::size_t i = it - m_moving.begin();
+        m_moving[i] = m_moving.back();
+        m_moving.pop_back();
+        m_movingModels[i] = m_movingModels.back();
+        m_movingModels.pop_back();
+        return;
+    }
+    auto cell = m_cells.find(location.cell);
+    NS_ASSERT(cell != m_cells.end());
+    EraseUnordered(cell->second, &location);
+    if (cell->second.empty())
+    {
+        m_cells.erase(cell);
+    }
+}
+
+void
+MobilityGridIndex::CourseChanged(Ptr<const MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << mobility);
+    auto it = m_locations.find(PeekPointer(mobility));
+    if (it != m_locations.end())
+    {
+        Extract(it->second);
+        Insert(it->second);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,152 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_GRID_INDEX_H
+#define MOBILITY_GRID_INDEX_H
+
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/vector.h"
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class MobilityModel;
+
+/**
+ * \ingroup mobility
+ *
+ * \brief Spatial index of items located by a MobilityModel.
+ *
+ * The items are identified by an integer, and are stored in the cells of a
+ * uniform grid on the x-y plane.  The index follows the CourseChange trace
+ * source of the mobility models: the items whose model has a null velocity
+ * are stored in the cell of their position, and the others are checked at
+ * each query, at their current position, which is computed in a batch by
+ * MobilityModel::GetDistances.  Several items may share a
+ * mobility model, and the items without a mobility model are considered to
+ * be everywhere.
+ *
+ * The index assumes that a mobility model with a null velocity does not
+ * move until it notifies a course change, which all the ns-3 models do.
+ */
+class MobilityGridIndex : public SimpleRefCount<MobilityGridIndex>
+{
+  public:
+    /**
+     * \param cellSize the length of the sides of the cells (m), which is best
+     *        set to the typical query range
+     */
+    MobilityGridIndex(double cellSize);
+    ~MobilityGridIndex();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    MobilityGridIndex(const MobilityGridIndex&) = delete;
+    MobilityGridIndex& operator=(const MobilityGridIndex&) = delete;
+
+    /**
+     * Add an item.
+     * \param id the identifier of the item, not already in the index
+     * \param mobility the mobility model of the item, possibly null
+     */
+    void Add(uint32_t id, Ptr<MobilityModel> mobility);
+
+    /**
+     * Remove an item, if it is in the index.
+     * \param id the identifier of the item
+     */
+    void Remove(uint32_t id);
+
+    /**
+     * Remove all the items.
+     */
+    void Clear();
+
+    /**
+     * \returns the number of items in the index
+     */
+    std::size_t GetN() const;
+
+    /**
+     * \returns the length of the sides of the cells (m)
+     */
+    double GetCellSize() const;
+
+    /**
+     * Get the items within a given distance of a position, or without a
+     * mobility model.
+     *
+     * \param position the position
+     * \param range the distance (m), possibly infinite
+     * \param [out] ids the identifiers of the items, in increasing order
+     */
+    void GetNeighbors(const Vector& position, double range, std::vector<uint32_t>& ids) const;
+
+  private:
+    /// The items sharing a mobility model
+    struct Location
+    {
+        Ptr<MobilityModel> mobility; //!< the mobility model
+        std::vector<uint32_t> ids;   //!< the identifiers of the items
+        Vector position;             //!< the position at the last course change
+        bool moving;                 //!< whether the velocity was not null at the last change
+        uint64_t cell;               //!< the cell of the position, if not moving
+    };
+
+    /**
+     * Get the key of the cell of a position.
+     * \param position the position
+     * \returns the key of the cell
+     */
+    uint64_t GetCell(const Vector& position) const;
+
+    /**
+     * Store a location in its cell, or in the list of moving locations.
+     * \param location the location
+     */
+    void Insert(Location& location);
+
+    /**
+     * Remove a location from its cell, or from the list of moving locations.
+     * \param location the location
+     */
+    void Extract(const Location& location);
+
+    /**
+     * Move a location to its new cell. Connected to the CourseChange trace source.
+     * \param mobility the mobility model of the location
+     */
+    void CourseChanged(Ptr<const MobilityModel> mobility);
+
+    double m_cellSize; //!< the length of the sides of the cells
+    /// the locations, by mobility model
+    std::unordered_map<const MobilityModel*, Location> m_locations;
+    /// the locations with a null velocity, by cell
+    std::unordered_map<uint64_t, std::vector<const Location*>> m_cells;
+    std::vector<const Location*> m_moving; //!< the locations with a non-null velocity
+    /// the mobility models of the moving locations, in the same order
+    std::vector<Ptr<MobilityModel>> m_movingModels;
+    mutable std::vector<double> m_distances; //!< the distances of the moving locations
+    std::vector<uint32_t> m_unlocated;     //!< the items without a mobility model
+    /// the mobility models of the items, null for the items without a model
+    std::unordered_map<uint32_t, const MobilityModel*> m_items;
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_GRID_INDEX_H */
@@ -19,6 +19,7 @@
 
 #include "mobility-model.h"
 
+#include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
 
 #include <cmath>
@@ -56,16 +57,25 @@ MobilityModel::GetTypeId()
 }
 
 MobilityModel::MobilityModel()
+    : m_positionIndex(0)
 {
 }
 
 MobilityModel::~MobilityModel()
 {
+    if (m_positionStore)
+    {
+        m_positionStore->Remove(m_positionIndex);
+    }
 }
 
 Vector
 MobilityModel::GetPosition() const
 {
+    if (m_positionStore && m_positionStore->Advance(m_positionIndex, Simulator::Now()))
+    {
+        return m_positionStore->GetPosition(m_positionIndex);
+    }
     return DoGetPosition();
 }
 
@@ -97,15 +107,58 @@ MobilityModel::SetPosition(const Vector& position)
 double
 MobilityModel::GetDistanceFrom(Ptr<const MobilityModel> other) const
 {
-    Vector oPosition = other->DoGetPosition();
-    Vector position = DoGetPosition();
+    Vector oPosition = other->GetPosition();
+    Vector position = GetPosition();
     return CalculateDistance(position, oPosition);
 }
 
-double
-MobilityModel::GetRelativeSpeed(Ptr<const MobilityModel> other) const
+void
+MobilityModel::GetDistancesFrom(const std::vector<Ptr<MobilityModel>>& others,
+                                std::vector<double>& distances) const
+{
+    GetDistances(GetPosition(), others, distances);
+}
+
+void
+MobilityModel::GetDistances(const Vector& position,
+                            const std::vector<Ptr<MobilityModel>>& models,
+                            std::vector<double>& distances)
 {
-    return (GetVelocity() - other->GetVelocity()).GetLength();
+    // batch the models of the first store found, which is normally the only one
+    MobilityPositionStore* store = nullptr;
+    std::vector<uint32_t> indices;
+    for (const auto& model : models)
+    {
+        if (model->m_positionStore && !store)
+        {
+            store = PeekPointer(model->m_positionStore);
+            indices.reserve(models.size());
+        }
+        if (model->m_positionStore && PeekPointer(model->m_positionStore) == store)
+        {
+            indices.push_back(model->m_positionIndex);
+        }
+    }
+    std::vector<double> batched;
+    if (store)
+    {
+        store->GetDistances(position, indices, Simulator::Now(), batched);
+    }
+
+    // the other models, and the entries which are not valid anymore, are
+    // asked for their position
+    distances.resize(models.size());
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < models.size(); ++i)
+    {
+        double distance = -1;
+        if (store && PeekPointer(models[i]->m_positionStore) == store)
+        {
+            distance = batched[j++];
+        }
+        distances[i] =
+            distance >= 0 ? distance : CalculateDistance(position, models[i]->GetPosition());
+    }
 }
 
 void
@@ -114,6 +167,27 @@ MobilityModel::NotifyCourseChange() const
     m_courseChangeTrace(this);
 }
 
+void
+MobilityModel::EnablePositionStore()
+{
+    NS_ASSERT(!m_positionStore);
+    m_positionStore = MobilityPositionStore::Get();
+    m_positionIndex = m_positionStore->Add();
+}
+
+MobilityPositionStore&
+MobilityModel::GetPositionStore() const
+{
+    NS_ASSERT(m_positionStore);
+    return *m_positionStore;
+}
+
+uint32_t
+MobilityModel::GetPositionIndex() const
+{
+    return m_positionIndex;
+}
+
 int64_t
 MobilityModel::AssignStreams(int64_t start)
 {
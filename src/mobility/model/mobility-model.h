@@ -19,10 +19,14 @@
 #ifndef MOBILITY_MODEL_H
 #define MOBILITY_MODEL_H
 
+#include "mobility-position-store.h"
+
 #include "ns3/object.h"
 #include "ns3/traced-callback.h"
 #include "ns3/vector.h"
 
+#include <vector>
+
 namespace ns3
 {
 
@@ -76,6 +80,30 @@ class MobilityModel : public Object
      * \return the distance between the two objects. Unit is meters.
      */
     double GetDistanceFrom(Ptr<const MobilityModel> position) const;
+    /**
+     * Get the distances between this object and a set of objects, as
+     * GetDistanceFrom but in a single pass over the MobilityPositionStore for
+     * the models whose position is kept there.
+     *
+     * \param others the mobility models of the other objects
+     * \param [out] distances the distances between this object and each of the
+     *        other objects, in the same order. Unit is meters.
+     */
+    void GetDistancesFrom(const std::vector<Ptr<MobilityModel>>& others,
+                          std::vector<double>& distances) const;
+    /**
+     * Get the distances between a position and a set of objects, in a single
+     * pass over the MobilityPositionStore for the models whose position is kept
+     * there.
+     *
+     * \param position the position
+     * \param models the mobility models of the objects
+     * \param [out] distances the distances between the position and each of
+     *        the objects, in the same order. Unit is meters.
+     */
+    static void GetDistances(const Vector& position,
+                             const std::vector<Ptr<MobilityModel>>& models,
+                             std::vector<double>& distances);
     /**
      * \param other reference to another object's mobility model
      * \return the relative speed between the two objects. Unit is meters/s.
@@ -105,6 +133,27 @@ class MobilityModel : public Object
      */
     void NotifyCourseChange() const;
 
+    /**
+     * Keep the position and the velocity of this model in an entry of the
+     * MobilityPositionStore of the current thread. GetPosition then returns the
+     * position of the entry, advanced to the current time, without calling
+     * DoGetPosition until the entry is not valid anymore.
+     *
+     * The subclass must keep the entry up to date whenever its course changes,
+     * and must not be further derived to override DoGetPosition.
+     */
+    void EnablePositionStore();
+
+    /**
+     * \returns the store of the entry of this model, which must be enabled
+     */
+    MobilityPositionStore& GetPositionStore() const;
+
+    /**
+     * \returns the index of the entry of this model in its store
+     */
+    uint32_t GetPositionIndex() const;
+
   private:
     /**
      * \return the current position.
@@ -149,6 +198,9 @@ class MobilityModel : public Object
      * or position has occurred.
      */
     ns3::TracedCallback<Ptr<const MobilityModel>> m_courseChangeTrace;
+
+    Ptr<MobilityPositionStore> m_positionStore; //!< the store of the position, if enabled
+    uint32_t m_positionIndex;                   //!< the index of the entry in the store
 };
 
 } // namespace ns3
@@ -0,0 +1,163 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mobility-position-store.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MobilityPositionStore");
+
+MobilityPositionStore::MobilityPositionStore()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+Ptr<MobilityPositionStore>
+MobilityPositionStore::Get()
+{
+    static thread_local Ptr<MobilityPositionStore> store = Create<MobilityPositionStore>();
+    return store;
+}
+
+uint32_t
+MobilityPositionStore::Add()
+{
+    NS_LOG_FUNCTION(this);
+    uint32_t index;
+    if (m_free.empty())
+    {
+        index = m_x.size();
+        m_x.push_back(0);
+        m_y.push_back(0);
+        m_z.push_back(0);
+        m_vx.push_back(0);
+        m_vy.push_back(0);
+        m_vz.push_back(0);
+        m_last.push_back(0);
+        m_until.push_back(0);
+    }
+    else
+    {
+        index = m_free.back();
+        m_free.pop_back();
+    }
+    Set(index, Vector(0, 0, 0), Vector(0, 0, 0), Time(0));
+    return index;
+}
+
+void
+MobilityPositionStore::Remove(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+    NS_ASSERT(index < m_x.size());
+    m_free.push_back(index);
+}
+
+std::size_t
+MobilityPositionStore::GetN() const
+{
+    return m_x.size() - m_free.size();
+}
+
+void
+MobilityPositionStore::Set(uint32_t index,
+                           const Vector& position,
+                           const Vector& velocity,
+                           Time lastUpdate,
+                           Time validUntil)
+{
+    NS_LOG_FUNCTION(this << index << position << velocity << lastUpdate << validUntil);
+    NS_ASSERT(index < m_x.size());
+    m_x[index] = position.x;
+    m_y[index] = position.y;
+    m_z[index] = position.z;
+    m_vx[index] = velocity.x;
+    m_vy[index] = velocity.y;
+    m_vz[index] = velocity.z;
+    m_last[index] = lastUpdate.GetTimeStep();
+    m_until[index] = validUntil.GetTimeStep();
+}
+
+Vector
+MobilityPositionStore::GetPosition(uint32_t index) const
+{
+    NS_ASSERT(index < m_x.size());
+    return Vector(m_x[index], m_y[index], m_z[index]);
+}
+
+Vector
+MobilityPositionStore::GetVelocity(uint32_t index) const
+{
+    NS_ASSERT(index < m_x.size());
+    return Vector(m_vx[index], m_vy[index], m_vz[index]);
+}
+
+Time
+MobilityPositionStore::GetLastUpdate(uint32_t index) const
+{
+    NS_ASSERT(index < m_x.size());
+    return TimeStep(m_last[index]);
+}
+
+bool
+MobilityPositionStore::Advance(uint32_t index, Time now)
+{
+    NS_ASSERT(index < m_x.size());
+    int64_t t = now.GetTimeStep();
+    if (t >= m_until[index])
+    {
+        return false;
+    }
+    if (t > m_last[index])
+    {
+        double deltaS = TimeStep(t - m_last[index]).GetSeconds();
+        m_x[index] += m_vx[index] * deltaS;
+        m_y[index] += m_vy[index] * deltaS;
+        m_z[index] += m_vz[index] * deltaS;
+        m_last[index] = t;
+    }
+    return true;
+}
+
+void
+MobilityPositionStore::GetDistances(const Vector& position,
+                                    const std::vector<uint32_t>& indices,
+                                    Time now,
+                                    std::vector<double>& distances)
+{
+    NS_LOG_FUNCTION(this << position << indices.size() << now);
+    distances.resize(indices.size());
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+        uint32_t index = indices[i];
+        if (!Advance(index, now))
+        {
+            distances[i] = -1;
+            continue;
+        }
+        double dx = m_x[index] - position.x;
+        double dy = m_y[index] - position.y;
+        double dz = m_z[index] - position.z;
+        distances[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,150 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MOBILITY_POSITION_STORE_H
+#define MOBILITY_POSITION_STORE_H
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/vector.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup mobility
+ *
+ * \brief Positions and velocities of mobility models, stored in contiguous
+ * arrays.
+ *
+ * Each entry holds a position at the time of its last update, a constant
+ * velocity, and the time until which the velocity is valid. Advancing an
+ * entry to the current time moves its position with the velocity, with the
+ * same arithmetic as ConstantVelocityHelper::Update, so that the models
+ * whose kinematics are stored here can be advanced without dereferencing
+ * them: ConstantPositionMobilityModel, ConstantVelocityMobilityModel and
+ * WaypointMobilityModel. An entry cannot be advanced past its validity time,
+ * at which its model must update it.
+ *
+ * There is a store per thread, shared by the mobility models created in this
+ * thread, which keep a reference to it.
+ */
+class MobilityPositionStore : public SimpleRefCount<MobilityPositionStore>
+{
+  public:
+    MobilityPositionStore();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    MobilityPositionStore(const MobilityPositionStore&) = delete;
+    MobilityPositionStore& operator=(const MobilityPositionStore&) = delete;
+
+    /**
+     * \returns the store of the current thread
+     */
+    static Ptr<MobilityPositionStore> Get();
+
+    /**
+     * Add an entry, at the origin with a null velocity, valid forever.
+     * \returns the index of the entry
+     */
+    uint32_t Add();
+
+    /**
+     * Remove an entry, whose index may be reused by a later entry.
+     * \param index the index of the entry
+     */
+    void Remove(uint32_t index);
+
+    /**
+     * \returns the number of entries
+     */
+    std::size_t GetN() const;
+
+    /**
+     * Set the kinematics of an entry.
+     * \param index the index of the entry
+     * \param position the position at the time of the update
+     * \param velocity the velocity
+     * \param lastUpdate the time of the update
+     * \param validUntil the time from which the entry cannot be advanced anymore
+     */
+    void Set(uint32_t index,
+             const Vector& position,
+             const Vector& velocity,
+             Time lastUpdate,
+             Time validUntil = Time::Max());
+
+    /**
+     * \param index the index of the entry
+     * \returns the position of the entry at the time of its last update
+     */
+    Vector GetPosition(uint32_t index) const;
+
+    /**
+     * \param index the index of the entry
+     * \returns the velocity of the entry
+     */
+    Vector GetVelocity(uint32_t index) const;
+
+    /**
+     * \param index the index of the entry
+     * \returns the time of the last update of the entry
+     */
+    Time GetLastUpdate(uint32_t index) const;
+
+    /**
+     * Advance an entry to a time, if it is before its validity time. The
+     * entry is not moved if the time is not after its last update.
+     *
+     * \param index the index of the entry
+     * \param now the time
+     * \returns true if the entry was valid at this time
+     */
+    bool Advance(uint32_t index, Time now);
+
+    /**
+     * Advance a set of entries to a time, as Advance, and compute their
+     * distances to a position.
+     *
+     * \param position the position
+     * \param indices the indices of the entries
+     * \param now the time
+     * \param [out] distances the distances (m), or a negative value for the
+     *        entries which were not valid at this time
+     */
+    void GetDistances(const Vector& position,
+                      const std::vector<uint32_t>& indices,
+                      Time now,
+                      std::vector<double>& distances);
+
+  private:
+    std::vector<double> m_x;      //!< the x coordinates of the positions
+    std::vector<double> m_y;      //!< the y coordinates of the positions
+    std::vector<double> m_z;      //!< the z coordinates of the positions
+    std::vector<double> m_vx;     //!< the x coordinates of the velocities
+    std::vector<double> m_vy;     //!< the y coordinates of the velocities
+    std::vector<double> m_vz;     //!< the z coordinates of the velocities
+    std::vector<int64_t> m_last;  //!< the times of the last updates (time steps)
+    std::vector<int64_t> m_until; //!< the validity times (time steps)
+    std::vector<uint32_t> m_free; //!< the indices of the removed entries
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_POSITION_STORE_H */
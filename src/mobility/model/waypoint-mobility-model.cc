@@ -73,6 +73,8 @@ WaypointMobilityModel::WaypointMobilityModel()
       m_lazyNotify(false),
       m_initialPositionIsWaypoint(false)
 {
+    EnablePositionStore();
+    StoreCurrent();
 }
 
 WaypointMobilityModel::~WaypointMobilityModel()
@@ -99,6 +101,7 @@ WaypointMobilityModel::AddWaypoint(const Waypoint& waypoint)
                         "Waypoints must be added in ascending time order");
         m_waypoints.push_back(waypoint);
     }
+    StoreCurrent();
 
     if (!m_lazyNotify)
     {
@@ -126,6 +129,7 @@ WaypointMobilityModel::Update() const
     const Time now = Simulator::Now();
     bool newWaypoint = false;
 
+    LoadCurrent();
     if (now < m_current.time)
     {
         return;
@@ -146,11 +150,13 @@ WaypointMobilityModel::Update() const
                 m_current.position = m_next.position;
                 m_current.time = now;
                 m_velocity = Vector(0, 0, 0);
+                StoreCurrent();
                 NotifyCourseChange();
             }
             else
             {
                 m_current.time = now;
+                StoreCurrent();
             }
 
             return;
@@ -176,6 +182,7 @@ WaypointMobilityModel::Update() const
         m_current.position.z += m_velocity.z * t_diff;
         m_current.time = now;
     }
+    StoreCurrent();
 
     if (newWaypoint)
     {
@@ -205,6 +212,7 @@ WaypointMobilityModel::DoSetPosition(const Vector& position)
     m_current.time = std::max(now, m_next.time);
     m_current.position = position;
     m_velocity = Vector(0, 0, 0);
+    StoreCurrent();
 
     if (!m_first && (now >= m_current.time))
     {
@@ -220,6 +228,7 @@ WaypointMobilityModel::EndMobility()
     m_current.time = Time(std::numeric_limits<uint64_t>::infinity());
     m_next.time = m_current.time;
     m_first = true;
+    StoreCurrent();
 }
 
 Vector
@@ -228,4 +237,31 @@ WaypointMobilityModel::DoGetVelocity() const
     return m_velocity;
 }
 
+void
+WaypointMobilityModel::LoadCurrent() const
+{
+    const MobilityPositionStore& store = GetPositionStore();
+    m_current.position = store.GetPosition(GetPositionIndex());
+    m_current.time = store.GetLastUpdate(GetPositionIndex());
+}
+
+void
+WaypointMobilityModel::StoreCurrent() const
+{
+    if (m_waypoints.empty() && m_current.time > m_next.time)
+    {
+        // past the last waypoint, Update only moves the time of the position
+        GetPositionStore().Set(GetPositionIndex(),
+                               m_current.position,
+                               Vector(0, 0, 0),
+                               m_current.time);
+        return;
+    }
+    GetPositionStore().Set(GetPositionIndex(),
+                           m_current.position,
+                           m_velocity,
+                           m_current.time,
+                           m_next.time);
+}
+
 } // namespace ns3
@@ -140,6 +140,16 @@ class WaypointMobilityModel : public MobilityModel
      * Update the underlying state corresponding to the stored waypoints
      */
     virtual void Update() const;
+    /**
+     * Read the current position and its time from the MobilityPositionStore,
+     * which may have moved them along the current segment.
+     */
+    void LoadCurrent() const;
+    /**
+     * Write the current position, its time and the velocity to the
+     * MobilityPositionStore, valid until the next waypoint.
+     */
+    void StoreCurrent() const;
     /**
      * \brief The dispose method.
      *
@@ -23,14 +23,24 @@
  */
 
 #include "ns3/boolean.h"
+#include "ns3/constant-acceleration-mobility-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-helper.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/mobility-grid-index.h"
 #include "ns3/mobility-helper.h"
 #include "ns3/mobility-model.h"
+#include "ns3/mobility-position-store.h"
 #include "ns3/scheduler.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 #include "ns3/vector.h"
 #include "ns3/waypoint-mobility-model.h"
 
+#include <cmath>
+#include <limits>
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -472,6 +482,288 @@ WaypointMobilityModelViaHelper::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup mobility-test
+ *
+ * \brief Test that MobilityGridIndex finds the same items as a linear scan,
+ * as the items move, are added and are removed.
+ */
+class MobilityGridIndexTest : public TestCase
+{
+  public:
+    MobilityGridIndexTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Compare the neighbors found by the index to those found by a linear scan.
+     * \param position the position of the query
+     * \param range the range of the query
+     */
+    void CheckNeighbors(const Vector& position, double range);
+
+    /// Compare the neighbors of a few positions, with a few ranges
+    void CheckAll();
+
+    Ptr<MobilityGridIndex> m_index;             //!< the index under test
+    std::vector<Ptr<MobilityModel>> m_mobility; //!< the mobility model of each item
+    std::vector<bool> m_present;                //!< whether each item is in the index
+};
+
+MobilityGridIndexTest::MobilityGridIndexTest()
+    : TestCase("Test MobilityGridIndex neighbor queries")
+{
+}
+
+void
+MobilityGridIndexTest::CheckNeighbors(const Vector& position, double range)
+{
+    std::vector<uint32_t> expected;
+    for (uint32_t id = 0; id < m_mobility.size(); ++id)
+    {
+        if (m_present[id] && (!m_mobility[id] ||
+                              CalculateDistance(m_mobility[id]->GetPosition(), position) <= range))
+        {
+            expected.push_back(id);
+        }
+    }
+    std::vector<uint32_t> ids;
+    m_index->GetNeighbors(position, range, ids);
+    NS_TEST_EXPECT_MSG_EQ(ids.size(),
+                          expected.size(),
+                          "Wrong number of neighbors of " << position << " within " << range);
+    NS_TEST_EXPECT_MSG_EQ((ids == expected),
+                          true,
+                          "Wrong neighbors of " << position << " within " << range);
+}
+
+void
+MobilityGridIndexTest::CheckAll()
+{
+    const double ranges[] = {0, 10, 75, 300, 5000, std::numeric_limits<double>::infinity()};
+    for (const auto& position : {Vector(0, 0, 0), Vector(250, 130, 0), Vector(-40, 610, 20)})
+    {
+        for (double range : ranges)
+        {
+            CheckNeighbors(position, range);
+        }
+    }
+}
+
+void
+MobilityGridIndexTest::DoRun()
+{
+    m_index = Create<MobilityGridIndex>(50);
+    // static items on a pseudo-random pattern, including negative coordinates
+    for (uint32_t id = 0; id < 500; ++id)
+    {
+        Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(Vector(std::fmod(id * 37.1, 700) - 100,
+                                     std::fmod(id * 91.3, 800) - 50,
+                                     std::fmod(id * 3.7, 30)));
+        m_mobility.push_back(mobility);
+    }
+    // an item sharing the mobility model of another one
+    m_mobility.push_back(m_mobility[10]);
+    // an item without a mobility model
+    m_mobility.push_back(nullptr);
+    // moving items
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        Ptr<ConstantVelocityMobilityModel> mobility =
+            CreateObject<ConstantVelocityMobilityModel>();
+        mobility->SetPosition(Vector(i * 100, 0, 0));
+        mobility->SetVelocity(Vector(3, 7, 0));
+        m_mobility.push_back(mobility);
+    }
+    for (uint32_t id = 0; id < m_mobility.size(); ++id)
+    {
+        m_index->Add(id, m_mobility[id]);
+    }
+    m_present.assign(m_mobility.size(), true);
+    NS_TEST_ASSERT_MSG_EQ(m_index->GetN(), m_mobility.size(), "Wrong number of items");
+    CheckAll();
+
+    // remove some items, including the one without a mobility model and one
+    // of those sharing a model
+    for (uint32_t id : {3, 10, 250, 501, 503})
+    {
+        m_index->Remove(id);
+        m_present[id] = false;
+    }
+    CheckAll();
+
+    // move some static items, stop a moving item, and start a static one
+    for (uint32_t id = 0; id < 500; id += 7)
+    {
+        m_mobility[id]->SetPosition(m_mobility[id]->GetPosition() + Vector(120, -80, 0));
+    }
+    DynamicCast<ConstantVelocityMobilityModel>(m_mobility[504])->SetVelocity(Vector(0, 0, 0));
+    Ptr<ConstantVelocityMobilityModel> started = CreateObject<ConstantVelocityMobilityModel>();
+    started->SetPosition(m_mobility[20]->GetPosition());
+    m_index->Remove(20);
+    m_index->Add(20, started);
+    m_mobility[20] = started;
+    started->SetVelocity(Vector(-5, 0, 0));
+    CheckAll();
+
+    // let the moving items move
+    Simulator::Schedule(Seconds(30), &MobilityGridIndexTest::CheckAll, this);
+    Simulator::Run();
+
+    m_index->Clear();
+    m_present.assign(m_mobility.size(), false);
+    NS_TEST_ASSERT_MSG_EQ(m_index->GetN(), 0, "Index not empty");
+    CheckAll();
+    m_index = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup mobility-test
+ *
+ * \brief Test that the models kept in the MobilityPositionStore move exactly
+ * as before, and that the batched distances match GetDistanceFrom.
+ */
+class MobilityPositionStoreTest : public TestCase
+{
+  public:
+    MobilityPositionStoreTest();
+
+  private:
+    void DoRun() override;
+
+    /// Compare the positions and the distances at the current time
+    void Check();
+
+    /**
+     * Count the course changes of a model.
+     * \param counter the counter
+     * \param model the mobility model
+     */
+    static void CountCourseChange(uint32_t* counter, Ptr<const MobilityModel> model);
+
+    Ptr<MobilityModel> m_reference;        //!< the model the distances are computed from
+    std::vector<Ptr<MobilityModel>> m_all; //!< the models, some of which are not in the store
+    /// a model with a constant velocity
+    Ptr<ConstantVelocityMobilityModel> m_constantVelocity;
+    /// the helper which moved ConstantVelocityMobilityModel before the store
+    ConstantVelocityHelper m_helper;
+    Ptr<WaypointMobilityModel> m_batchedWaypoints; //!< a model whose position is only batched
+    Ptr<WaypointMobilityModel> m_waypoints;        //!< a copy whose position is asked directly
+    uint32_t m_batchedCourseChanges;               //!< the course changes of m_batchedWaypoints
+    uint32_t m_courseChanges;                      //!< the course changes of m_waypoints
+};
+
+MobilityPositionStoreTest::MobilityPositionStoreTest()
+    : TestCase("Test the MobilityPositionStore"),
+      m_batchedCourseChanges(0),
+      m_courseChanges(0)
+{
+}
+
+void
+MobilityPositionStoreTest::CountCourseChange(uint32_t* counter, Ptr<const MobilityModel> model)
+{
+    ++(*counter);
+}
+
+void
+MobilityPositionStoreTest::Check()
+{
+    m_helper.Update();
+    Vector position = m_constantVelocity->GetPosition();
+    NS_TEST_EXPECT_MSG_EQ(position.x, m_helper.GetCurrentPosition().x, "Wrong x coordinate");
+    NS_TEST_EXPECT_MSG_EQ(position.y, m_helper.GetCurrentPosition().y, "Wrong y coordinate");
+    NS_TEST_EXPECT_MSG_EQ(position.z, m_helper.GetCurrentPosition().z, "Wrong z coordinate");
+
+    std::vector<double> distances;
+    m_reference->GetDistancesFrom(m_all, distances);
+    NS_TEST_ASSERT_MSG_EQ(distances.size(), m_all.size(), "Wrong number of distances");
+    for (std::size_t i = 0; i < m_all.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(distances[i],
+                              m_reference->GetDistanceFrom(m_all[i]),
+                              "Wrong distance " << i << " at " << Simulator::Now().As(Time::S));
+    }
+
+    // the batched model was moved by GetDistancesFrom only
+    std::vector<double> waypointDistances;
+    m_reference->GetDistancesFrom({m_batchedWaypoints}, waypointDistances);
+    NS_TEST_EXPECT_MSG_EQ(waypointDistances[0],
+                          m_reference->GetDistanceFrom(m_waypoints),
+                          "Wrong waypoint distance at " << Simulator::Now().As(Time::S));
+    NS_TEST_EXPECT_MSG_EQ(m_batchedCourseChanges, m_courseChanges, "Wrong course changes");
+}
+
+void
+MobilityPositionStoreTest::DoRun()
+{
+    Ptr<MobilityPositionStore> store = MobilityPositionStore::Get();
+    std::size_t nEntries = store->GetN();
+
+    m_reference = CreateObject<ConstantPositionMobilityModel>();
+    m_reference->SetPosition(Vector(3.3, -1.7, 0.4));
+
+    m_constantVelocity = CreateObject<ConstantVelocityMobilityModel>();
+    m_constantVelocity->SetPosition(Vector(10.1, 20.7, 1.3));
+    m_helper.SetPosition(Vector(10.1, 20.7, 1.3));
+    m_constantVelocity->SetVelocity(Vector(1.1, -0.3, 0.07));
+    m_helper.SetVelocity(Vector(1.1, -0.3, 0.07));
+    m_helper.Unpause();
+
+    m_batchedWaypoints = CreateObject<WaypointMobilityModel>();
+    m_waypoints = CreateObject<WaypointMobilityModel>();
+    for (const auto& waypoint : {Waypoint(Seconds(1), Vector(0, 0, 0)),
+                                 Waypoint(Seconds(2.3), Vector(13.1, 7.7, 0)),
+                                 Waypoint(Seconds(4.1), Vector(13.1, -29.3, 2.2)),
+                                 Waypoint(Seconds(4.9), Vector(-3.3, 0.1, 0))})
+    {
+        m_batchedWaypoints->AddWaypoint(waypoint);
+        m_waypoints->AddWaypoint(waypoint);
+    }
+    m_batchedWaypoints->TraceConnectWithoutContext(
+        "CourseChange",
+        MakeBoundCallback(&MobilityPositionStoreTest::CountCourseChange, &m_batchedCourseChanges));
+    m_waypoints->TraceConnectWithoutContext(
+        "CourseChange",
+        MakeBoundCallback(&MobilityPositionStoreTest::CountCourseChange, &m_courseChanges));
+
+    Ptr<MobilityModel> constantPosition = CreateObject<ConstantPositionMobilityModel>();
+    constantPosition->SetPosition(Vector(-7.9, 5.1, 0));
+    Ptr<ConstantAccelerationMobilityModel> constantAcceleration =
+        CreateObject<ConstantAccelerationMobilityModel>();
+    constantAcceleration->SetVelocityAndAcceleration(Vector(0.5, 0, 0), Vector(0, 0.2, 0));
+    Ptr<WaypointMobilityModel> waypoints = CreateObject<WaypointMobilityModel>();
+    waypoints->AddWaypoint(Waypoint(Seconds(0.5), Vector(1, 1, 1)));
+    waypoints->AddWaypoint(Waypoint(Seconds(3.7), Vector(-40, 1, 1)));
+    m_all = {constantPosition, constantAcceleration, m_constantVelocity, waypoints};
+    NS_TEST_EXPECT_MSG_EQ(store->GetN(), nEntries + 6, "Wrong number of entries");
+
+    for (double t = 0; t < 7; t += 0.1)
+    {
+        Simulator::Schedule(Seconds(t), &MobilityPositionStoreTest::Check, this);
+    }
+    Simulator::Schedule(Seconds(3), [this]() {
+        m_constantVelocity->SetVelocity(Vector(-2.3, 0.9, 0));
+        m_helper.Update();
+        m_helper.SetVelocity(Vector(-2.3, 0.9, 0));
+    });
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_GT(m_courseChanges, 3, "Too few course changes");
+    Simulator::Destroy();
+
+    m_all.clear();
+    m_reference = nullptr;
+    m_constantVelocity = nullptr;
+    m_batchedWaypoints = nullptr;
+    m_waypoints = nullptr;
+    constantPosition = nullptr;
+    waypoints = nullptr;
+    NS_TEST_EXPECT_MSG_EQ(store->GetN(), nEntries, "Entries not removed");
+}
+
 /**
  * \ingroup mobility-test
  *
@@ -490,6 +782,8 @@ MobilityTestSuite::MobilityTestSuite()
     AddTestCase(new WaypointLazyNotifyTrue, TestCase::QUICK);
     AddTestCase(new WaypointInitialPositionIsWaypoint, TestCase::QUICK);
     AddTestCase(new WaypointMobilityModelViaHelper, TestCase::QUICK);
+    AddTestCase(new MobilityGridIndexTest, TestCase::QUICK);
+    AddTestCase(new MobilityPositionStoreTest, TestCase::QUICK);
 }
 
 /**
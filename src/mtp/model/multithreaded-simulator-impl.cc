@@ -0,0 +1,839 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Implementation of class ns3::MultithreadedSimulatorImpl.
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/assert.h"
+#include "ns3/channel-list.h"
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace ns3
+{
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+thread_local MultithreadedSimulatorImpl::LogicalProcess* MultithreadedSimulatorImpl::m_currentLp =
+    nullptr;
+
+/** Timestamp used to flag the absence of an event. */
+static const uint64_t NO_TS = std::numeric_limits<uint64_t>::max();
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultithreadedSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Mtp")
+            .AddConstructor<MultithreadedSimulatorImpl>()
+            .AddAttribute("MaxThreads",
+                          "The maximum number of threads used to run the logical processes; "
+                          "zero means one per hardware thread.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultithreadedSimulatorImpl::m_maxThreads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("PartitionCount",
+                          "The number of logical processes the nodes are split into; "
+                          "zero means one per thread.  The results only depend on this "
+                          "value, not on the number of threads.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultithreadedSimulatorImpl::m_partitionCount),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+    m_lookAhead = NO_TS;
+    m_maxThreads = 0;
+    m_partitionCount = 0;
+    m_threadCount = 1;
+    m_stop = false;
+    m_stopTs = NO_TS;
+    m_hasStopKey = false;
+    m_running = false;
+    m_uid = EventId::UID::VALID;
+    m_pendingUidBase = m_uid;
+    m_currentTs = 0;
+    m_currentContext = Simulator::NO_CONTEXT;
+    m_barrierCount = 0;
+    m_barrierGeneration = 0;
+    m_mainThreadId = std::this_thread::get_id();
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    while (!m_pending->IsEmpty())
+    {
+        Scheduler::Event next = m_pending->RemoveNext();
+        next.impl->Unref();
+    }
+    m_pending = nullptr;
+    for (auto& lp : m_lps)
+    {
+        while (!lp.events->IsEmpty())
+        {
+            Scheduler::Event next = lp.events->RemoveNext();
+            next.impl->Unref();
+        }
+        lp.events = nullptr;
+    }
+    for (auto& inbox : m_inboxes)
+    {
+        for (auto& message : inbox)
+        {
+            message.event->Unref();
+        }
+    }
+    m_lps.clear();
+    m_inboxes.clear();
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    while (!m_destroyEvents.empty())
+    {
+        Ptr<EventImpl> ev = m_destroyEvents.front().PeekEventImpl();
+        m_destroyEvents.pop_front();
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    NS_ASSERT_MSG(!m_running, "Cannot change the scheduler while running");
+    m_schedulerFactory = schedulerFactory;
+
+    Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler>();
+    if (m_pending)
+    {
+        while (!m_pending->IsEmpty())
+        {
+            scheduler->Insert(m_pending->RemoveNext());
+        }
+    }
+    m_pending = scheduler;
+
+    for (auto& lp : m_lps)
+    {
+        scheduler = schedulerFactory.Create<Scheduler>();
+        while (!lp.events->IsEmpty())
+        {
+            scheduler->Insert(lp.events->RemoveNext());
+        }
+        lp.events = scheduler;
+    }
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    return 0;
+}
+
+void
+MultithreadedSimulatorImpl::Partition()
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t nNodes = NodeList::GetNNodes();
+
+    // Union-find over the nodes: nodes sharing a channel without delay
+    // can not be simulated concurrently.
+    std::vector<uint32_t> parent(nNodes);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](uint32_t i) {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+
+    /** A channel with a strictly positive delay. */
+    struct Link
+    {
+        std::vector<uint32_t> nodes; //!< The nodes attached to the channel.
+        uint64_t delay;              //!< The channel delay.
+    };
+
+    std::vector<Link> links;
+
+    for (auto i = ChannelList::Begin(); i != ChannelList::End(); ++i)
+    {
+        Ptr<Channel> channel = *i;
+        std::vector<uint32_t> nodes;
+        for (std::size_t j = 0; j < channel->GetNDevices(); ++j)
+        {
+            Ptr<NetDevice> device = channel->GetDevice(j);
+            if (device && device->GetNode() && device->GetNode()->GetId() < nNodes)
+            {
+                nodes.push_back(device->GetNode()->GetId());
+            }
+        }
+        if (nodes.size() < 2)
+        {
+            continue;
+        }
+
+        TimeValue delay;
+        if (channel->GetAttributeFailSafe("Delay", delay) && delay.Get().IsStrictlyPositive())
+        {
+            links.push_back({nodes, static_cast<uint64_t>(delay.Get().GetTimeStep())});
+        }
+        else
+        {
+            NS_LOG_LOGIC("channel " << channel->GetId() << " has no delay, merging its nodes");
+            for (auto node : nodes)
+            {
+                parent[find(node)] = find(nodes.front());
+            }
+        }
+    }
+
+    // Number the connected components in order of their smallest node id.
+    std::vector<uint32_t> component(nNodes);
+    std::vector<uint32_t> componentOf(nNodes, std::numeric_limits<uint32_t>::max());
+    std::vector<uint32_t> componentSize;
+    for (uint32_t node = 0; node < nNodes; ++node)
+    {
+        uint32_t root = find(node);
+        if (componentOf[root] == std::numeric_limits<uint32_t>::max())
+        {
+            componentOf[root] = componentSize.size();
+            componentSize.push_back(0);
+        }
+        component[node] = componentOf[root];
+        componentSize[component[node]]++;
+    }
+
+    uint32_t partitions = m_partitionCount;
+    if (partitions == 0)
+    {
+        partitions = m_maxThreads != 0 ? m_maxThreads : std::thread::hardware_concurrency();
+    }
+    partitions = std::max<uint32_t>(1, std::min<uint32_t>(partitions, componentSize.size()));
+
+    // Greedily assign each component to the least loaded partition.
+    std::vector<uint32_t> partitionOf(componentSize.size());
+    std::vector<uint32_t> load(partitions, 0);
+    for (uint32_t c = 0; c < componentSize.size(); ++c)
+    {
+        uint32_t p = std::min_element(load.begin(), load.end()) - load.begin();
+        partitionOf[c] = p;
+        load[p] += componentSize[c];
+    }
+
+    m_contextToLp.resize(nNodes);
+    for (uint32_t node = 0; node < nNodes; ++node)
+    {
+        m_contextToLp[node] = partitionOf[component[node]];
+    }
+
+    m_lookAhead = NO_TS;
+    for (const auto& link : links)
+    {
+        for (auto node : link.nodes)
+        {
+            if (m_contextToLp[node] != m_contextToLp[link.nodes.front()])
+            {
+                m_lookAhead = std::min(m_lookAhead, link.delay);
+                break;
+            }
+        }
+    }
+
+    m_lps.resize(partitions);
+    for (uint32_t p = 0; p < partitions; ++p)
+    {
+        LogicalProcess& lp = m_lps[p];
+        lp.id = p;
+        lp.events = m_schedulerFactory.Create<Scheduler>();
+        lp.uid = m_uid;
+        lp.currentUid = EventId::UID::INVALID;
+        lp.currentTs = m_currentTs;
+        lp.currentContext = Simulator::NO_CONTEXT;
+        lp.eventCount = 0;
+        lp.nextTs = NO_TS;
+        lp.stopped = false;
+    }
+    m_inboxes.resize(partitions * partitions);
+
+    NS_LOG_INFO(nNodes << " nodes in " << componentSize.size() << " components, " << partitions
+                       << " partitions, lookahead " << GetLookAhead());
+}
+
+void
+MultithreadedSimulatorImpl::DrainInbox(LogicalProcess& lp)
+{
+    uint32_t n = m_lps.size();
+    lp.received.clear();
+    for (uint32_t sender = 0; sender < n; ++sender)
+    {
+        std::vector<Message>& inbox = m_inboxes[lp.id * n + sender];
+        lp.received.insert(lp.received.end(), inbox.begin(), inbox.end());
+        inbox.clear();
+    }
+
+    // The messages are grouped by sender and in sending order: a stable sort
+    // keeps this order for events with the same timestamps.
+    std::stable_sort(lp.received.begin(),
+                     lp.received.end(),
+                     [](const Message& a, const Message& b) {
+                         return a.ts < b.ts || (a.ts == b.ts && a.sendTs < b.sendTs);
+                     });
+    for (const auto& message : lp.received)
+    {
+        Scheduler::Event ev;
+        ev.impl = message.event;
+        ev.key.m_ts = message.ts;
+        ev.key.m_context = message.context;
+        ev.key.m_uid = lp.uid;
+        lp.uid++;
+        lp.events->Insert(ev);
+    }
+
+    lp.nextTs = NO_TS;
+    if (!lp.events->IsEmpty())
+    {
+        Scheduler::EventKey key = lp.events->PeekNext().key;
+        if (BeforeStop(key))
+        {
+            lp.nextTs = key.m_ts;
+        }
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::BeforeStop(const Scheduler::EventKey& key) const
+{
+    return !m_hasStopKey || key < m_stopKey;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow(LogicalProcess& lp, uint64_t windowEnd)
+{
+    m_currentLp = &lp;
+    while (!lp.events->IsEmpty())
+    {
+        Scheduler::EventKey key = lp.events->PeekNext().key;
+        if (key.m_ts >= windowEnd || !BeforeStop(key) ||
+            key.m_ts > m_stopTs.load(std::memory_order_relaxed))
+        {
+            break;
+        }
+
+        Scheduler::Event next = lp.events->RemoveNext();
+
+        PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+        NS_ASSERT(next.key.m_ts >= lp.currentTs);
+        lp.eventCount++;
+
+        NS_LOG_LOGIC("handle " << next.key.m_ts);
+        lp.currentTs = next.key.m_ts;
+        lp.currentContext = next.key.m_context;
+        lp.currentUid = next.key.m_uid;
+        next.impl->Invoke();
+        next.impl->Unref();
+
+        if (lp.stopped)
+        {
+            break;
+        }
+    }
+    m_currentLp = nullptr;
+}
+
+void
+MultithreadedSimulatorImpl::Barrier()
+{
+    if (m_threadCount == 1)
+    {
+        return;
+    }
+    std::unique_lock lock{m_barrierMutex};
+    uint64_t generation = m_barrierGeneration;
+    if (++m_barrierCount == m_threadCount)
+    {
+        m_barrierCount = 0;
+        m_barrierGeneration++;
+        m_barrierCv.notify_all();
+    }
+    else
+    {
+        m_barrierCv.wait(lock, [this, generation] { return generation != m_barrierGeneration; });
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunThread(uint32_t thread)
+{
+    uint32_t n = m_lps.size();
+    while (true)
+    {
+        // m_stop is only written while processing a window, so all the
+        // threads read the same value here.
+        bool stop = m_stop;
+
+        for (uint32_t i = thread; i < n; i += m_threadCount)
+        {
+            DrainInbox(m_lps[i]);
+        }
+        Barrier();
+
+        // Every thread takes the same decision from the same data.
+        uint64_t next = NO_TS;
+        for (const auto& lp : m_lps)
+        {
+            next = std::min(next, lp.nextTs);
+        }
+        if (stop || next == NO_TS)
+        {
+            break;
+        }
+        uint64_t windowEnd = m_lookAhead >= NO_TS - next ? NO_TS : next + m_lookAhead;
+
+        for (uint32_t i = thread; i < n; i += m_threadCount)
+        {
+            ProcessWindow(m_lps[i], windowEnd);
+        }
+        Barrier();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    if (m_stop)
+    {
+        return true;
+    }
+    if (!m_pending->IsEmpty())
+    {
+        return false;
+    }
+    for (const auto& lp : m_lps)
+    {
+        if (!lp.events->IsEmpty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    // Set the current threadId as the main threadId
+    m_mainThreadId = std::this_thread::get_id();
+    if (m_lps.empty())
+    {
+        Partition();
+    }
+    m_stop = false;
+    m_stopTs = NO_TS;
+
+    while (!m_pending->IsEmpty())
+    {
+        Scheduler::Event ev = m_pending->RemoveNext();
+        m_lps[GetPartition(ev.key.m_context)].events->Insert(ev);
+    }
+    for (auto& lp : m_lps)
+    {
+        lp.uid = std::max(lp.uid, m_uid);
+        lp.currentTs = m_currentTs;
+        lp.stopped = false;
+    }
+
+    uint32_t threads = m_maxThreads != 0 ? m_maxThreads : std::thread::hardware_concurrency();
+    m_threadCount = std::max<uint32_t>(1, std::min<uint32_t>(threads, m_lps.size()));
+
+    m_running = true;
+    std::vector<std::thread> workers;
+    for (uint32_t thread = 1; thread < m_threadCount; ++thread)
+    {
+        workers.emplace_back(&MultithreadedSimulatorImpl::RunThread, this, thread);
+    }
+    RunThread(0);
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    m_running = false;
+
+    if (m_stop)
+    {
+        m_currentTs = m_stopTs;
+    }
+    else if (m_hasStopKey && !IsFinished())
+    {
+        // Stopped by Stop(const Time&)
+        m_currentTs = m_stopKey.m_ts;
+        m_hasStopKey = false;
+    }
+    else
+    {
+        for (const auto& lp : m_lps)
+        {
+            m_currentTs = std::max(m_currentTs, lp.currentTs);
+        }
+    }
+    for (const auto& lp : m_lps)
+    {
+        m_uid = std::max(m_uid, lp.uid);
+    }
+    m_pendingUidBase = m_uid;
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    LogicalProcess* lp = m_currentLp;
+    if (lp != nullptr)
+    {
+        lp->stopped = true;
+        uint64_t ts = m_stopTs.load();
+        while (lp->currentTs < ts && !m_stopTs.compare_exchange_weak(ts, lp->currentTs))
+        {
+        }
+    }
+    m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    if (m_currentLp != nullptr)
+    {
+        Simulator::Schedule(delay, &Simulator::Stop);
+        return;
+    }
+    NS_ASSERT_MSG(!m_running, "Simulator::Stop Thread-unsafe invocation!");
+    Scheduler::EventKey key;
+    key.m_ts = (uint64_t)(delay + TimeStep(m_currentTs)).GetTimeStep();
+    key.m_uid = m_uid;
+    key.m_context = m_currentContext;
+    m_uid++;
+    if (!m_hasStopKey || key < m_stopKey)
+    {
+        m_stopKey = key;
+        m_hasStopKey = true;
+    }
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep() << event);
+    NS_ASSERT_MSG(delay.IsPositive(), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+
+    Scheduler::Event ev;
+    ev.impl = event;
+    LogicalProcess* lp = m_currentLp;
+    if (lp == nullptr)
+    {
+        NS_ASSERT_MSG(!m_running && m_mainThreadId == std::this_thread::get_id(),
+                      "Simulator::Schedule Thread-unsafe invocation!");
+        ev.key.m_ts = (uint64_t)(delay + TimeStep(m_currentTs)).GetTimeStep();
+        ev.key.m_context = m_currentContext;
+        ev.key.m_uid = m_uid;
+        m_uid++;
+        m_pending->Insert(ev);
+    }
+    else
+    {
+        ev.key.m_ts = (uint64_t)(delay + TimeStep(lp->currentTs)).GetTimeStep();
+        ev.key.m_context = lp->currentContext;
+        ev.key.m_uid = lp->uid;
+        lp->uid++;
+        lp->events->Insert(ev);
+    }
+    return EventId(event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+    NS_ASSERT_MSG(delay.IsPositive(),
+                  "MultithreadedSimulatorImpl::ScheduleWithContext(): Negative delay");
+
+    LogicalProcess* lp = m_currentLp;
+    if (lp == nullptr)
+    {
+        if (m_running || m_mainThreadId != std::this_thread::get_id())
+        {
+            NS_FATAL_ERROR("MultithreadedSimulatorImpl does not support scheduling events from "
+                           "threads which do not run the simulation");
+        }
+        Scheduler::Event ev;
+        ev.impl = event;
+        ev.key.m_ts = (uint64_t)(delay + TimeStep(m_currentTs)).GetTimeStep();
+        ev.key.m_context = context;
+        ev.key.m_uid = m_uid;
+        m_uid++;
+        m_pending->Insert(ev);
+        return;
+    }
+
+    uint64_t ts = (uint64_t)(delay + TimeStep(lp->currentTs)).GetTimeStep();
+    uint32_t target = GetPartition(context);
+    if (target == lp->id)
+    {
+        Scheduler::Event ev;
+        ev.impl = event;
+        ev.key.m_ts = ts;
+        ev.key.m_context = context;
+        ev.key.m_uid = lp->uid;
+        lp->uid++;
+        lp->events->Insert(ev);
+        return;
+    }
+
+    if ((uint64_t)delay.GetTimeStep() < m_lookAhead)
+    {
+        NS_FATAL_ERROR("Event scheduled from context "
+                       << lp->currentContext << " to context " << context << " with delay "
+                       << delay << " shorter than the lookahead " << GetLookAhead()
+                       << "; the nodes must be connected by a channel with a \"Delay\" attribute");
+    }
+    m_inboxes[target * m_lps.size() + lp->id].push_back({ts, lp->currentTs, context, event});
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    std::unique_lock lock{m_destroyEventsMutex};
+    EventId id(Ptr<EventImpl>(event, false), Now().GetTimeStep(), 0xffffffff, 2);
+    m_destroyEvents.push_back(id);
+    if (m_currentLp == nullptr)
+    {
+        m_uid++;
+    }
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    LogicalProcess* lp = m_currentLp;
+    return TimeStep(lp != nullptr ? lp->currentTs : m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    else
+    {
+        return TimeStep(id.GetTs() - Now().GetTimeStep());
+    }
+}
+
+Ptr<Scheduler>
+MultithreadedSimulatorImpl::FindOwner(const EventId& id,
+                                      uint64_t& currentTs,
+                                      uint32_t& currentUid) const
+{
+    if (m_lps.empty() || (!m_running && id.GetUid() >= m_pendingUidBase))
+    {
+        currentTs = m_currentTs;
+        currentUid = EventId::UID::INVALID;
+        return m_pending;
+    }
+    const LogicalProcess& lp = m_lps[GetPartition(id.GetContext())];
+    currentTs = lp.currentTs;
+    currentUid = lp.currentUid;
+    return lp.events;
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        std::unique_lock lock{m_destroyEventsMutex};
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    uint64_t currentTs;
+    uint32_t currentUid;
+    Ptr<Scheduler> events = FindOwner(id, currentTs, currentUid);
+
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        std::unique_lock lock{m_destroyEventsMutex};
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+    {
+        return true;
+    }
+    uint64_t currentTs;
+    uint32_t currentUid;
+    FindOwner(id, currentTs, currentUid);
+    return id.GetTs() < currentTs || (id.GetTs() == currentTs && id.GetUid() <= currentUid);
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    LogicalProcess* lp = m_currentLp;
+    return lp != nullptr ? lp->currentContext : m_currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    uint64_t count = 0;
+    for (const auto& lp : m_lps)
+    {
+        count += lp.eventCount;
+    }
+    return count;
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookAhead() const
+{
+    return m_lookAhead == NO_TS ? Time::Max() : TimeStep(m_lookAhead);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount() const
+{
+    return m_lps.size();
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition(uint32_t context) const
+{
+    return context < m_contextToLp.size() ? m_contextToLp[context] : 0;
+}
+
+} // namespace ns3
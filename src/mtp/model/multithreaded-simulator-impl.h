@@ -0,0 +1,271 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Declaration of class ns3::MultithreadedSimulatorImpl.
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/event-impl.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/ptr.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator-impl.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup simulator
+ * \defgroup mtp Multithreaded Parallel Simulation
+ */
+
+/**
+ * \ingroup mtp
+ *
+ * \brief Shared-memory conservative parallel simulator implementation.
+ *
+ * At the first call to Run() the nodes of the NodeList are partitioned
+ * into logical processes (LPs).  Nodes attached to a channel which does
+ * not expose a strictly positive "Delay" attribute are always kept in the
+ * same LP; the remaining connected components are distributed over
+ * PartitionCount LPs.  The lookahead is the smallest "Delay" of the
+ * channels which cross an LP boundary.
+ *
+ * Each LP owns its own Scheduler and event clock.  The simulation then
+ * advances in synchronous windows: all LPs agree on the smallest pending
+ * timestamp \c t and execute, concurrently, every event earlier than
+ * <tt>t + lookahead</tt>.  Events scheduled with ScheduleWithContext()
+ * towards a node owned by another LP are buffered in the target LP's
+ * inbox and inserted at the next window boundary, in an order which only
+ * depends on the event timestamps and on the sender LP, so that results
+ * do not depend on the number of threads or on thread interleaving.
+ *
+ * Contexts which do not map to a node, such as Simulator::NO_CONTEXT,
+ * are owned by the first LP.
+ *
+ * Models must only touch state owned by the node in whose context they
+ * execute; events owned by one LP can only be cancelled from that LP,
+ * or from the main thread while the simulation is not running.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // Inherited
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    void Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * Get the lookahead used to size the synchronization windows.
+     *
+     * \return The lookahead, or Time::Max() if no channel crosses
+     *         a partition boundary.  Only valid after the first Run().
+     */
+    Time GetLookAhead() const;
+
+    /**
+     * Get the number of logical processes.
+     *
+     * \return The number of logical processes, zero before the first Run().
+     */
+    uint32_t GetPartitionCount() const;
+
+    /**
+     * Get the logical process owning a given context.
+     *
+     * \param [in] context The event context, usually a node id.
+     * \return The index of the logical process.
+     */
+    uint32_t GetPartition(uint32_t context) const;
+
+  private:
+    void DoDispose() override;
+
+    /** An event sent to another logical process. */
+    struct Message
+    {
+        uint64_t ts;      //!< Absolute timestamp of the event.
+        uint64_t sendTs;  //!< Timestamp at which the event was scheduled.
+        uint32_t context; //!< The event context.
+        EventImpl* event; //!< The event implementation.
+    };
+
+    /** The state owned by one logical process. */
+    struct LogicalProcess
+    {
+        uint32_t id;                   //!< The index of this LP.
+        Ptr<Scheduler> events;         //!< The event priority queue.
+        uint32_t uid;                  //!< Next event unique id.
+        uint32_t currentUid;           //!< Unique id of the current event.
+        uint64_t currentTs;            //!< Timestamp of the current event.
+        uint32_t currentContext;       //!< Execution context of the current event.
+        uint64_t eventCount;           //!< The number of events executed.
+        uint64_t nextTs;               //!< Timestamp of the first event of the next window.
+        bool stopped;                  //!< Whether Stop() was called from this LP.
+        std::vector<Message> received; //!< Scratch space used by DrainInbox().
+    };
+
+    /**
+     * Partition the nodes into logical processes and compute the lookahead.
+     */
+    void Partition();
+    /**
+     * Move the events received by a logical process into its scheduler
+     * and update LogicalProcess::nextTs.
+     *
+     * \param [in] lp The logical process.
+     */
+    void DrainInbox(LogicalProcess& lp);
+    /**
+     * Execute the events of a logical process up to the window end.
+     *
+     * \param [in] lp The logical process.
+     * \param [in] windowEnd Exclusive upper bound of the window.
+     */
+    void ProcessWindow(LogicalProcess& lp, uint64_t windowEnd);
+    /**
+     * Main loop run by each worker thread.
+     *
+     * \param [in] thread The index of the worker thread.
+     */
+    void RunThread(uint32_t thread);
+    /** Wait until all the worker threads reach this point. */
+    void Barrier();
+    /**
+     * Check whether an event key is earlier than the stop key.
+     *
+     * \param [in] key The event key.
+     * \return \c true if the event must be executed before stopping.
+     */
+    bool BeforeStop(const Scheduler::EventKey& key) const;
+    /**
+     * Get the scheduler in which an event lives.
+     *
+     * \param [in] id The event.
+     * \param [out] currentTs The current timestamp of the event owner.
+     * \param [out] currentUid The current event uid of the event owner.
+     * \return The scheduler holding the event.
+     */
+    Ptr<Scheduler> FindOwner(const EventId& id, uint64_t& currentTs, uint32_t& currentUid) const;
+
+    /** Container type for the events to run at Simulator::Destroy() */
+    typedef std::list<EventId> DestroyEvents;
+    /** The container of events to run at Destroy. */
+    DestroyEvents m_destroyEvents;
+    /** Mutex protecting m_destroyEvents. */
+    mutable std::mutex m_destroyEventsMutex;
+
+    /** Factory used to create the per-LP schedulers. */
+    ObjectFactory m_schedulerFactory;
+    /** Events scheduled from the main thread while not running. */
+    Ptr<Scheduler> m_pending;
+    /** The logical processes. */
+    std::vector<LogicalProcess> m_lps;
+    /** Map from node id to logical process. */
+    std::vector<uint32_t> m_contextToLp;
+    /**
+     * Inboxes, indexed by <tt>target * m_lps.size() + sender</tt>, so that
+     * each vector has a single writer and no locking is needed.
+     */
+    std::vector<std::vector<Message>> m_inboxes;
+    /** The lookahead, in time steps. */
+    uint64_t m_lookAhead;
+
+    /** Maximum number of worker threads. */
+    uint32_t m_maxThreads;
+    /** Requested number of logical processes. */
+    uint32_t m_partitionCount;
+    /** Number of threads used for the current run. */
+    uint32_t m_threadCount;
+
+    /** Flag set by Stop(). */
+    std::atomic<bool> m_stop;
+    /** Smallest timestamp at which Stop() was called during the current window. */
+    std::atomic<uint64_t> m_stopTs;
+    /** Stop key set by Stop(const Time&). */
+    Scheduler::EventKey m_stopKey;
+    /** Whether m_stopKey is set. */
+    bool m_hasStopKey;
+    /** Whether Run() is executing. */
+    bool m_running;
+
+    /** Next event unique id for events scheduled from the main thread. */
+    uint32_t m_uid;
+    /** Smallest uid of the events held in m_pending. */
+    uint32_t m_pendingUidBase;
+    /** Timestamp reached by the last run. */
+    uint64_t m_currentTs;
+    /** Execution context of the main thread. */
+    uint32_t m_currentContext;
+
+    /** Number of threads waiting at the barrier. */
+    uint32_t m_barrierCount;
+    /** Barrier generation, to tell apart consecutive barriers. */
+    uint64_t m_barrierGeneration;
+    /** Mutex of the barrier. */
+    std::mutex m_barrierMutex;
+    /** Condition variable of the barrier. */
+    std::condition_variable m_barrierCv;
+
+    /** Main execution thread. */
+    std::thread::id m_mainThreadId;
+
+    /** The logical process executed by the calling thread, if any. */
+    static thread_local LogicalProcess* m_currentLp;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,291 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl test suite.
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-tests Multithreaded simulation tests
+ */
+
+namespace
+{
+
+/** Per node log of (timestamp, token) pairs. */
+typedef std::vector<std::vector<std::pair<int64_t, uint32_t>>> TokenLogs;
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Forward tokens around a ring of nodes, logging the tokens received
+ * by each node.
+ */
+class TokenRelay
+{
+  public:
+    /**
+     * Constructor.
+     * \param nNodes The number of nodes of the ring.
+     */
+    TokenRelay(uint32_t nNodes)
+        : m_logs(nNodes)
+    {
+    }
+
+    /**
+     * Receive a token and forward it to a neighbor.
+     * \param node The receiving node.
+     * \param token The token.
+     * \param hops The number of hops left.
+     */
+    void Receive(uint32_t node, uint32_t token, uint32_t hops)
+    {
+        m_contextOk = m_contextOk && Simulator::GetContext() == node;
+        m_logs[node].emplace_back(Simulator::Now().GetTimeStep(), token);
+        Simulator::ScheduleNow(&TokenRelay::Local, this, node, token);
+        if (hops == 0)
+        {
+            return;
+        }
+        uint32_t n = m_logs.size();
+        uint32_t next = (token + hops) % 3 == 0 ? (node + n - 1) % n : (node + 1) % n;
+        Time delay = MilliSeconds(1) + NanoSeconds(token * 64 + hops);
+        Simulator::ScheduleWithContext(next,
+                                       delay,
+                                       &TokenRelay::Receive,
+                                       this,
+                                       next,
+                                       token,
+                                       hops - 1);
+    }
+
+    /**
+     * Local event scheduled when a token is received.
+     * \param node The receiving node.
+     * \param token The token.
+     */
+    void Local(uint32_t node, uint32_t token)
+    {
+        m_logs[node].emplace_back(Simulator::Now().GetTimeStep(), token + 1000);
+    }
+
+    TokenLogs m_logs;       //!< The logs, per node.
+    bool m_contextOk{true}; //!< Whether all events ran in the expected context.
+};
+
+/**
+ * Create a ring of nodes connected by SimpleChannels.
+ * \param nNodes The number of nodes.
+ * \param delay The channel delay.
+ * \return The nodes.
+ */
+NodeContainer
+BuildRing(uint32_t nNodes, Time delay)
+{
+    NodeContainer nodes;
+    nodes.Create(nNodes);
+    SimpleNetDeviceHelper helper;
+    helper.SetChannelAttribute("Delay", TimeValue(delay));
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        helper.Install(NodeContainer(nodes.Get(i), nodes.Get((i + 1) % nNodes)));
+    }
+    return nodes;
+}
+
+} // namespace
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Check the partitioning of the nodes and the lookahead.
+ */
+class MtpPartitionTestCase : public TestCase
+{
+  public:
+    MtpPartitionTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MtpPartitionTestCase::MtpPartitionTestCase()
+    : TestCase("Check node partitioning and lookahead")
+{
+}
+
+void
+MtpPartitionTestCase::DoRun()
+{
+    ObjectFactory factory("ns3::MultithreadedSimulatorImpl");
+    factory.Set("PartitionCount", UintegerValue(8));
+    Ptr<MultithreadedSimulatorImpl> impl = factory.Create<MultithreadedSimulatorImpl>();
+    Simulator::SetImplementation(impl);
+
+    NodeContainer nodes;
+    nodes.Create(5);
+    SimpleNetDeviceHelper helper;
+    helper.Install(NodeContainer(nodes.Get(0), nodes.Get(1)));
+    helper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(2)));
+    helper.Install(NodeContainer(nodes.Get(1), nodes.Get(2)));
+    helper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
+    helper.Install(NodeContainer(nodes.Get(2), nodes.Get(3)));
+
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(impl->GetPartitionCount(), 4, "Four independent groups of nodes");
+    NS_TEST_ASSERT_MSG_EQ(impl->GetPartition(0),
+                          impl->GetPartition(1),
+                          "Nodes sharing a channel without delay must share a partition");
+    NS_TEST_ASSERT_MSG_NE(impl->GetPartition(1),
+                          impl->GetPartition(2),
+                          "Nodes 1 and 2 should be in different partitions");
+    NS_TEST_ASSERT_MSG_EQ(impl->GetPartition(Simulator::NO_CONTEXT),
+                          0,
+                          "NO_CONTEXT belongs to the first partition");
+    NS_TEST_ASSERT_MSG_EQ(impl->GetLookAhead(), MilliSeconds(1), "Unexpected lookahead");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Check that the multithreaded implementation gives the same results
+ * as the default one.
+ */
+class MtpSequentialTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param threads The number of threads.
+     * \param partitions The number of partitions.
+     */
+    MtpSequentialTestCase(uint32_t threads, uint32_t partitions);
+
+  private:
+    void DoRun() override;
+    /**
+     * Run the token relay scenario.
+     * \param impl The simulator implementation.
+     * \param [out] contextOk Whether all events ran in their context.
+     * \return The token logs.
+     */
+    TokenLogs RunRelay(Ptr<SimulatorImpl> impl, bool& contextOk);
+
+    uint32_t m_threads;    //!< The number of threads.
+    uint32_t m_partitions; //!< The number of partitions.
+};
+
+MtpSequentialTestCase::MtpSequentialTestCase(uint32_t threads, uint32_t partitions)
+    : TestCase("Check equivalence with the default simulator, " + std::to_string(threads) +
+               " threads, " + std::to_string(partitions) + " partitions"),
+      m_threads(threads),
+      m_partitions(partitions)
+{
+}
+
+TokenLogs
+MtpSequentialTestCase::RunRelay(Ptr<SimulatorImpl> impl, bool& contextOk)
+{
+    const uint32_t nNodes = 8;
+    Simulator::SetImplementation(impl);
+    BuildRing(nNodes, MilliSeconds(1));
+    TokenRelay relay(nNodes);
+    for (uint32_t token = 0; token < 40; ++token)
+    {
+        uint32_t node = token % nNodes;
+        Simulator::ScheduleWithContext(node,
+                                       MicroSeconds(token * 3),
+                                       &TokenRelay::Receive,
+                                       &relay,
+                                       node,
+                                       token,
+                                       30);
+    }
+    Simulator::Stop(MilliSeconds(25));
+    Simulator::Run();
+    Simulator::Destroy();
+    contextOk = relay.m_contextOk;
+    return relay.m_logs;
+}
+
+void
+MtpSequentialTestCase::DoRun()
+{
+    bool contextOk;
+    ObjectFactory factory("ns3::DefaultSimulatorImpl");
+    TokenLogs expected = RunRelay(factory.Create<SimulatorImpl>(), contextOk);
+
+    factory.SetTypeId("ns3::MultithreadedSimulatorImpl");
+    factory.Set("MaxThreads", UintegerValue(m_threads));
+    factory.Set("PartitionCount", UintegerValue(m_partitions));
+    TokenLogs logs = RunRelay(factory.Create<SimulatorImpl>(), contextOk);
+
+    NS_TEST_ASSERT_MSG_EQ(contextOk, true, "Events ran in an unexpected context");
+    for (uint32_t node = 0; node < expected.size(); ++node)
+    {
+        NS_TEST_ASSERT_MSG_GT(expected[node].size(), 0, "Node " << node << " received no token");
+        NS_TEST_ASSERT_MSG_EQ(logs[node].size(),
+                              expected[node].size(),
+                              "Unexpected number of events on node " << node);
+        for (uint32_t i = 0; i < expected[node].size(); ++i)
+        {
+            NS_TEST_ASSERT_MSG_EQ(logs[node][i].first,
+                                  expected[node][i].first,
+                                  "Unexpected event time on node " << node);
+            NS_TEST_ASSERT_MSG_EQ(logs[node][i].second,
+                                  expected[node][i].second,
+                                  "Unexpected event on node " << node);
+        }
+    }
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * The multithreaded simulator test suite.
+ */
+class MtpTestSuite : public TestSuite
+{
+  public:
+    MtpTestSuite()
+        : TestSuite("mtp", UNIT)
+    {
+        AddTestCase(new MtpPartitionTestCase(), TestCase::QUICK);
+        AddTestCase(new MtpSequentialTestCase(1, 1), TestCase::QUICK);
+        AddTestCase(new MtpSequentialTestCase(1, 4), TestCase::QUICK);
+        AddTestCase(new MtpSequentialTestCase(4, 4), TestCase::QUICK);
+        AddTestCase(new MtpSequentialTestCase(3, 8), TestCase::QUICK);
+    }
+};
+
+static MtpTestSuite g_mtpTestSuite; //!< Static variable for test initialization
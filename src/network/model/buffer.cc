@@ -20,6 +20,10 @@
 
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/mpsc-queue.h"
+
+#include <atomic>
+#include <mutex>
 
 #define LOG_INTERNAL_STATE(y)                                                                      \
     NS_LOG_LOGIC(y << "start=" << m_start << ", end=" << m_end                                     \
@@ -54,47 +58,146 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Buffer");
 
-uint32_t Buffer::g_recommendedStart = 0;
+thread_local uint32_t Buffer::g_recommendedStart = 0;
 #ifdef BUFFER_FREE_LIST
-/* The following macros are pretty evil but they are needed to allow us to
- * keep track of 3 possible states for the g_freeList variable:
- *  - uninitialized means that no one has created a buffer yet
- *    so no one has created the associated free list (it is created
- *    on-demand when the first buffer is created)
- *  - initialized means that the free list exists and is valid
- *  - destroyed means that the static destructors of this compilation unit
- *    have run so, the free list has been cleared from its content
- * The key is that in destroyed state, we are careful not re-create it
- * which is a typical weakness of lazy evaluation schemes which use
- * '0' as a special value to indicate both un-initialized and destroyed.
- * Note that it is important to use '0' as the marker for un-initialized state
- * because the variable holding this state information is initialized to zero
- * which the compiler assigns to zero-memory which is initialized to _zero_
- * before the constructors run so this ensures perfect handling of crazy
- * constructor orderings.
+/**
+ * \brief The buffer data storage recycled by a thread.
+ *
+ * Each thread reuses the data it allocated without taking any lock.
+ * The data released by other threads is handed back to the free list
+ * which allocated it through a lock-free queue, drained by the owning
+ * thread when it runs out of data.  Free lists are never deleted: when
+ * a thread exits, its free list is emptied and handed over to the next
+ * thread which needs one, so that the data still referenced elsewhere
+ * keeps a valid owner.
  */
-#define MAGIC_DESTROYED (~(long)0)
-#define IS_UNINITIALIZED(x) (x == (Buffer::FreeList*)0)
-#define IS_DESTROYED(x) (x == (Buffer::FreeList*)MAGIC_DESTROYED)
-#define IS_INITIALIZED(x) (!IS_UNINITIALIZED(x) && !IS_DESTROYED(x))
-#define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
-#define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList* Buffer::g_freeList = nullptr;
-struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
-
-Buffer::LocalStaticDestructor::~LocalStaticDestructor()
+struct Buffer::FreeList
 {
-    NS_LOG_FUNCTION(this);
-    if (IS_INITIALIZED(g_freeList))
+    FreeList()
+        : m_returned(MAX_SIZE),
+          m_returnedCount(0),
+          m_maxSize(0)
+    {
+    }
+
+    /**
+     * Get the free list of the current thread, creating it if needed.
+     * \returns The free list, or nullptr if the thread is exiting.
+     */
+    static FreeList* Get();
+    /**
+     * Move the data returned by other threads to m_data.
+     */
+    void DrainReturned();
+    /**
+     * Release a data storage allocated by this free list from another thread.
+     * \param data The data storage.
+     */
+    void Return(Buffer::Data* data);
+
+    /** Hand the free list of a thread over to the idle ones when the thread exits. */
+    struct Guard
+    {
+        /** Mark the guard as used, so that it is destroyed at thread exit. */
+        void Attach()
+        {
+        }
+
+        ~Guard();
+    };
+
+    static constexpr uint32_t MAX_SIZE = 1000; //!< Max number of data kept
+
+    std::vector<Buffer::Data*> m_data;     //!< The data ready for reuse
+    MpscQueue<Buffer::Data*> m_returned;   //!< The data released by other threads
+    std::atomic<uint32_t> m_returnedCount; //!< Number of items in m_returned
+    uint32_t m_maxSize;                    //!< Max observed data size
+
+    /**
+     * Get the free lists of the threads which exited, ready to be reused.
+     * \returns The idle free lists.
+     */
+    static std::vector<FreeList*>& GetIdle();
+
+    static std::mutex g_mutex;               //!< Mutex protecting the idle free lists
+    static thread_local FreeList* t_current; //!< Free list of the current thread
+    static thread_local bool t_exited;       //!< Whether the current thread is exiting
+};
+
+std::mutex Buffer::FreeList::g_mutex;
+thread_local Buffer::FreeList* Buffer::FreeList::t_current = nullptr;
+thread_local bool Buffer::FreeList::t_exited = false;
+
+std::vector<Buffer::FreeList*>&
+Buffer::FreeList::GetIdle()
+{
+    // Never deleted: buffers may be released during static destruction.
+    static std::vector<FreeList*>* idle = new std::vector<FreeList*>;
+    return *idle;
+}
+
+Buffer::FreeList*
+Buffer::FreeList::Get()
+{
+    if (t_current == nullptr && !t_exited)
+    {
+        static thread_local Guard guard;
+        guard.Attach();
+        std::unique_lock lock(g_mutex);
+        if (GetIdle().empty())
+        {
+            t_current = new FreeList;
+        }
+        else
+        {
+            t_current = GetIdle().back();
+            GetIdle().pop_back();
+        }
+    }
+    return t_current;
+}
+
+Buffer::FreeList::Guard::~Guard()
+{
+    FreeList* freeList = t_current;
+    t_current = nullptr;
+    t_exited = true;
+    freeList->DrainReturned();
+    for (auto data : freeList->m_data)
     {
-        for (Buffer::FreeList::iterator i = g_freeList->begin(); i != g_freeList->end(); i++)
+        Buffer::Deallocate(data);
+    }
+    freeList->m_data.clear();
+    std::unique_lock lock(g_mutex);
+    GetIdle().push_back(freeList);
+}
+
+void
+Buffer::FreeList::DrainReturned()
+{
+    uint32_t n = m_returned.Drain([this](Buffer::Data* data) {
+        if (data->m_size < m_maxSize || m_data.size() > MAX_SIZE)
+        {
+            Buffer::Deallocate(data);
+        }
+        else
         {
-            Buffer::Deallocate(*i);
+            m_data.push_back(data);
         }
-        delete g_freeList;
-        g_freeList = DESTROYED;
+    });
+    m_returnedCount.fetch_sub(n, std::memory_order_relaxed);
+}
+
+void
+Buffer::FreeList::Return(Buffer::Data* data)
+{
+    if (m_returnedCount.load(std::memory_order_relaxed) > MAX_SIZE)
+    {
+        Buffer::Deallocate(data);
+        return;
     }
+    m_returnedCount.fetch_add(1, std::memory_order_relaxed);
+    m_returned.Push(data);
 }
 
 void
@@ -102,17 +205,28 @@ Buffer::Recycle(struct Buffer::Data* data)
 {
     NS_LOG_FUNCTION(data);
     NS_ASSERT(data->m_count == 0);
-    NS_ASSERT(!IS_UNINITIALIZED(g_freeList));
-    g_maxSize = std::max(g_maxSize, data->m_size);
+    FreeList* freeList = FreeList::Get();
+    if (data->m_freeList != freeList)
+    {
+        if (data->m_freeList == nullptr || freeList == nullptr)
+        {
+            Buffer::Deallocate(data);
+        }
+        else
+        {
+            data->m_freeList->Return(data);
+        }
+        return;
+    }
+    freeList->m_maxSize = std::max(freeList->m_maxSize, data->m_size);
     /* feed into free list */
-    if (data->m_size < g_maxSize || IS_DESTROYED(g_freeList) || g_freeList->size() > 1000)
+    if (data->m_size < freeList->m_maxSize || freeList->m_data.size() > FreeList::MAX_SIZE)
     {
         Buffer::Deallocate(data);
     }
     else
     {
-        NS_ASSERT(IS_INITIALIZED(g_freeList));
-        g_freeList->push_back(data);
+        freeList->m_data.push_back(data);
     }
 }
 
@@ -120,17 +234,19 @@ Buffer::Data*
 Buffer::Create(uint32_t dataSize)
 {
     NS_LOG_FUNCTION(dataSize);
-    /* try to find a buffer correctly sized. */
-    if (IS_UNINITIALIZED(g_freeList))
-    {
-        g_freeList = new Buffer::FreeList();
-    }
-    else if (IS_INITIALIZED(g_freeList))
+    FreeList* freeList = FreeList::Get();
+    if (freeList != nullptr)
     {
-        while (!g_freeList->empty())
+        if (freeList->m_data.empty() &&
+            freeList->m_returnedCount.load(std::memory_order_relaxed) != 0)
         {
-            struct Buffer::Data* data = g_freeList->back();
-            g_freeList->pop_back();
+            freeList->DrainReturned();
+        }
+        /* try to find a buffer correctly sized. */
+        while (!freeList->m_data.empty())
+        {
+            struct Buffer::Data* data = freeList->m_data.back();
+            freeList->m_data.pop_back();
             if (data->m_size >= dataSize)
             {
                 data->m_count = 1;
@@ -141,6 +257,7 @@ Buffer::Create(uint32_t dataSize)
     }
     struct Buffer::Data* data = Buffer::Allocate(dataSize);
     NS_ASSERT(data->m_count == 1);
+    data->m_freeList = freeList;
     return data;
 }
 #else  /* BUFFER_FREE_LIST */
@@ -225,7 +342,7 @@ Buffer::CheckInternalState() const
     m_zeroAreaEnd <= m_end;
   bool dirtyOk =
     m_start >= m_data->m_dirtyStart &&
-    m_end <= m_data->m_dirtyEnd;
+    GetInternalEnd() <= m_data->m_dirtyEnd;
   bool internalSizeOk = m_end - (m_zeroAreaEnd - m_zeroAreaStart) <= m_data->m_size &&
     m_start <= m_data->m_size &&
     m_zeroAreaStart <= m_data->m_size;
@@ -255,7 +372,7 @@ Buffer::Initialize(uint32_t zeroSize)
     m_zeroAreaEnd = m_zeroAreaStart + zeroSize;
     m_end = m_zeroAreaEnd;
     m_data->m_dirtyStart = m_start;
-    m_data->m_dirtyEnd = m_end;
+    m_data->m_dirtyEnd = GetInternalEnd();
     NS_ASSERT(CheckInternalState());
 }
 
@@ -280,6 +397,14 @@ Buffer::operator=(const Buffer& o)
     m_zeroAreaEnd = o.m_zeroAreaEnd;
     m_start = o.m_start;
     m_end = o.m_end;
+    // o might be one of our own fragments: copy it before releasing the chain.
+    struct Buffer::Chain* chain = o.m_chain;
+    if (chain != nullptr)
+    {
+        chain->m_count++;
+    }
+    ReleaseChain();
+    m_chain = chain;
     NS_ASSERT(CheckInternalState());
     return *this;
 }
@@ -289,6 +414,7 @@ Buffer::~Buffer()
     NS_LOG_FUNCTION(this);
     NS_ASSERT(CheckInternalState());
     g_recommendedStart = std::max(g_recommendedStart, m_maxZeroAreaStart);
+    ReleaseChain();
     m_data->m_count--;
     if (m_data->m_count == 0)
     {
@@ -296,6 +422,102 @@ Buffer::~Buffer()
     }
 }
 
+void
+Buffer::ReleaseChain()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_chain != nullptr)
+    {
+        m_chain->m_count--;
+        if (m_chain->m_count == 0)
+        {
+            delete m_chain;
+        }
+        m_chain = nullptr;
+    }
+}
+
+void
+Buffer::PrepareChainWrite()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_chain != nullptr);
+    if (m_chain->m_count > 1)
+    {
+        m_chain->m_count--;
+        m_chain = new Buffer::Chain(*m_chain);
+        m_chain->m_count = 1;
+    }
+}
+
+Buffer
+Buffer::GetHead() const
+{
+    NS_LOG_FUNCTION(this);
+    Buffer head = *this;
+    head.ReleaseChain();
+    return head;
+}
+
+void
+Buffer::SetHead(const Buffer& head)
+{
+    NS_LOG_FUNCTION(this << &head);
+    NS_ASSERT(head.m_chain == nullptr);
+    // head might be one of our own fragments: keep the chain out of the way.
+    struct Buffer::Chain* chain = m_chain;
+    m_chain = nullptr;
+    *this = head;
+    m_chain = chain;
+}
+
+void
+Buffer::Flatten() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_chain != nullptr);
+    bool hasZeroArea = m_zeroAreaEnd != m_zeroAreaStart;
+    for (const auto& fragment : m_chain->m_fragments)
+    {
+        hasZeroArea = hasZeroArea || fragment.m_zeroAreaEnd != fragment.m_zeroAreaStart;
+    }
+    if (hasZeroArea)
+    {
+        /* Append the fragments one by one to keep the zero
+         * areas which can be merged virtual.
+         */
+        Buffer tmp = GetHead();
+        for (const auto& fragment : m_chain->m_fragments)
+        {
+            tmp.AppendContiguous(fragment);
+        }
+        *const_cast<Buffer*>(this) = tmp;
+        return;
+    }
+    /* Only real bytes: copy them all at once, keeping room
+     * in front of them for the headers to come.
+     */
+    uint32_t size = GetSize();
+    Buffer tmp(0, false);
+    tmp.m_start = std::min(m_data->m_size, g_recommendedStart);
+    tmp.m_data = Buffer::Create(tmp.m_start + size);
+    tmp.m_maxZeroAreaStart = tmp.m_start;
+    tmp.m_zeroAreaStart = tmp.m_start;
+    tmp.m_zeroAreaEnd = tmp.m_start;
+    tmp.m_end = tmp.m_start + size;
+    tmp.m_data->m_dirtyStart = tmp.m_start;
+    tmp.m_data->m_dirtyEnd = tmp.m_end;
+    CopyData(tmp.m_data->m_data + tmp.m_start, size);
+    *const_cast<Buffer*>(this) = tmp;
+}
+
+uint32_t
+Buffer::GetFragmentCount() const
+{
+    NS_LOG_FUNCTION(this);
+    return 1 + (m_chain == nullptr ? 0 : m_chain->m_fragments.size());
+}
+
 uint32_t
 Buffer::GetInternalSize() const
 {
@@ -315,6 +537,11 @@ Buffer::AddAtStart(uint32_t start)
 {
     NS_LOG_FUNCTION(this << start);
     NS_ASSERT(CheckInternalState());
+    if (m_chain != nullptr)
+    {
+        // the new bytes will be written through an iterator anyway.
+        Flatten();
+    }
     bool isDirty = m_data->m_count > 1 && m_start > m_data->m_dirtyStart;
     if (m_start >= start && !isDirty)
     {
@@ -349,7 +576,7 @@ Buffer::AddAtStart(uint32_t start)
 
         // update dirty area
         m_data->m_dirtyStart = m_start;
-        m_data->m_dirtyEnd = m_end;
+        m_data->m_dirtyEnd = GetInternalEnd();
     }
     m_maxZeroAreaStart = std::max(m_maxZeroAreaStart, m_zeroAreaStart);
     LOG_INTERNAL_STATE("add start=" << start << ", ");
@@ -361,7 +588,12 @@ Buffer::AddAtEnd(uint32_t end)
 {
     NS_LOG_FUNCTION(this << end);
     NS_ASSERT(CheckInternalState());
-    bool isDirty = m_data->m_count > 1 && m_end < m_data->m_dirtyEnd;
+    if (m_chain != nullptr)
+    {
+        // the new bytes will be written through an iterator anyway.
+        Flatten();
+    }
+    bool isDirty = m_data->m_count > 1 && GetInternalEnd() < m_data->m_dirtyEnd;
     if (GetInternalEnd() + end <= m_data->m_size && !isDirty)
     {
         /* enough space in buffer and not dirty
@@ -369,10 +601,10 @@ Buffer::AddAtEnd(uint32_t end)
          * Before: |**----*****|
          * After:  |**----...**|
          */
-        NS_ASSERT(m_data->m_count == 1 || m_end == m_data->m_dirtyEnd);
+        NS_ASSERT(m_data->m_count == 1 || GetInternalEnd() == m_data->m_dirtyEnd);
         m_end += end;
         // update dirty area.
-        m_data->m_dirtyEnd = m_end;
+        m_data->m_dirtyEnd = GetInternalEnd();
     }
     else
     {
@@ -395,21 +627,87 @@ Buffer::AddAtEnd(uint32_t end)
 
         // update dirty area
         m_data->m_dirtyStart = m_start;
-        m_data->m_dirtyEnd = m_end;
+        m_data->m_dirtyEnd = GetInternalEnd();
     }
     m_maxZeroAreaStart = std::max(m_maxZeroAreaStart, m_zeroAreaStart);
     LOG_INTERNAL_STATE("add end=" << end << ", ");
     NS_ASSERT(CheckInternalState());
 }
 
+/**
+ * Smallest buffer appended by reference rather than copied. Below this
+ * size, copying the bytes is cheaper than managing an additional fragment.
+ */
+constexpr uint32_t CHAIN_MIN_SIZE = 1024;
+
 void
 Buffer::AddAtEnd(const Buffer& o)
 {
     NS_LOG_FUNCTION(this << &o);
+    NS_ASSERT(CheckInternalState());
+
+    if (o.m_chain != nullptr)
+    {
+        // keep the fragments of o alive, in case o is this buffer.
+        Buffer tail = o;
+        AddAtEnd(tail.GetHead());
+        for (const auto& fragment : tail.m_chain->m_fragments)
+        {
+            AddAtEnd(fragment);
+        }
+        return;
+    }
 
-    if (m_data->m_count == 1 && (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
-        m_end == m_data->m_dirtyEnd && o.m_start == o.m_zeroAreaStart &&
-        o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
+    uint32_t size = o.GetSize();
+    if (m_chain != nullptr)
+    {
+        PrepareChainWrite();
+        if (size < CHAIN_MIN_SIZE)
+        {
+            m_chain->m_fragments.back().AppendContiguous(o);
+        }
+        else
+        {
+            m_chain->m_fragments.push_back(o);
+        }
+        m_chain->m_size += size;
+    }
+    else if (size < CHAIN_MIN_SIZE || CanMergeZeroArea(o))
+    {
+        AppendContiguous(o);
+    }
+    else if (GetSize() == 0)
+    {
+        *this = o;
+    }
+    else
+    {
+        Buffer fragment = o;
+        m_chain = new Buffer::Chain();
+        m_chain->m_count = 1;
+        m_chain->m_size = size;
+        m_chain->m_fragments.push_back(fragment);
+    }
+    NS_ASSERT(CheckInternalState());
+}
+
+bool
+Buffer::CanMergeZeroArea(const Buffer& o) const
+{
+    NS_LOG_FUNCTION(this << &o);
+    return m_data->m_count == 1 &&
+           (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
+           GetInternalEnd() == m_data->m_dirtyEnd && o.m_start == o.m_zeroAreaStart &&
+           o.m_zeroAreaEnd - o.m_zeroAreaStart > 0;
+}
+
+void
+Buffer::AppendContiguous(const Buffer& o)
+{
+    NS_LOG_FUNCTION(this << &o);
+    NS_ASSERT(m_chain == nullptr && o.m_chain == nullptr);
+
+    if (CanMergeZeroArea(o))
     {
         /**
          * This is an optimization which kicks in when
@@ -423,7 +721,6 @@ Buffer::AddAtEnd(const Buffer& o)
         uint32_t zeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
         m_zeroAreaEnd = m_end + zeroSize;
         m_end = m_zeroAreaEnd;
-        m_data->m_dirtyEnd = m_zeroAreaEnd;
         uint32_t endData = o.m_end - o.m_zeroAreaEnd;
         AddAtEnd(endData);
         Buffer::Iterator dst = End();
@@ -448,6 +745,42 @@ Buffer::RemoveAtStart(uint32_t start)
 {
     NS_LOG_FUNCTION(this << start);
     NS_ASSERT(CheckInternalState());
+    if (m_chain != nullptr && start >= GetSize())
+    {
+        ReleaseChain();
+    }
+    else if (m_chain != nullptr && m_chain->m_count > 1)
+    {
+        /* do not copy the fragments which are removed.
+         */
+        *this = CreateFragment(start, GetSize() - start);
+        return;
+    }
+    else if (m_chain != nullptr && start >= m_end - m_start)
+    {
+        /* remove the contiguous data and the first fragments,
+         * the next fragment becomes the contiguous data.
+         */
+        start -= m_end - m_start;
+        std::vector<Buffer>& fragments = m_chain->m_fragments;
+        auto i = fragments.begin();
+        while (start >= i->GetSize())
+        {
+            start -= i->GetSize();
+            m_chain->m_size -= i->GetSize();
+            i++;
+        }
+        Buffer head = *i;
+        m_chain->m_size -= head.GetSize();
+        head.RemoveAtStart(start);
+        fragments.erase(fragments.begin(), i + 1);
+        SetHead(head);
+        if (fragments.empty())
+        {
+            ReleaseChain();
+        }
+        return;
+    }
     uint32_t newStart = m_start + start;
     if (newStart <= m_zeroAreaStart)
     {
@@ -494,6 +827,43 @@ Buffer::RemoveAtEnd(uint32_t end)
 {
     NS_LOG_FUNCTION(this << end);
     NS_ASSERT(CheckInternalState());
+    if (m_chain != nullptr && m_chain->m_count > 1)
+    {
+        /* do not copy the fragments which are removed.
+         */
+        *this = CreateFragment(0, GetSize() - std::min(end, GetSize()));
+        return;
+    }
+    if (m_chain != nullptr)
+    {
+        /* remove or trim the last fragments first.
+         */
+        std::vector<Buffer>& fragments = m_chain->m_fragments;
+        while (end > 0 && !fragments.empty())
+        {
+            uint32_t size = fragments.back().GetSize();
+            if (end < size)
+            {
+                fragments.back().RemoveAtEnd(end);
+                m_chain->m_size -= end;
+                end = 0;
+            }
+            else
+            {
+                fragments.pop_back();
+                m_chain->m_size -= size;
+                end -= size;
+            }
+        }
+        if (fragments.empty())
+        {
+            ReleaseChain();
+        }
+        if (end == 0)
+        {
+            return;
+        }
+    }
     uint32_t newEnd = m_end - std::min(end, m_end - m_start);
     if (newEnd > m_zeroAreaEnd)
     {
@@ -530,6 +900,10 @@ Buffer::CreateFragment(uint32_t start, uint32_t length) const
 {
     NS_LOG_FUNCTION(this << start << length);
     NS_ASSERT(CheckInternalState());
+    if (m_chain != nullptr)
+    {
+        return CreateChainFragment(start, length);
+    }
     Buffer tmp = *this;
     tmp.RemoveAtStart(start);
     tmp.RemoveAtEnd(GetSize() - (start + length));
@@ -537,11 +911,60 @@ Buffer::CreateFragment(uint32_t start, uint32_t length) const
     return tmp;
 }
 
+Buffer
+Buffer::CreateChainFragment(uint32_t start, uint32_t length) const
+{
+    NS_LOG_FUNCTION(this << start << length);
+    NS_ASSERT(m_chain != nullptr && start + length <= GetSize());
+    /* Reference only the fragments which overlap the requested
+     * range, trimming the first and the last ones.
+     */
+    Buffer tmp = GetHead();
+    auto i = m_chain->m_fragments.begin();
+    if (start >= tmp.GetSize())
+    {
+        start -= tmp.GetSize();
+        while (start >= i->GetSize())
+        {
+            start -= i->GetSize();
+            i++;
+        }
+        tmp = *i;
+        i++;
+    }
+    tmp.RemoveAtStart(start);
+    if (length <= tmp.GetSize())
+    {
+        tmp.RemoveAtEnd(tmp.GetSize() - length);
+        return tmp;
+    }
+    length -= tmp.GetSize();
+    tmp.m_chain = new Buffer::Chain();
+    tmp.m_chain->m_count = 1;
+    tmp.m_chain->m_size = length;
+    while (length > 0)
+    {
+        tmp.m_chain->m_fragments.push_back(*i);
+        Buffer& fragment = tmp.m_chain->m_fragments.back();
+        if (length < fragment.GetSize())
+        {
+            fragment.RemoveAtEnd(fragment.GetSize() - length);
+        }
+        length -= fragment.GetSize();
+        i++;
+    }
+    return tmp;
+}
+
 Buffer
 Buffer::CreateFullCopy() const
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(CheckInternalState());
+    if (m_chain != nullptr)
+    {
+        Flatten();
+    }
     if (m_zeroAreaEnd - m_zeroAreaStart != 0)
     {
         Buffer tmp;
@@ -566,6 +989,10 @@ uint32_t
 Buffer::GetSerializedSize() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_chain != nullptr)
+    {
+        Flatten();
+    }
     uint32_t dataStart = (m_zeroAreaStart - m_start + 3) & (~0x3);
     uint32_t dataEnd = (m_end - m_zeroAreaEnd + 3) & (~0x3);
 
@@ -582,6 +1009,10 @@ uint32_t
 Buffer::Serialize(uint8_t* buffer, uint32_t maxSize) const
 {
     NS_LOG_FUNCTION(this << &buffer << maxSize);
+    if (m_chain != nullptr)
+    {
+        Flatten();
+    }
     uint32_t* p = reinterpret_cast<uint32_t*>(buffer);
     uint32_t size = 0;
 
@@ -719,6 +1150,19 @@ void
 Buffer::CopyData(std::ostream* os, uint32_t size) const
 {
     NS_LOG_FUNCTION(this << &os << size);
+    if (m_chain != nullptr)
+    {
+        uint32_t tmpsize = std::min(m_end - m_start, size);
+        GetHead().CopyData(os, tmpsize);
+        size -= tmpsize;
+        for (const auto& fragment : m_chain->m_fragments)
+        {
+            tmpsize = std::min(fragment.GetSize(), size);
+            fragment.CopyData(os, tmpsize);
+            size -= tmpsize;
+        }
+        return;
+    }
     if (size > 0)
     {
         uint32_t tmpsize = std::min(m_zeroAreaStart - m_start, size);
@@ -748,6 +1192,15 @@ uint32_t
 Buffer::CopyData(uint8_t* buffer, uint32_t size) const
 {
     NS_LOG_FUNCTION(this << &buffer << size);
+    if (m_chain != nullptr)
+    {
+        uint32_t copied = GetHead().CopyData(buffer, size);
+        for (const auto& fragment : m_chain->m_fragments)
+        {
+            copied += fragment.CopyData(buffer + copied, size - copied);
+        }
+        return copied;
+    }
     uint32_t originalSize = size;
     if (size > 0)
     {
@@ -838,27 +1291,36 @@ Buffer::Iterator::Write(Iterator start, Iterator end)
     NS_ASSERT(m_data != start.m_data);
     uint32_t size = end.m_current - start.m_current;
     NS_ASSERT_MSG(CheckNoZero(m_current, m_current + size), GetWriteErrorMessage());
+    // the destination may be after our own zero area.
+    uint8_t* to;
+    if (m_current <= m_zeroStart)
+    {
+        to = &m_data[m_current];
+    }
+    else
+    {
+        to = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
+    }
+    m_current += size;
     if (start.m_current <= start.m_zeroStart)
     {
         uint32_t toCopy = std::min(size, start.m_zeroStart - start.m_current);
-        memcpy(&m_data[m_current], &start.m_data[start.m_current], toCopy);
+        memcpy(to, &start.m_data[start.m_current], toCopy);
         start.m_current += toCopy;
-        m_current += toCopy;
+        to += toCopy;
         size -= toCopy;
     }
     if (start.m_current <= start.m_zeroEnd)
     {
         uint32_t toCopy = std::min(size, start.m_zeroEnd - start.m_current);
-        memset(&m_data[m_current], 0, toCopy);
+        memset(to, 0, toCopy);
         start.m_current += toCopy;
-        m_current += toCopy;
+        to += toCopy;
         size -= toCopy;
     }
     uint32_t toCopy = std::min(size, start.m_dataEnd - start.m_current);
     uint8_t* from = &start.m_data[start.m_current - (start.m_zeroEnd - start.m_zeroStart)];
-    uint8_t* to = &m_data[m_current];
     memcpy(to, from, toCopy);
-    m_current += toCopy;
 }
 
 void
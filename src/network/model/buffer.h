@@ -89,6 +89,16 @@ namespace ns3
  * \endverbatim
  *
  * A simple state invariant is that m_start <= m_zeroStart <= m_zeroEnd <= m_end
+ *
+ * A Buffer can also be a chain of fragments: when a large Buffer is
+ * appended with AddAtEnd (const Buffer &), it is not copied but a
+ * reference to it is added to a list of fragments, the Buffer::Chain,
+ * which follows the contiguous data described above. The chain is
+ * shared among copies of the Buffer, and copied before being modified.
+ * Removing bytes at the start or the end of a chain only drops or trims
+ * fragments, so that CreateFragment never copies bytes either. The
+ * fragments are merged into a single contiguous buffer only when the
+ * bytes must be accessed through an Iterator or PeekData.
  */
 class Buffer
 {
@@ -525,7 +535,8 @@ class Buffer
     /**
      * \param o the buffer to append to the end of this buffer.
      *
-     * Add bytes at the end of the Buffer.
+     * Add bytes at the end of the Buffer. Large buffers are not
+     * copied but referenced as an additional fragment.
      * Any call to this method invalidates any Iterator
      * pointing to this Buffer.
      */
@@ -556,6 +567,14 @@ class Buffer
      */
     Buffer CreateFragment(uint32_t start, uint32_t length) const;
 
+    /**
+     * \return the number of contiguous fragments of this buffer.
+     *
+     * A buffer which was never appended a large buffer has a single
+     * fragment. Creating an Iterator merges all the fragments.
+     */
+    uint32_t GetFragmentCount() const;
+
     /**
      * \return an Iterator which points to the
      * start of this Buffer.
@@ -659,6 +678,10 @@ class Buffer
      * area" if the reference count is higher than 1 (that is, if
      * more than one Buffer instance references the same BufferData).
      */
+#ifdef BUFFER_FREE_LIST
+    struct FreeList; //!< Forward declaration
+#endif
+
     struct Data
     {
         /**
@@ -680,6 +703,13 @@ class Buffer
          * end of the area in which user bytes were written.
          */
         uint32_t m_dirtyEnd;
+#ifdef BUFFER_FREE_LIST
+        /**
+         * The free list of the thread which allocated this instance,
+         * to which it is returned when it is no longer referenced.
+         */
+        struct FreeList* m_freeList;
+#endif
         /**
          * The real data buffer holds _at least_ one byte.
          * Its real size is stored in the m_size field.
@@ -699,6 +729,46 @@ class Buffer
      * \brief Transform a "Virtual byte buffer" into a "Real byte buffer"
      */
     void TransformIntoRealBuffer() const;
+    /**
+     * \brief Merge the fragments of the chain into a single contiguous buffer.
+     */
+    void Flatten() const;
+    /**
+     * \brief Create a fragment of a chain.
+     * \param start offset from the start of the buffer
+     * \param length the size of the fragment
+     * \returns a buffer referencing the fragments which overlap the range.
+     */
+    Buffer CreateChainFragment(uint32_t start, uint32_t length) const;
+    /**
+     * \brief Get the contiguous data in front of the chain.
+     * \returns a buffer sharing the contiguous data, without the chain.
+     */
+    Buffer GetHead() const;
+    /**
+     * \brief Replace the contiguous data in front of the chain.
+     * \param head the new contiguous data, which must not be a chain.
+     */
+    void SetHead(const Buffer& head);
+    /**
+     * \brief Drop the reference to the chain, if any.
+     */
+    void ReleaseChain();
+    /**
+     * \brief Make sure the chain is not shared before modifying it.
+     */
+    void PrepareChainWrite();
+    /**
+     * \brief Check whether appending a buffer can extend our zero area.
+     * \param o the buffer to append, which must not be a chain.
+     * \returns true if the zero area of o is adjacent to our own one.
+     */
+    bool CanMergeZeroArea(const Buffer& o) const;
+    /**
+     * \brief Copy a buffer at the end of the contiguous data.
+     * \param o the buffer to append, which must not be a chain.
+     */
+    void AppendContiguous(const Buffer& o);
     /**
      * \brief Checks the internal buffer structures consistency
      *
@@ -767,9 +837,9 @@ class Buffer
     /**
      * location in a newly-allocated buffer where you should start
      * writing data. i.e., m_start should be initialized to this
-     * value.
+     * value. Each thread keeps its own value.
      */
-    static uint32_t g_recommendedStart;
+    static thread_local uint32_t g_recommendedStart;
 
     /**
      * offset to the start of the virtual zero area from the start
@@ -792,20 +862,27 @@ class Buffer
      */
     uint32_t m_end;
 
-#ifdef BUFFER_FREE_LIST
-    /// Container for buffer data
-    typedef std::vector<struct Buffer::Data*> FreeList;
-
-    /// Local static destructor structure
-    struct LocalStaticDestructor
-    {
-        ~LocalStaticDestructor();
-    };
+    struct Chain;                   //!< Forward declaration
+    struct Chain* m_chain{nullptr}; //!< the fragments following m_data, if any
+};
 
-    static uint32_t g_maxSize;                            //!< Max observed data size
-    static FreeList* g_freeList;                          //!< Buffer data container
-    static LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
-#endif
+/**
+ * \brief the fragments following the contiguous data of a Buffer
+ */
+struct Buffer::Chain
+{
+    /**
+     * The number of Buffer instances referencing this chain.
+     */
+    uint32_t m_count;
+    /**
+     * The total size of the fragments.
+     */
+    uint32_t m_size;
+    /**
+     * The fragments, none of which is a chain itself.
+     */
+    std::vector<Buffer> m_fragments;
 };
 
 } // namespace ns3
@@ -1058,22 +1135,31 @@ Buffer::Buffer(const Buffer& o)
       m_zeroAreaStart(o.m_zeroAreaStart),
       m_zeroAreaEnd(o.m_zeroAreaEnd),
       m_start(o.m_start),
-      m_end(o.m_end)
+      m_end(o.m_end),
+      m_chain(o.m_chain)
 {
     m_data->m_count++;
+    if (m_chain != nullptr)
+    {
+        m_chain->m_count++;
+    }
     NS_ASSERT(CheckInternalState());
 }
 
 uint32_t
 Buffer::GetSize() const
 {
-    return m_end - m_start;
+    return m_end - m_start + (m_chain == nullptr ? 0 : m_chain->m_size);
 }
 
 Buffer::Iterator
 Buffer::Begin() const
 {
     NS_ASSERT(CheckInternalState());
+    if (m_chain != nullptr)
+    {
+        Flatten();
+    }
     return Buffer::Iterator(this);
 }
 
@@ -1081,6 +1167,10 @@ Buffer::Iterator
 Buffer::End() const
 {
     NS_ASSERT(CheckInternalState());
+    if (m_chain != nullptr)
+    {
+        Flatten();
+    }
     return Buffer::Iterator(this, false);
 }
 
@@ -54,15 +54,18 @@ struct ByteTagListData
  *
  * \brief Container class for struct ByteTagListData
  *
- * Internal use only.
+ * Internal use only.  Each thread keeps its own free list.
  */
-static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData*>
+static thread_local class ByteTagListDataFreeList : public std::vector<struct ByteTagListData*>
 {
   public:
     ~ByteTagListDataFreeList();
 } g_freeList; //!< Container for struct ByteTagListData
 
-static uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+static thread_local uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+
+/** Whether g_freeList was destroyed because the thread is exiting. */
+static thread_local bool g_freeListDestroyed = false;
 
 ByteTagListDataFreeList::~ByteTagListDataFreeList()
 {
@@ -72,6 +75,7 @@ ByteTagListDataFreeList::~ByteTagListDataFreeList()
         uint8_t* buffer = (uint8_t*)(*i);
         delete[] buffer;
     }
+    g_freeListDestroyed = true;
 }
 #endif /* USE_FREE_LIST */
 
@@ -355,7 +359,7 @@ struct ByteTagListData*
 ByteTagList::Allocate(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
-    while (!g_freeList.empty())
+    while (!g_freeListDestroyed && !g_freeList.empty())
     {
         struct ByteTagListData* data = g_freeList.back();
         g_freeList.pop_back();
@@ -389,7 +393,7 @@ ByteTagList::Deallocate(struct ByteTagListData* data)
     data->count--;
     if (data->count == 0)
     {
-        if (g_freeList.size() > FREE_LIST_SIZE || data->size < g_maxSize)
+        if (g_freeListDestroyed || g_freeList.size() > FREE_LIST_SIZE || data->size < g_maxSize)
         {
             uint8_t* buffer = (uint8_t*)data;
             delete[] buffer;
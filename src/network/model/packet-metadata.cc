@@ -25,8 +25,12 @@
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/mpsc-queue.h"
 
+#include <atomic>
 #include <list>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
 
 namespace ns3
@@ -37,18 +41,290 @@ NS_LOG_COMPONENT_DEFINE("PacketMetadata");
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
-uint32_t PacketMetadata::m_maxSize = 0;
-uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+bool PacketMetadata::m_compact = false;
+thread_local uint16_t PacketMetadata::m_chunkUid = 0;
 
-PacketMetadata::DataFreeList::~DataFreeList()
+/**
+ * \brief The metadata storage recycled by a thread.
+ *
+ * As Buffer does for its data, each thread reuses the metadata storage
+ * it allocated without taking any lock, and the storage released by
+ * other threads is handed back through a lock-free queue.  Free lists
+ * are never deleted: when a thread exits, its free list is emptied and
+ * handed over to the next thread which needs one.
+ */
+struct PacketMetadata::FreeList
+{
+    FreeList()
+        : m_returned(MAX_SIZE),
+          m_returnedCount(0),
+          m_maxSize(0)
+    {
+    }
+
+    /**
+     * Get the free list of the current thread, creating it if needed.
+     * \returns The free list, or nullptr if the thread is exiting.
+     */
+    static FreeList* Get();
+    /**
+     * Move the storage returned by other threads to m_data.
+     */
+    void DrainReturned();
+    /**
+     * Release a storage allocated by this free list from another thread.
+     * \param data The storage.
+     */
+    void Return(PacketMetadata::Data* data);
+
+    /** Hand the free list of a thread over to the idle ones when the thread exits. */
+    struct Guard
+    {
+        /** Mark the guard as used, so that it is destroyed at thread exit. */
+        void Attach()
+        {
+        }
+
+        ~Guard();
+    };
+
+    /**
+     * Get the free lists of the threads which exited, ready to be reused.
+     * \returns The idle free lists.
+     */
+    static std::vector<FreeList*>& GetIdle();
+
+    static constexpr uint32_t MAX_SIZE = 1000; //!< Max number of storages kept
+
+    std::vector<PacketMetadata::Data*> m_data;   //!< The storage ready for reuse
+    MpscQueue<PacketMetadata::Data*> m_returned; //!< The storage released by other threads
+    std::atomic<uint32_t> m_returnedCount;       //!< Number of items in m_returned
+    uint32_t m_maxSize;                          //!< maximum metadata size
+
+    static std::mutex g_mutex;               //!< Mutex protecting the idle free lists
+    static thread_local FreeList* t_current; //!< Free list of the current thread
+    static thread_local bool t_exited;       //!< Whether the current thread is exiting
+};
+
+std::mutex PacketMetadata::FreeList::g_mutex;
+thread_local PacketMetadata::FreeList* PacketMetadata::FreeList::t_current = nullptr;
+thread_local bool PacketMetadata::FreeList::t_exited = false;
+
+std::vector<PacketMetadata::FreeList*>&
+PacketMetadata::FreeList::GetIdle()
+{
+    // Never deleted: packets may be released during static destruction.
+    static std::vector<FreeList*>* idle = new std::vector<FreeList*>;
+    return *idle;
+}
+
+PacketMetadata::FreeList*
+PacketMetadata::FreeList::Get()
+{
+    if (t_current == nullptr && !t_exited)
+    {
+        static thread_local Guard guard;
+        guard.Attach();
+        std::unique_lock lock(g_mutex);
+        if (GetIdle().empty())
+        {
+            t_current = new FreeList;
+        }
+        else
+        {
+            t_current = GetIdle().back();
+            GetIdle().pop_back();
+        }
+    }
+    return t_current;
+}
+
+PacketMetadata::FreeList::Guard::~Guard()
+{
+    FreeList* freeList = t_current;
+    t_current = nullptr;
+    t_exited = true;
+    freeList->DrainReturned();
+    for (auto data : freeList->m_data)
+    {
+        PacketMetadata::Deallocate(data);
+    }
+    freeList->m_data.clear();
+    std::unique_lock lock(g_mutex);
+    GetIdle().push_back(freeList);
+}
+
+void
+PacketMetadata::FreeList::DrainReturned()
 {
+    uint32_t n = m_returned.Drain([this](PacketMetadata::Data* data) {
+        if (data->m_size < m_maxSize || m_data.size() > MAX_SIZE)
+        {
+            PacketMetadata::Deallocate(data);
+        }
+        else
+        {
+            m_data.push_back(data);
+        }
+    });
+    m_returnedCount.fetch_sub(n, std::memory_order_relaxed);
+}
+
+void
+PacketMetadata::FreeList::Return(PacketMetadata::Data* data)
+{
+    if (m_returnedCount.load(std::memory_order_relaxed) > MAX_SIZE)
+    {
+        PacketMetadata::Deallocate(data);
+        return;
+    }
+    m_returnedCount.fetch_add(1, std::memory_order_relaxed);
+    m_returned.Push(data);
+}
+
+/**
+ * \brief An interned item of the compact encoding.
+ *
+ * Items are immutable and never deleted, so that any number of packets,
+ * in any thread, can share them without reference counting.
+ */
+struct PacketMetadata::Template
+{
+    const Template* m_parent; //!< The item below this one, or nullptr
+    uint32_t m_typeUid;       //!< The type uid, zero for payload
+    uint32_t m_size;          //!< The size of the item
+    uint16_t m_chunkUid;      //!< The chunk uid of the item, once expanded
+};
+
+namespace
+{
+
+/**
+ * \ingroup packet
+ * \brief The fields identifying an interned item of the compact encoding.
+ */
+struct TemplateKey
+{
+    const void* parent; //!< The item below
+    uint32_t uid;       //!< The type uid
+    uint32_t size;      //!< The size
+
+    /**
+     * \param [in] o The other key.
+     * \returns true if both keys are equal.
+     */
+    bool operator==(const TemplateKey& o) const
+    {
+        return parent == o.parent && uid == o.uid && size == o.size;
+    }
+};
+
+/**
+ * \ingroup packet
+ * \brief Hash of a TemplateKey.
+ */
+struct TemplateKeyHash
+{
+    /**
+     * \param [in] key The key.
+     * \returns The hash of the key.
+     */
+    std::size_t operator()(const TemplateKey& key) const
+    {
+        std::size_t h = std::hash<const void*>()(key.parent);
+        h = h * 31 + key.uid;
+        h = h * 31 + key.size;
+        return h;
+    }
+};
+
+} // namespace
+
+const PacketMetadata::Template*
+PacketMetadata::Intern(const Template* parent, uint32_t uid, uint32_t size)
+{
+    NS_LOG_FUNCTION(parent << uid << size);
+    // Most lookups are served without a lock by a small cache per thread.
+    static const uint32_t CACHE_SIZE = 256;
+    static thread_local const Template* cache[CACHE_SIZE] = {};
+    TemplateKey key = {parent, uid, size};
+    const Template*& entry = cache[TemplateKeyHash()(key) % CACHE_SIZE];
+    if (entry != nullptr && entry->m_parent == parent && entry->m_typeUid == uid &&
+        entry->m_size == size)
+    {
+        return entry;
+    }
+
+    // Bound the memory used by the items, which are never deleted.
+    static const std::size_t MAX_TEMPLATES = 1 << 16;
+    // Never deleted: packets may be released during static destruction.
+    static std::mutex* mutex = new std::mutex;
+    static auto table = new std::unordered_map<TemplateKey, Template*, TemplateKeyHash>;
+    static uint16_t chunkUid = 0;
+    std::unique_lock lock(*mutex);
+    auto i = table->find(key);
+    if (i == table->end())
+    {
+        if (table->size() >= MAX_TEMPLATES)
+        {
+            return nullptr;
+        }
+        i = table->emplace(key, new Template{parent, uid, size, chunkUid++}).first;
+    }
+    entry = i->second;
+    return entry;
+}
+
+void
+PacketMetadata::Expand() const
+{
+    if (m_data != nullptr)
+    {
+        return;
+    }
     NS_LOG_FUNCTION(this);
-    for (iterator i = begin(); i != end(); i++)
+    auto self = const_cast<PacketMetadata*>(this);
+    self->m_data = PacketMetadata::Create(10);
+    memset(m_data->m_data, 0xff, 4);
+    NS_ASSERT(m_head == 0xffff && m_tail == 0xffff && m_used == 0);
+
+    std::vector<const Template*> items;
+    for (const Template* i = m_headers; i != nullptr; i = i->m_parent)
+    {
+        items.push_back(i);
+    }
+    // Push the headers from the innermost one.
+    for (auto i = items.rbegin(); i != items.rend(); ++i)
+    {
+        struct PacketMetadata::SmallItem item;
+        item.next = m_head;
+        item.prev = 0xffff;
+        item.typeUid = (*i)->m_typeUid;
+        item.size = (*i)->m_size;
+        item.chunkUid = (*i)->m_chunkUid;
+        uint16_t written = self->AddSmall(&item);
+        self->UpdateHead(written);
+    }
+    items.clear();
+    for (const Template* i = m_trailers; i != nullptr; i = i->m_parent)
     {
-        PacketMetadata::Deallocate(*i);
+        items.push_back(i);
     }
-    PacketMetadata::m_enable = false;
+    // Append the trailers from the innermost one.
+    for (auto i = items.rbegin(); i != items.rend(); ++i)
+    {
+        struct PacketMetadata::SmallItem item;
+        item.next = 0xffff;
+        item.prev = m_tail;
+        item.typeUid = (*i)->m_typeUid;
+        item.size = (*i)->m_size;
+        item.chunkUid = (*i)->m_chunkUid;
+        uint16_t written = self->AddSmall(&item);
+        self->UpdateTail(written);
+    }
+    self->m_headers = nullptr;
+    self->m_trailers = nullptr;
+    NS_ASSERT(IsStateOk());
 }
 
 void
@@ -73,6 +349,20 @@ PacketMetadata::EnableChecking()
     m_enableChecking = true;
 }
 
+void
+PacketMetadata::SetCompact(bool compact)
+{
+    NS_LOG_FUNCTION(compact);
+    m_compact = compact;
+}
+
+bool
+PacketMetadata::IsCompact() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_data == nullptr;
+}
+
 void
 PacketMetadata::ReserveCopy(uint32_t size)
 {
@@ -136,6 +426,10 @@ bool
 PacketMetadata::IsStateOk() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_data == nullptr)
+    {
+        return true;
+    }
     bool ok = m_used <= m_data->m_size;
     ok &= IsPointerOk(m_head);
     ok &= IsPointerOk(m_tail);
@@ -504,6 +798,7 @@ PacketMetadata::ReplaceTail(PacketMetadata::SmallItem* item,
 
     // create a copy of the packet without its tail.
     PacketMetadata h(m_packetUid, 0);
+    h.Expand();
     uint16_t current = m_head;
     while (current != 0xffff && current != m_tail)
     {
@@ -567,15 +862,26 @@ struct PacketMetadata::Data*
 PacketMetadata::Create(uint32_t size)
 {
     NS_LOG_FUNCTION(size);
-    NS_LOG_LOGIC("create size=" << size << ", max=" << m_maxSize);
-    if (size > m_maxSize)
+    FreeList* freeList = FreeList::Get();
+    if (freeList == nullptr)
+    {
+        struct PacketMetadata::Data* data = PacketMetadata::Allocate(size);
+        data->m_freeList = nullptr;
+        return data;
+    }
+    NS_LOG_LOGIC("create size=" << size << ", max=" << freeList->m_maxSize);
+    if (size > freeList->m_maxSize)
+    {
+        freeList->m_maxSize = size;
+    }
+    if (freeList->m_data.empty() && freeList->m_returnedCount.load(std::memory_order_relaxed) != 0)
     {
-        m_maxSize = size;
+        freeList->DrainReturned();
     }
-    while (!m_freeList.empty())
+    while (!freeList->m_data.empty())
     {
-        struct PacketMetadata::Data* data = m_freeList.back();
-        m_freeList.pop_back();
+        struct PacketMetadata::Data* data = freeList->m_data.back();
+        freeList->m_data.pop_back();
         if (data->m_size >= size)
         {
             NS_LOG_LOGIC("create found size=" << data->m_size);
@@ -585,8 +891,10 @@ PacketMetadata::Create(uint32_t size)
         NS_LOG_LOGIC("create dealloc size=" << data->m_size);
         PacketMetadata::Deallocate(data);
     }
-    NS_LOG_LOGIC("create alloc size=" << m_maxSize);
-    return PacketMetadata::Allocate(m_maxSize);
+    NS_LOG_LOGIC("create alloc size=" << freeList->m_maxSize);
+    struct PacketMetadata::Data* data = PacketMetadata::Allocate(freeList->m_maxSize);
+    data->m_freeList = freeList;
+    return data;
 }
 
 void
@@ -598,15 +906,26 @@ PacketMetadata::Recycle(struct PacketMetadata::Data* data)
         PacketMetadata::Deallocate(data);
         return;
     }
-    NS_LOG_LOGIC("recycle size=" << data->m_size << ", list=" << m_freeList.size());
     NS_ASSERT(data->m_count == 0);
-    if (m_freeList.size() > 1000 || data->m_size < m_maxSize)
+    FreeList* freeList = FreeList::Get();
+    if (data->m_freeList == nullptr || freeList == nullptr)
+    {
+        PacketMetadata::Deallocate(data);
+        return;
+    }
+    if (data->m_freeList != freeList)
+    {
+        data->m_freeList->Return(data);
+        return;
+    }
+    NS_LOG_LOGIC("recycle size=" << data->m_size << ", list=" << freeList->m_data.size());
+    if (freeList->m_data.size() > FreeList::MAX_SIZE || data->m_size < freeList->m_maxSize)
     {
         PacketMetadata::Deallocate(data);
     }
     else
     {
-        m_freeList.push_back(data);
+        freeList->m_data.push_back(data);
     }
 }
 
@@ -664,6 +983,16 @@ PacketMetadata::DoAddHeader(uint32_t uid, uint32_t size)
         m_metadataSkipped = true;
         return;
     }
+    if (m_data == nullptr)
+    {
+        const Template* header = Intern(m_headers, uid, size);
+        if (header != nullptr)
+        {
+            m_headers = header;
+            return;
+        }
+        Expand();
+    }
 
     struct PacketMetadata::SmallItem item;
     item.next = m_head;
@@ -686,6 +1015,15 @@ PacketMetadata::RemoveHeader(const Header& header, uint32_t size)
         m_metadataSkipped = true;
         return;
     }
+    if (m_data == nullptr)
+    {
+        if (m_headers != nullptr && m_headers->m_typeUid == uid && m_headers->m_size == size)
+        {
+            m_headers = m_headers->m_parent;
+            return;
+        }
+        Expand();
+    }
     struct PacketMetadata::SmallItem item;
     struct PacketMetadata::ExtraItem extraItem;
     uint32_t read = ReadItems(m_head, &item, &extraItem);
@@ -731,6 +1069,16 @@ PacketMetadata::AddTrailer(const Trailer& trailer, uint32_t size)
         m_metadataSkipped = true;
         return;
     }
+    if (m_data == nullptr)
+    {
+        const Template* trailer = Intern(m_trailers, uid, size);
+        if (trailer != nullptr)
+        {
+            m_trailers = trailer;
+            return;
+        }
+        Expand();
+    }
     struct PacketMetadata::SmallItem item;
     item.next = 0xffff;
     item.prev = m_tail;
@@ -753,6 +1101,15 @@ PacketMetadata::RemoveTrailer(const Trailer& trailer, uint32_t size)
         m_metadataSkipped = true;
         return;
     }
+    if (m_data == nullptr)
+    {
+        if (m_trailers != nullptr && m_trailers->m_typeUid == uid && m_trailers->m_size == size)
+        {
+            m_trailers = m_trailers->m_parent;
+            return;
+        }
+        Expand();
+    }
     struct PacketMetadata::SmallItem item;
     struct PacketMetadata::ExtraItem extraItem;
     uint32_t read = ReadItems(m_tail, &item, &extraItem);
@@ -797,6 +1154,8 @@ PacketMetadata::AddAtEnd(const PacketMetadata& o)
         m_metadataSkipped = true;
         return;
     }
+    Expand();
+    o.Expand();
     if (m_tail == 0xffff)
     {
         // We have no items so 'AddAtEnd' is
@@ -884,7 +1243,11 @@ PacketMetadata::RemoveAtStart(uint32_t start)
         m_metadataSkipped = true;
         return;
     }
-    NS_ASSERT(m_data != nullptr);
+    if (start == 0)
+    {
+        return;
+    }
+    Expand();
     uint32_t leftToRemove = start;
     uint16_t current = m_head;
     while (current != 0xffff && leftToRemove > 0)
@@ -911,6 +1274,7 @@ PacketMetadata::RemoveAtStart(uint32_t start)
         {
             // fragment the list item.
             PacketMetadata fragment(m_packetUid, 0);
+            fragment.Expand();
             extraItem.fragmentStart += leftToRemove;
             leftToRemove = 0;
             uint16_t written = fragment.AddBig(0xffff, fragment.m_tail, &item, &extraItem);
@@ -945,7 +1309,11 @@ PacketMetadata::RemoveAtEnd(uint32_t end)
         m_metadataSkipped = true;
         return;
     }
-    NS_ASSERT(m_data != nullptr);
+    if (end == 0)
+    {
+        return;
+    }
+    Expand();
 
     uint32_t leftToRemove = end;
     uint16_t current = m_tail;
@@ -973,6 +1341,7 @@ PacketMetadata::RemoveAtEnd(uint32_t end)
         {
             // fragment the list item.
             PacketMetadata fragment(m_packetUid, 0);
+            fragment.Expand();
             NS_ASSERT(extraItem.fragmentEnd > leftToRemove);
             extraItem.fragmentEnd -= leftToRemove;
             leftToRemove = 0;
@@ -1039,11 +1408,12 @@ PacketMetadata::BeginItem(Buffer buffer) const
 PacketMetadata::ItemIterator::ItemIterator(const PacketMetadata* metadata, Buffer buffer)
     : m_metadata(metadata),
       m_buffer(buffer),
-      m_current(metadata->m_head),
       m_offset(0),
       m_hasReadTail(false)
 {
     NS_LOG_FUNCTION(this << metadata << &buffer);
+    metadata->Expand();
+    m_current = metadata->m_head;
 }
 
 bool
@@ -1135,6 +1505,7 @@ PacketMetadata::GetSerializedSize() const
     {
         return totalSize;
     }
+    Expand();
 
     struct PacketMetadata::SmallItem item;
     struct PacketMetadata::ExtraItem extraItem;
@@ -1176,6 +1547,7 @@ PacketMetadata::Serialize(uint8_t* buffer, uint32_t maxSize) const
         return 0;
     }
 
+    Expand();
     struct PacketMetadata::SmallItem item;
     struct PacketMetadata::ExtraItem extraItem;
     uint32_t current = m_head;
@@ -1276,6 +1648,7 @@ PacketMetadata::Deserialize(const uint8_t* buffer, uint32_t size)
     NS_LOG_FUNCTION(this << &buffer << size);
     const uint8_t* start = buffer;
     uint32_t desSize = size - 4;
+    Expand();
 
     buffer = ReadFromRawU64(m_packetUid, start, buffer, size);
     desSize -= 8;
@@ -76,6 +76,16 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * When the compact encoding is selected with SetCompact, the metadata of
+ * a new packet is instead made of two stacks of interned items, one for
+ * the payload and the headers, one for the trailers.  Each interned item
+ * is identified by its type, its size and the item below it: the packets
+ * of a flow, which carry the same sequence of headers, thus share the
+ * same items, and adding or removing a header or a trailer costs a
+ * pointer update.  Any other operation, such as fragmentation,
+ * concatenation or printing, first converts the metadata of the packet
+ * to the linked list described above.
  */
 class PacketMetadata
 {
@@ -169,6 +179,22 @@ class PacketMetadata
      * \brief Enable the packet metadata checking
      */
     static void EnableChecking();
+    /**
+     * \brief Select the encoding of the metadata of the packets created
+     * from now on.
+     *
+     * This can be changed at any time: the packets already created keep
+     * their encoding.
+     *
+     * \param compact true to use the compact encoding, false to use the
+     *        linked list encoding.
+     */
+    static void SetCompact(bool compact);
+    /**
+     * \brief Check whether the metadata uses the compact encoding.
+     * \returns true if the metadata uses the compact encoding
+     */
+    bool IsCompact() const;
 
     /**
      * \brief Constructor
@@ -416,10 +442,13 @@ class PacketMetadata
 
     /**
      * the size of PacketMetadata::Data::m_data such that the total size
-     * of PacketMetadata::Data is 16 bytes
+     * of PacketMetadata::Data is 24 bytes on 64 bit platforms
      */
 #define PACKET_METADATA_DATA_M_DATA_SIZE 8
 
+    struct FreeList; //!< Forward declaration
+    struct Template; //!< Forward declaration
+
     /**
      * Data structure
      */
@@ -431,6 +460,8 @@ class PacketMetadata
         uint16_t m_size;
         /** max of the m_used field over all objects which reference this struct Data instance */
         uint16_t m_dirtyEnd;
+        /** the free list of the thread which allocated this struct Data instance */
+        struct FreeList* m_freeList;
         /** variable-sized buffer of bytes */
         uint8_t m_data[PACKET_METADATA_DATA_M_DATA_SIZE];
     };
@@ -509,16 +540,6 @@ class PacketMetadata
         uint64_t packetUid;
     };
 
-    /**
-     * \brief Class to hold all the metadata
-     */
-    class DataFreeList : public std::vector<struct Data*>
-    {
-      public:
-        ~DataFreeList();
-    };
-
-    friend DataFreeList::~DataFreeList();
     /// Friend class
     friend class ItemIterator;
 
@@ -652,6 +673,21 @@ class PacketMetadata
      */
     bool IsSharedPointerOk(uint16_t pointer) const;
 
+    /**
+     * \brief Get the interned item of the compact encoding with the
+     * given fields, creating it if needed.
+     * \param parent the item below, or nullptr
+     * \param uid the type uid of the item, zero for payload
+     * \param size the size of the item
+     * \returns the interned item, or nullptr if too many items were interned
+     */
+    static const Template* Intern(const Template* parent, uint32_t uid, uint32_t size);
+    /**
+     * \brief Convert the metadata from the compact encoding to the linked
+     * list encoding, if needed.
+     */
+    void Expand() const;
+
     /**
      * \brief Recycle the buffer memory
      * \param data the buffer data storage
@@ -675,9 +711,9 @@ class PacketMetadata
      */
     static void Deallocate(struct PacketMetadata::Data* data);
 
-    static DataFreeList m_freeList; //!< the metadata data storage
-    static bool m_enable;           //!< Enable the packet metadata
-    static bool m_enableChecking;   //!< Enable the packet metadata checking
+    static bool m_enable;         //!< Enable the packet metadata
+    static bool m_enableChecking; //!< Enable the packet metadata checking
+    static bool m_compact;        //!< Use the compact encoding for new packets
 
     /**
      * Set to true when adding metadata to a packet is skipped because
@@ -686,10 +722,15 @@ class PacketMetadata
      */
     static bool m_metadataSkipped;
 
-    static uint32_t m_maxSize;  //!< maximum metadata size
-    static uint16_t m_chunkUid; //!< Chunk Uid
+    static thread_local uint16_t m_chunkUid; //!< Chunk Uid, per thread
 
-    struct Data* m_data; //!< Metadata storage
+    /**
+     * Metadata storage of the linked list encoding, nullptr if the
+     * compact encoding is used.
+     */
+    struct Data* m_data;
+    const Template* m_headers;  //!< Top of the payload and headers stack, compact encoding
+    const Template* m_trailers; //!< Top of the trailers stack, compact encoding
     /*
        head -(next)-> tail
          ^             |
@@ -707,13 +748,18 @@ namespace ns3
 {
 
 PacketMetadata::PacketMetadata(uint64_t uid, uint32_t size)
-    : m_data(PacketMetadata::Create(10)),
+    : m_data(m_enable && m_compact ? nullptr : PacketMetadata::Create(10)),
+      m_headers(nullptr),
+      m_trailers(nullptr),
       m_head(0xffff),
       m_tail(0xffff),
       m_used(0),
       m_packetUid(uid)
 {
-    memset(m_data->m_data, 0xff, 4);
+    if (m_data != nullptr)
+    {
+        memset(m_data->m_data, 0xff, 4);
+    }
     if (size > 0)
     {
         DoAddHeader(0, size);
@@ -722,14 +768,18 @@ PacketMetadata::PacketMetadata(uint64_t uid, uint32_t size)
 
 PacketMetadata::PacketMetadata(const PacketMetadata& o)
     : m_data(o.m_data),
+      m_headers(o.m_headers),
+      m_trailers(o.m_trailers),
       m_head(o.m_head),
       m_tail(o.m_tail),
       m_used(o.m_used),
       m_packetUid(o.m_packetUid)
 {
-    NS_ASSERT(m_data != nullptr);
-    NS_ASSERT(m_data->m_count < std::numeric_limits<uint32_t>::max());
-    m_data->m_count++;
+    if (m_data != nullptr)
+    {
+        NS_ASSERT(m_data->m_count < std::numeric_limits<uint32_t>::max());
+        m_data->m_count++;
+    }
 }
 
 PacketMetadata&
@@ -738,16 +788,22 @@ PacketMetadata::operator=(const PacketMetadata& o)
     if (m_data != o.m_data)
     {
         // not self assignment
-        NS_ASSERT(m_data != nullptr);
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (m_data != nullptr)
         {
-            PacketMetadata::Recycle(m_data);
+            m_data->m_count--;
+            if (m_data->m_count == 0)
+            {
+                PacketMetadata::Recycle(m_data);
+            }
         }
         m_data = o.m_data;
-        NS_ASSERT(m_data != nullptr);
-        m_data->m_count++;
+        if (m_data != nullptr)
+        {
+            m_data->m_count++;
+        }
     }
+    m_headers = o.m_headers;
+    m_trailers = o.m_trailers;
     m_head = o.m_head;
     m_tail = o.m_tail;
     m_used = o.m_used;
@@ -757,11 +813,13 @@ PacketMetadata::operator=(const PacketMetadata& o)
 
 PacketMetadata::~PacketMetadata()
 {
-    NS_ASSERT(m_data != nullptr);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (m_data != nullptr)
     {
-        PacketMetadata::Recycle(m_data);
+        m_data->m_count--;
+        if (m_data->m_count == 0)
+        {
+            PacketMetadata::Recycle(m_data);
+        }
     }
 }
 
@@ -37,6 +37,15 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("PacketTagList");
 
+/// Number of TagData allocated on the heap by this thread.
+static thread_local uint64_t g_heapAllocations = 0;
+
+uint64_t
+PacketTagList::GetHeapAllocations()
+{
+    return g_heapAllocations;
+}
+
 PacketTagList::TagData*
 PacketTagList::CreateTagData(size_t dataSize)
 {
@@ -49,9 +58,83 @@ PacketTagList::CreateTagData(size_t dataSize)
 
     TagData* tag = new (p) TagData;
     tag->size = dataSize;
+    g_heapAllocations++;
+    return tag;
+}
+
+PacketTagList::TagData*
+PacketTagList::CreateInlineTagData(size_t dataSize)
+{
+    NS_ASSERT(dataSize <= INLINE_TAG_SIZE);
+    const uint8_t allUsed = (1 << INLINE_TAGS) - 1;
+    if (m_inlineUsed == allUsed)
+    {
+        Spill(INLINE_TAGS - 1);
+    }
+    uint32_t slot = 0;
+    while ((m_inlineUsed & (1 << slot)) != 0)
+    {
+        slot++;
+    }
+    m_inlineUsed |= (1 << slot);
+
+    TagData* tag = new (&m_inline[slot * INLINE_SLOT_SIZE]) TagData;
+    tag->size = dataSize;
     return tag;
 }
 
+void
+PacketTagList::Spill(uint32_t keep)
+{
+    NS_LOG_FUNCTION(this << keep);
+    struct TagData** prevNext = &m_next;
+    for (uint32_t i = 0; i < keep; ++i)
+    {
+        NS_ASSERT(IsInline(*prevNext));
+        prevNext = &(*prevNext)->next;
+    }
+    while (*prevNext != nullptr && IsInline(*prevNext))
+    {
+        struct TagData* cur = *prevNext;
+        struct TagData* copy = CreateTagData(cur->size);
+        copy->tid = cur->tid;
+        copy->count = 1;
+        memcpy(copy->data, cur->data, cur->size);
+        copy->next = cur->next; // takes over the link to the next tag
+        *prevNext = copy;
+        prevNext = &copy->next;
+        m_inlineUsed &= ~(1 << GetSlot(cur));
+        cur->~TagData();
+    }
+}
+
+void
+PacketTagList::CopyInline(const PacketTagList& o)
+{
+    NS_ASSERT(m_inlineUsed == 0);
+    struct TagData** prevNext = &m_next;
+    struct TagData* cur = o.m_next;
+    while (cur != nullptr && o.IsInline(cur))
+    {
+        // Use the same slot as in o, so that the bitmap can be copied
+        uint32_t slot = o.GetSlot(cur);
+        TagData* copy = new (&m_inline[slot * INLINE_SLOT_SIZE]) TagData;
+        copy->tid = cur->tid;
+        copy->count = 1;
+        copy->size = cur->size;
+        memcpy(copy->data, cur->data, cur->size);
+        *prevNext = copy;
+        prevNext = &copy->next;
+        cur = cur->next;
+    }
+    *prevNext = cur;
+    if (cur != nullptr)
+    {
+        cur->count++;
+    }
+    m_inlineUsed = o.m_inlineUsed;
+}
+
 bool
 PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
 {
@@ -192,7 +275,13 @@ PacketTagList::RemoveWriter(Tag& tag,
     tag.Deserialize(TagBuffer(cur->data, cur->data + cur->size));
     *prevNext = cur->next; // link around cur
 
-    if (preMerge)
+    if (preMerge && IsInline(cur))
+    {
+        // found tid in an inline slot, so release it
+        m_inlineUsed &= ~(1 << GetSlot(cur));
+        cur->~TagData();
+    }
+    else if (preMerge)
     {
         // found tid before first merge, so delete cur
         cur->~TagData();
@@ -268,14 +357,25 @@ PacketTagList::Add(const Tag& tag) const
         NS_ASSERT_MSG(cur->tid != tag.GetInstanceTypeId(),
                       "Error: cannot add the same kind of tag twice.");
     }
-    struct TagData* head = CreateTagData(tag.GetSerializedSize());
+    auto self = const_cast<PacketTagList*>(this);
+    uint32_t size = tag.GetSerializedSize();
+    struct TagData* head = nullptr;
+    if (size <= INLINE_TAG_SIZE)
+    {
+        head = self->CreateInlineTagData(size);
+    }
+    else
+    {
+        // keep the inline tags at the head of the list
+        self->Spill(0);
+        head = CreateTagData(size);
+    }
     head->count = 1;
-    head->next = nullptr;
     head->tid = tag.GetInstanceTypeId();
     head->next = m_next;
     tag.Serialize(TagBuffer(head->data, head->data + head->size));
 
-    const_cast<PacketTagList*>(this)->m_next = head;
+    self->m_next = head;
 }
 
 bool
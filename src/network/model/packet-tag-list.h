@@ -120,6 +120,20 @@ class Tag;
  *       The portion of the list between the first branch and the target is
  *       shared. This portion is copied before the #Remove or #Replace is
  *       performed.
+ *
+ * \par <b> Inline storage </b>
+ *
+ *   - Up to #INLINE_TAGS tags whose serialized size is at most
+ *     #INLINE_TAG_SIZE bytes are stored in TagData slots inside the
+ *     PacketTagList itself, so that adding them does not allocate.
+ *     These slots are never shared: they always form the head of the list,
+ *     ahead of the first heap allocated TagData, and they are copied
+ *     by the copy constructor and assignment.
+ *
+ *   - When a tag is added to a list whose slots are all used, the oldest
+ *     inline tag is moved to the heap.  A tag too large for a slot moves
+ *     all the inline tags to the heap before it is added, so that the
+ *     inline tags remain at the head of the list.
  */
 class PacketTagList
 {
@@ -148,6 +162,11 @@ class PacketTagList
         uint8_t data[1];      //!< Serialization buffer
     };
 
+    /// Number of tags which can be stored in the PacketTagList itself.
+    static constexpr uint32_t INLINE_TAGS = 4;
+    /// Maximum serialized size of a tag stored in the PacketTagList itself.
+    static constexpr uint32_t INLINE_TAG_SIZE = 24;
+
     /**
      * Create a new PacketTagList.
      */
@@ -243,7 +262,56 @@ class PacketTagList
      */
     uint32_t Deserialize(const uint32_t* buffer, uint32_t size);
 
+    /**
+     * Get the number of TagData allocated on the heap by the calling thread.
+     *
+     * \returns The number of heap allocated TagData.
+     */
+    static uint64_t GetHeapAllocations();
+
   private:
+    /// Size of an inline TagData slot, rounded up to keep the slots aligned.
+    static constexpr uint32_t INLINE_SLOT_SIZE =
+        (sizeof(TagData) + INLINE_TAG_SIZE - 1 + alignof(TagData) - 1) / alignof(TagData) *
+        alignof(TagData);
+
+    /**
+     * Check whether a TagData is stored in the slots of this list.
+     *
+     * \param [in] data The TagData to check.
+     * \returns True if \pname{data} is one of the inline slots.
+     */
+    inline bool IsInline(const TagData* data) const;
+    /**
+     * Get the index of an inline slot.
+     *
+     * \param [in] data The TagData stored in the slot.
+     * \returns The index of the slot.
+     */
+    inline uint32_t GetSlot(const TagData* data) const;
+    /**
+     * Construct a TagData in a free inline slot, moving the oldest
+     * inline tag to the heap if all the slots are used.
+     *
+     * \param [in] dataSize The serialized size of the Tag.
+     * \returns The newly constructed TagData object.
+     */
+    TagData* CreateInlineTagData(size_t dataSize);
+    /**
+     * Move the inline tags after the first \pname{keep} ones to the heap.
+     *
+     * \param [in] keep The number of inline tags to keep in their slots.
+     */
+    void Spill(uint32_t keep);
+    /**
+     * Copy the inline tags of another list, and join its heap allocated tags.
+     *
+     * This list must be empty.
+     *
+     * \param [in] o The PacketTagList to copy.
+     */
+    void CopyInline(const PacketTagList& o);
+
     /**
      * Allocate and construct a TagData struct, sizing the data area
      * large enough to serialize dataSize bytes from a Tag.
@@ -305,6 +373,10 @@ class PacketTagList
      * Pointer to first \ref TagData on the list
      */
     struct TagData* m_next;
+    /// Storage of the inline TagData slots.
+    alignas(TagData) uint8_t m_inline[INLINE_TAGS * INLINE_SLOT_SIZE];
+    /// Bitmap of the used inline slots.
+    uint8_t m_inlineUsed;
 };
 
 } // namespace ns3
@@ -317,14 +389,20 @@ namespace ns3
 {
 
 PacketTagList::PacketTagList()
-    : m_next()
+    : m_next(),
+      m_inlineUsed(0)
 {
 }
 
 PacketTagList::PacketTagList(const PacketTagList& o)
-    : m_next(o.m_next)
+    : m_next(o.m_next),
+      m_inlineUsed(0)
 {
-    if (m_next != nullptr)
+    if (o.m_inlineUsed != 0)
+    {
+        CopyInline(o);
+    }
+    else if (m_next != nullptr)
     {
         m_next->count++;
     }
@@ -340,7 +418,11 @@ PacketTagList::operator=(const PacketTagList& o)
     }
     RemoveAll();
     m_next = o.m_next;
-    if (m_next != nullptr)
+    if (o.m_inlineUsed != 0)
+    {
+        CopyInline(o);
+    }
+    else if (m_next != nullptr)
     {
         m_next->count++;
     }
@@ -352,11 +434,34 @@ PacketTagList::~PacketTagList()
     RemoveAll();
 }
 
+bool
+PacketTagList::IsInline(const TagData* data) const
+{
+    auto p = reinterpret_cast<uintptr_t>(data);
+    auto begin = reinterpret_cast<uintptr_t>(m_inline);
+    return p >= begin && p < begin + sizeof(m_inline);
+}
+
+uint32_t
+PacketTagList::GetSlot(const TagData* data) const
+{
+    return (reinterpret_cast<const uint8_t*>(data) - m_inline) / INLINE_SLOT_SIZE;
+}
+
 void
 PacketTagList::RemoveAll()
 {
+    struct TagData* cur = m_next;
+    // The inline tags are at the head of the list
+    while (m_inlineUsed != 0)
+    {
+        struct TagData* next = cur->next;
+        m_inlineUsed &= ~(1 << GetSlot(cur));
+        cur->~TagData();
+        cur = next;
+    }
     struct TagData* prev = nullptr;
-    for (struct TagData* cur = m_next; cur != nullptr; cur = cur->next)
+    for (; cur != nullptr; cur = cur->next)
     {
         cur->count--;
         if (cur->count > 0)
@@ -33,6 +33,7 @@
 #include "ns3/mac48-address.h"
 #include "ns3/ptr.h"
 
+#include <atomic>
 #include <stdint.h>
 
 namespace ns3
@@ -537,6 +538,14 @@ class Packet : public SimpleRefCount<Packet>
      * errors will be detected and will abort the program.
      */
     static void EnableChecking();
+    /**
+     * \brief Enable printing packets metadata, using the compact encoding.
+     *
+     * As EnablePrinting, but the metadata of the packets is stored as
+     * described in PacketMetadata::SetCompact, which makes adding and
+     * removing headers and trailers cheaper.
+     */
+    static void EnableCompactPrinting();
 
     /**
      * \brief Returns number of bytes required for packet
@@ -796,7 +805,7 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-    static uint32_t m_globalUid; //!< Global counter of packets Uid
+    static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
 };
 
 /**
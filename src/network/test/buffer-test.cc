@@ -22,6 +22,8 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/test.h"
 
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -395,6 +397,191 @@ BufferTest::DoRun()
     NS_TEST_ASSERT_MSG_EQ(val1, val2, "Bad ReadNtohU16()");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Buffer fragment chain tests.
+ */
+class BufferChainTest : public TestCase
+{
+  private:
+    /**
+     * Create a buffer made of real bytes around a virtual zero area.
+     * \param start The number of real bytes before the zero area
+     * \param zeroes The size of the zero area
+     * \param end The number of real bytes after the zero area
+     * \param [out] expected The bytes of the buffer are appended to it
+     * \return The buffer
+     */
+    Buffer CreateBuffer(uint32_t start,
+                        uint32_t zeroes,
+                        uint32_t end,
+                        std::vector<uint8_t>& expected);
+    /**
+     * Checks the buffer content, without and with an Iterator.
+     * \param b The buffer to check
+     * \param expected The bytes which should be in the buffer
+     * \param msg The message to report on failure
+     */
+    void CheckContent(const Buffer& b, const std::vector<uint8_t>& expected, std::string msg);
+
+  public:
+    void DoRun() override;
+    BufferChainTest();
+
+  private:
+    uint8_t m_next; //!< The value of the next real byte created
+};
+
+BufferChainTest::BufferChainTest()
+    : TestCase("Buffer fragment chains"),
+      m_next(1)
+{
+}
+
+Buffer
+BufferChainTest::CreateBuffer(uint32_t start,
+                              uint32_t zeroes,
+                              uint32_t end,
+                              std::vector<uint8_t>& expected)
+{
+    Buffer b(zeroes);
+    b.AddAtStart(start);
+    b.AddAtEnd(end);
+    Buffer::Iterator i = b.Begin();
+    for (uint32_t j = 0; j < start; j++)
+    {
+        expected.push_back(m_next);
+        i.WriteU8(m_next++);
+    }
+    expected.insert(expected.end(), zeroes, 0);
+    i.Next(zeroes);
+    for (uint32_t j = 0; j < end; j++)
+    {
+        expected.push_back(m_next);
+        i.WriteU8(m_next++);
+    }
+    return b;
+}
+
+void
+BufferChainTest::CheckContent(const Buffer& b,
+                              const std::vector<uint8_t>& expected,
+                              std::string msg)
+{
+    NS_TEST_ASSERT_MSG_EQ(b.GetSize(), expected.size(), msg << ": bad size");
+    std::vector<uint8_t> got(expected.size() + 1, 0xff);
+    uint32_t copied = b.CopyData(got.data(), got.size());
+    NS_TEST_ASSERT_MSG_EQ(copied, expected.size(), msg << ": bad copied size");
+    got.pop_back();
+    NS_TEST_ASSERT_MSG_EQ((got == expected), true, msg << ": bad copied bytes");
+
+    // reading through an iterator merges the fragments of a copy only.
+    Buffer copy = b;
+    Buffer::Iterator i = copy.Begin();
+    bool ok = true;
+    for (uint32_t j = 0; j < expected.size(); j++)
+    {
+        ok = ok && i.ReadU8() == expected[j];
+    }
+    NS_TEST_ASSERT_MSG_EQ(ok, true, msg << ": bad bytes read");
+    NS_TEST_ASSERT_MSG_EQ(copy.GetFragmentCount(), 1, msg << ": fragments not merged");
+}
+
+void
+BufferChainTest::DoRun()
+{
+    std::vector<uint8_t> expected;
+    Buffer buffer = CreateBuffer(20, 0, 200, expected);
+    std::vector<uint8_t> first = expected;
+    Buffer firstBuffer = buffer;
+    buffer.AddAtEnd(CreateBuffer(30, 1000, 4, expected));
+    buffer.AddAtEnd(CreateBuffer(0, 0, 1100, expected));
+    NS_TEST_ASSERT_MSG_EQ(buffer.GetFragmentCount(), 3, "large buffers should be referenced");
+    CheckContent(buffer, expected, "chain");
+    CheckContent(firstBuffer, first, "first buffer modified");
+
+    // small buffers are copied at the end of the last fragment.
+    buffer.AddAtEnd(CreateBuffer(3, 0, 4, expected));
+    NS_TEST_ASSERT_MSG_EQ(buffer.GetFragmentCount(), 3, "small buffers should be copied");
+    CheckContent(buffer, expected, "small append");
+
+    // appending a chain appends its fragments; its small first one is copied.
+    Buffer chain = buffer;
+    std::vector<uint8_t> chainExpected = expected;
+    chain.AddAtEnd(buffer);
+    chainExpected.insert(chainExpected.end(), expected.begin(), expected.end());
+    NS_TEST_ASSERT_MSG_EQ(chain.GetFragmentCount(), 5, "bad number of fragments");
+    CheckContent(chain, chainExpected, "chain appended to itself");
+    CheckContent(buffer, expected, "shared chain modified");
+
+    // fragments do not copy bytes.
+    Buffer frag = buffer.CreateFragment(250, 1000);
+    NS_TEST_ASSERT_MSG_EQ(frag.GetFragmentCount(), 1, "fragment within a single fragment");
+    CheckContent(frag,
+                 std::vector<uint8_t>(expected.begin() + 250, expected.begin() + 1250),
+                 "fragment");
+    frag = buffer.CreateFragment(100, 1000);
+    NS_TEST_ASSERT_MSG_EQ(frag.GetFragmentCount(), 2, "fragment across two fragments");
+    CheckContent(frag,
+                 std::vector<uint8_t>(expected.begin() + 100, expected.begin() + 1100),
+                 "fragment across fragments");
+    frag = buffer.CreateFragment(220, buffer.GetSize() - 220);
+    NS_TEST_ASSERT_MSG_EQ(frag.GetFragmentCount(), 2, "first fragment should be removed");
+    CheckContent(frag,
+                 std::vector<uint8_t>(expected.begin() + 220, expected.end()),
+                 "fragment at the end");
+
+    // random operations, checked against a plain vector of bytes.
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    for (uint32_t step = 0; step < 1000; step++)
+    {
+        uint32_t size = expected.size();
+        switch (rng->GetInteger(0, 5))
+        {
+        case 0:
+        case 1:
+            buffer.AddAtEnd(CreateBuffer(rng->GetInteger(0, 600),
+                                         rng->GetInteger(0, 1) * rng->GetInteger(0, 1500),
+                                         rng->GetInteger(0, 600),
+                                         expected));
+            break;
+        case 2: {
+            uint32_t n = rng->GetInteger(0, std::min<uint32_t>(size, 1500));
+            buffer.RemoveAtStart(n);
+            expected.erase(expected.begin(), expected.begin() + n);
+            break;
+        }
+        case 3: {
+            uint32_t n = rng->GetInteger(0, std::min<uint32_t>(size, 1500));
+            buffer.RemoveAtEnd(n);
+            expected.resize(size - n);
+            break;
+        }
+        case 4: {
+            uint32_t start = rng->GetInteger(0, size);
+            uint32_t length = rng->GetInteger(0, size - start);
+            Buffer copy = buffer;
+            buffer = copy.CreateFragment(start, length);
+            copy.RemoveAtEnd(size);
+            NS_TEST_ASSERT_MSG_EQ(copy.GetSize(), 0, "bad size of emptied copy");
+            expected =
+                std::vector<uint8_t>(expected.begin() + start, expected.begin() + start + length);
+            break;
+        }
+        default: {
+            buffer.AddAtStart(2);
+            Buffer::Iterator i = buffer.Begin();
+            i.WriteHtonU16(0x4142);
+            expected.insert(expected.begin(), {0x41, 0x42});
+            break;
+        }
+        }
+        CheckContent(buffer, expected, "step " + std::to_string(step));
+    }
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -411,6 +598,7 @@ BufferTestSuite::BufferTestSuite()
     : TestSuite("buffer", UNIT)
 {
     AddTestCase(new BufferTest, TestCase::QUICK);
+    AddTestCase(new BufferChainTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite; //!< Static variable for test initialization
@@ -23,8 +23,12 @@
 #include "ns3/trailer.h"
 
 #include <cstdarg>
+#include <cstring>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace ns3;
 
@@ -326,7 +330,11 @@ HistoryTrailer<N>::Deserialize(Buffer::Iterator start)
 class PacketMetadataTest : public TestCase
 {
   public:
-    PacketMetadataTest();
+    /**
+     * Constructor
+     * \param compact Whether to use the compact metadata encoding.
+     */
+    PacketMetadataTest(bool compact);
     ~PacketMetadataTest() override;
     /**
      * Checks the packet header and trailer history
@@ -344,10 +352,13 @@ class PacketMetadataTest : public TestCase
      * \return The packet with the header added.
      */
     Ptr<Packet> DoAddHeader(Ptr<Packet> p);
+
+    bool m_compact; //!< Whether to use the compact metadata encoding
 };
 
-PacketMetadataTest::PacketMetadataTest()
-    : TestCase("Packet metadata")
+PacketMetadataTest::PacketMetadataTest(bool compact)
+    : TestCase(compact ? "Packet metadata, compact encoding" : "Packet metadata"),
+      m_compact(compact)
 {
 }
 
@@ -368,7 +379,8 @@ PacketMetadataTest::CheckHistory(Ptr<Packet> p, uint32_t n, ...)
     }
     va_end(ap);
 
-    PacketMetadata::ItemIterator k = p->BeginItem();
+    // Iterate over a copy, so that the metadata of p keeps its encoding.
+    PacketMetadata::ItemIterator k = p->Copy()->BeginItem();
     std::list<int> got;
     while (k.HasNext())
     {
@@ -480,6 +492,7 @@ void
 PacketMetadataTest::DoRun()
 {
     PacketMetadata::Enable();
+    PacketMetadata::SetCompact(m_compact);
 
     Ptr<Packet> p = Create<Packet>(0);
     Ptr<Packet> p1 = Create<Packet>(0);
@@ -879,6 +892,135 @@ PacketMetadataTest::DoRun()
     NS_TEST_EXPECT_MSG_EQ(msg,
                           std::string("hello world"),
                           "Could not find original data in received packet");
+
+    if (m_compact)
+    {
+        PacketMetadata metadata(1, 10);
+        metadata.AddHeader(HistoryHeader<8>(), 8);
+        metadata.AddTrailer(HistoryTrailer<4>(), 4);
+        NS_TEST_EXPECT_MSG_EQ(metadata.IsCompact(), true, "Should use the compact encoding");
+        metadata.RemoveHeader(HistoryHeader<8>(), 8);
+        metadata.RemoveTrailer(HistoryTrailer<4>(), 4);
+        NS_TEST_EXPECT_MSG_EQ(metadata.IsCompact(), true, "Should still use the compact encoding");
+        PacketMetadata fragment = metadata.CreateFragment(2, 0);
+        NS_TEST_EXPECT_MSG_EQ(metadata.IsCompact(),
+                              true,
+                              "Fragmenting should not expand the source");
+        NS_TEST_EXPECT_MSG_EQ(fragment.IsCompact(), false, "A fragment is not compact");
+    }
+    PacketMetadata::SetCompact(false);
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check that packets can be built and released concurrently by several
+ * threads, including packets released by another thread than the one
+ * which created them.
+ */
+class PacketMetadataThreadsTest : public TestCase
+{
+  public:
+    PacketMetadataThreadsTest();
+    void DoRun() override;
+
+  private:
+    /**
+     * Build and check packets, and hand them over to the next thread,
+     * which checks and releases them.
+     * \param index The index of the thread.
+     * \returns true if all the packets had the expected content.
+     */
+    bool Run(uint32_t index);
+
+    static const uint32_t THREADS = 4; //!< Number of threads
+
+    std::mutex m_mutex;                               //!< Mutex protecting m_handover
+    std::vector<std::vector<Ptr<Packet>>> m_handover; //!< Packets to release, per thread
+};
+
+PacketMetadataThreadsTest::PacketMetadataThreadsTest()
+    : TestCase("Packets built and released by several threads")
+{
+}
+
+bool
+PacketMetadataThreadsTest::Run(uint32_t index)
+{
+    bool ok = true;
+    std::vector<Ptr<Packet>> sent;
+    for (uint32_t round = 0; round < 4000; round++)
+    {
+        {
+            uint8_t payload[100];
+            uint8_t received[100];
+            uint32_t size = 1 + (round * 7 + index) % 100;
+            std::memset(payload, index + round, size);
+            Ptr<Packet> p = Create<Packet>(payload, size);
+            ADD_HEADER(p, 10);
+            ADD_TRAILER(p, 4);
+            Ptr<Packet> copy = p->Copy();
+            ADD_HEADER(copy, 10);
+            copy->AddAtEnd(Create<Packet>(size));
+            HistoryHeader<10> header;
+            p->RemoveHeader(header);
+            HistoryTrailer<4> trailer;
+            p->RemoveTrailer(trailer);
+            ok = ok && header.IsOk() && trailer.IsOk() && p->GetSize() == size &&
+                 p->CopyData(received, size) == size &&
+                 std::memcmp(payload, received, size) == 0;
+            sent.push_back(copy);
+        }
+        // The packets handed over must not share their data with the packets
+        // of this thread, since the reference counts of the data are not atomic.
+
+        if (sent.size() == 16)
+        {
+            std::vector<Ptr<Packet>> released;
+            {
+                std::unique_lock lock(m_mutex);
+                auto& next = m_handover[(index + 1) % THREADS];
+                next.insert(next.end(), sent.begin(), sent.end());
+                released.swap(m_handover[index]);
+            }
+            sent.clear();
+            for (const auto& packet : released)
+            {
+                uint32_t payloadSize = (packet->GetSize() - 24) / 2;
+                HistoryHeader<10> other;
+                packet->RemoveHeader(other);
+                ok = ok && other.IsOk() && packet->GetSize() == 2 * payloadSize + 14;
+            }
+        }
+    }
+    return ok;
+}
+
+void
+PacketMetadataThreadsTest::DoRun()
+{
+    // Register the types used by the threads beforehand.
+    HistoryHeader<10>::GetTypeId();
+    HistoryTrailer<4>::GetTypeId();
+
+    m_handover.resize(THREADS);
+    std::vector<uint8_t> results(THREADS, 0);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < THREADS; ++i)
+    {
+        threads.emplace_back([this, &results, i]() { results[i] = Run(i); });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    m_handover.clear();
+
+    for (uint32_t i = 0; i < THREADS; ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(results[i], true, "Unexpected packet content in thread " << i);
+    }
 }
 
 /**
@@ -896,7 +1038,9 @@ class PacketMetadataTestSuite : public TestSuite
 PacketMetadataTestSuite::PacketMetadataTestSuite()
     : TestSuite("packet-metadata", UNIT)
 {
-    AddTestCase(new PacketMetadataTest, TestCase::QUICK);
+    AddTestCase(new PacketMetadataTest(false), TestCase::QUICK);
+    AddTestCase(new PacketMetadataTest(true), TestCase::QUICK);
+    AddTestCase(new PacketMetadataThreadsTest, TestCase::QUICK);
 }
 
 static PacketMetadataTestSuite g_packetMetadataTest; //!< Static variable for test initialization
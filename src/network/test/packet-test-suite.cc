@@ -1176,6 +1176,41 @@ PacketTagListTest::DoRun()
 #undef RemoveCheck
 } // Removal
 
+{ // Inline storage
+    std::cout << GetName() << "check inline storage" << std::endl;
+    uint64_t allocations = PacketTagList::GetHeapAllocations();
+    PacketTagList ptl;
+    ptl.Add(t1);
+    ptl.Add(t2);
+    ptl.Add(t3);
+    ptl.Add(t4);
+    PacketTagList cpy = ptl;
+    cpy.Remove(t2);
+    cpy.Add(t5);
+    NS_TEST_EXPECT_MSG_EQ(PacketTagList::GetHeapAllocations(),
+                          allocations,
+                          "Small tags should be stored inline");
+    CheckRef(ptl, t2, "inline, orig");
+    CheckRef(cpy, t2, "inline, copy", true);
+    CheckRef(cpy, t5, "inline, copy");
+
+    // Both overflowing the slots and adding a large tag move tags to the heap
+    ATestTag<40> large(1);
+    cpy.Add(t6);
+    cpy.Add(large);
+    cpy.Add(t7);
+    NS_TEST_EXPECT_MSG_GT(PacketTagList::GetHeapAllocations(),
+                          allocations,
+                          "Large tags should be stored on the heap");
+    PacketTagList mrg = cpy;
+    mrg.Remove(t1);
+    mrg.Add(t2);
+    CheckRefList(cpy, "inline and heap, orig", 2);
+    CheckRef(cpy, large, "inline and heap, orig");
+    CheckRefList(mrg, "inline and heap, copy", 1);
+    CheckRef(mrg, large, "inline and heap, copy");
+}
+
 { // Replace
 
     std::cout << GetName() << "check replacing each tag" << std::endl;
@@ -15,15 +15,23 @@
  * Author:  Craig Dowell (craigdo@ee.washington.edu)
  */
 
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
 #include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/pcap-file-wrapper.h"
 #include "ns3/pcap-file.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
 
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -1375,6 +1383,160 @@ DiffTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case checking the files written by PcapFileWrapper through
+ * the batched writer: pcap files written in the background, pcapng files,
+ * and compressed files.
+ */
+class BatchedWriteTestCase : public TestCase
+{
+  public:
+    BatchedWriteTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Write the known packets with a PcapFileWrapper.
+     * \param file The file.
+     * \param filename The file name.
+     */
+    void WriteKnownPackets(Ptr<PcapFileWrapper> file, const std::string& filename);
+
+    /**
+     * Read a little endian 32 bit value.
+     * \param p The bytes.
+     * \returns The value.
+     */
+    static uint32_t ReadU32(const uint8_t* p);
+};
+
+BatchedWriteTestCase::BatchedWriteTestCase()
+    : TestCase("Check that PcapFileWrapper writes batched, pcapng and compressed files")
+{
+}
+
+uint32_t
+BatchedWriteTestCase::ReadU32(const uint8_t* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+}
+
+void
+BatchedWriteTestCase::WriteKnownPackets(Ptr<PcapFileWrapper> file, const std::string& filename)
+{
+    file->Open(filename, std::ios::out);
+    NS_TEST_ASSERT_MSG_EQ(file->Fail(), false, "Open (" << filename << ") returns error");
+    file->Init(1, N_PACKET_BYTES);
+    // Enough copies of the packets to fill several batches
+    for (uint32_t round = 0; round < 200; ++round)
+    {
+        for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+        {
+            const PacketEntry& p = knownPackets[i];
+            Time t = Seconds(p.tsSec + round) + MicroSeconds(p.tsUsec);
+            file->Write(t, (const uint8_t*)p.data, p.origLen);
+        }
+    }
+    file->Close();
+    NS_TEST_EXPECT_MSG_EQ(file->Fail(), false, "Writing " << filename << " failed");
+}
+
+void
+BatchedWriteTestCase::DoRun()
+{
+    //
+    // A pcap file written in the background must be identical to the same
+    // file written synchronously
+    //
+    std::string expected = CreateTempDirFilename("batched-expected.pcap");
+    WriteKnownPackets(CreateObject<PcapFileWrapper>(), expected);
+
+    std::string batched = CreateTempDirFilename("batched.pcap");
+    Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper>();
+    file->SetAttribute("Asynchronous", BooleanValue(true));
+    file->SetAttribute("BufferSize", UintegerValue(4096));
+    WriteKnownPackets(file, batched);
+
+    uint32_t sec(0);
+    uint32_t usec(0);
+    uint32_t packets(0);
+    bool diff = PcapFile::Diff(expected, batched, sec, usec, packets, N_PACKET_BYTES);
+    NS_TEST_EXPECT_MSG_EQ(diff, false, "The batched file differs at packet " << packets);
+    NS_TEST_EXPECT_MSG_EQ(packets, 200 * N_KNOWN_PACKETS, "Unexpected number of packets");
+    NS_TEST_EXPECT_MSG_EQ(CheckFileLength(batched, 24 + 200 * N_KNOWN_PACKETS * (16 + 16)),
+                          true,
+                          "Unexpected length of the batched file");
+
+    //
+    // Walk the blocks of a pcapng file
+    //
+    std::string pcapng = CreateTempDirFilename("batched.pcapng");
+    file = CreateObject<PcapFileWrapper>();
+    file->SetAttribute("Asynchronous", BooleanValue(true));
+    file->SetAttribute("Format", EnumValue(PcapFileWrapper::PCAPNG));
+    WriteKnownPackets(file, pcapng);
+
+    std::ifstream in(pcapng, std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)),
+                               std::istreambuf_iterator<char>());
+    std::vector<uint32_t> types;
+    uint32_t offset = 0;
+    uint32_t epb = 0;
+    while (offset + 12 <= bytes.size())
+    {
+        uint32_t type = ReadU32(&bytes[offset]);
+        uint32_t length = ReadU32(&bytes[offset + 4]);
+        NS_TEST_ASSERT_MSG_EQ((length % 4 == 0 && length >= 12 && offset + length <= bytes.size()),
+                              true,
+                              "Invalid block length " << length << " at " << offset);
+        NS_TEST_ASSERT_MSG_EQ(ReadU32(&bytes[offset + length - 4]),
+                              length,
+                              "Trailing block length mismatch at " << offset);
+        types.push_back(type);
+        if (type == 6)
+        {
+            const PacketEntry& p = knownPackets[epb % N_KNOWN_PACKETS];
+            uint64_t ns = (uint64_t(ReadU32(&bytes[offset + 12])) << 32) |
+                          ReadU32(&bytes[offset + 16]);
+            uint64_t expectedNs =
+                (p.tsSec + epb / N_KNOWN_PACKETS) * 1000000000ULL + p.tsUsec * 1000ULL;
+            NS_TEST_EXPECT_MSG_EQ(ns, expectedNs, "Unexpected timestamp");
+            NS_TEST_EXPECT_MSG_EQ(ReadU32(&bytes[offset + 20]), N_PACKET_BYTES, "Captured len");
+            NS_TEST_EXPECT_MSG_EQ(ReadU32(&bytes[offset + 24]), p.origLen, "Original len");
+            NS_TEST_EXPECT_MSG_EQ(std::memcmp(&bytes[offset + 28], p.data, N_PACKET_BYTES),
+                                  0,
+                                  "Unexpected packet data");
+            epb++;
+        }
+        offset += length;
+    }
+    NS_TEST_EXPECT_MSG_EQ(offset, bytes.size(), "Trailing bytes in the pcapng file");
+    NS_TEST_ASSERT_MSG_EQ((types.size() >= 2), true, "Missing pcapng header blocks");
+    NS_TEST_EXPECT_MSG_EQ(types[0], 0x0a0d0d0a, "The first block must be a Section Header Block");
+    NS_TEST_EXPECT_MSG_EQ(ReadU32(&bytes[8]), 0x1a2b3c4d, "Unexpected byte order magic");
+    NS_TEST_EXPECT_MSG_EQ(types[1], 1, "The second block must be an Interface Description Block");
+    NS_TEST_EXPECT_MSG_EQ(epb, 200 * N_KNOWN_PACKETS, "Unexpected number of packets");
+
+    //
+    // A gzip file gets the ".gz" suffix and a gzip header
+    //
+    if (PcapAsyncWriter::IsSupported(PcapAsyncWriter::GZIP))
+    {
+        std::string gzip = CreateTempDirFilename("batched-gzip.pcap");
+        file = CreateObject<PcapFileWrapper>();
+        file->SetAttribute("Compression", EnumValue(PcapAsyncWriter::GZIP));
+        WriteKnownPackets(file, gzip);
+        std::ifstream gz(gzip + ".gz", std::ios::binary);
+        NS_TEST_ASSERT_MSG_EQ(gz.good(), true, "Missing " << gzip << ".gz");
+        NS_TEST_EXPECT_MSG_EQ(gz.get(), 0x1f, "Unexpected gzip magic");
+        NS_TEST_EXPECT_MSG_EQ(gz.get(), 0x8b, "Unexpected gzip magic");
+    }
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1398,6 +1560,7 @@ PcapFileTestSuite::PcapFileTestSuite()
     AddTestCase(new RecordHeaderTestCase, TestCase::QUICK);
     AddTestCase(new ReadFileTestCase, TestCase::QUICK);
     AddTestCase(new DiffTestCase, TestCase::QUICK);
+    AddTestCase(new BatchedWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
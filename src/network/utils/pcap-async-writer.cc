@@ -0,0 +1,648 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "pcap-async-writer.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/mpsc-queue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PcapAsyncWriter");
+
+/**
+ * \brief The output of a PcapAsyncWriter, which writes the batches to the file.
+ *
+ * The methods of the outputs may be called from the background thread,
+ * so they must not log.
+ */
+class PcapOutput
+{
+  public:
+    /**
+     * Open the file.
+     * \param filename The name of the file.
+     * \param mode The access mode for the file.
+     */
+    PcapOutput(const std::string& filename, std::ios::openmode mode)
+        : m_file(filename, mode | std::ios::binary)
+    {
+    }
+
+    virtual ~PcapOutput() = default;
+
+    /**
+     * \return true if the file could be opened.
+     */
+    bool IsOpen() const
+    {
+        return m_file.is_open();
+    }
+
+    /**
+     * Write a batch.
+     * \param data The batch.
+     * \param size The size of the batch.
+     * \return false if an error occurred.
+     */
+    virtual bool Write(const uint8_t* data, std::size_t size)
+    {
+        m_file.write(reinterpret_cast<const char*>(data), size);
+        return m_file.good();
+    }
+
+    /**
+     * Terminate the output and close the file.
+     * \return false if an error occurred.
+     */
+    virtual bool Close()
+    {
+        m_file.close();
+        return !m_file.fail();
+    }
+
+  protected:
+    std::ofstream m_file; //!< The file
+};
+
+#ifdef HAVE_ZLIB
+/**
+ * \brief An output compressing the batches into a gzip stream.
+ */
+class GzipOutput : public PcapOutput
+{
+  public:
+    /**
+     * Open the file and initialize the compressor.
+     * \param filename The name of the file.
+     * \param mode The access mode for the file.
+     */
+    GzipOutput(const std::string& filename, std::ios::openmode mode)
+        : PcapOutput(filename, mode)
+    {
+        m_stream = z_stream();
+        // 15 bits of window, plus 16 to get a gzip header and trailer
+        m_valid = deflateInit2(&m_stream,
+                               Z_DEFAULT_COMPRESSION,
+                               Z_DEFLATED,
+                               15 + 16,
+                               8,
+                               Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+
+    ~GzipOutput() override
+    {
+        if (m_valid)
+        {
+            deflateEnd(&m_stream);
+        }
+    }
+
+    bool Write(const uint8_t* data, std::size_t size) override
+    {
+        m_stream.next_in = const_cast<Bytef*>(data);
+        m_stream.avail_in = static_cast<uInt>(size);
+        return m_valid && Deflate(Z_NO_FLUSH);
+    }
+
+    bool Close() override
+    {
+        m_stream.next_in = nullptr;
+        m_stream.avail_in = 0;
+        bool ok = m_valid && Deflate(Z_FINISH);
+        return PcapOutput::Close() && ok;
+    }
+
+  private:
+    /**
+     * Compress the pending input, and write the compressed bytes.
+     * \param flush The zlib flush mode.
+     * \return false if an error occurred.
+     */
+    bool Deflate(int flush)
+    {
+        int ret;
+        do
+        {
+            m_stream.next_out = m_buffer;
+            m_stream.avail_out = sizeof(m_buffer);
+            ret = deflate(&m_stream, flush);
+            if (ret == Z_STREAM_ERROR)
+            {
+                return false;
+            }
+            m_file.write(reinterpret_cast<const char*>(m_buffer),
+                         sizeof(m_buffer) - m_stream.avail_out);
+        } while (m_stream.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+        return m_file.good();
+    }
+
+    z_stream m_stream;         //!< The compressor state
+    bool m_valid;              //!< Whether the compressor was initialized
+    Bytef m_buffer[64 * 1024]; //!< The compressed bytes
+};
+#endif /* HAVE_ZLIB */
+
+#ifdef HAVE_ZSTD
+/**
+ * \brief An output compressing the batches into a Zstandard frame.
+ */
+class ZstdOutput : public PcapOutput
+{
+  public:
+    /**
+     * Open the file and initialize the compressor.
+     * \param filename The name of the file.
+     * \param mode The access mode for the file.
+     */
+    ZstdOutput(const std::string& filename, std::ios::openmode mode)
+        : PcapOutput(filename, mode),
+          m_context(ZSTD_createCCtx()),
+          m_buffer(ZSTD_CStreamOutSize())
+    {
+    }
+
+    ~ZstdOutput() override
+    {
+        ZSTD_freeCCtx(m_context);
+    }
+
+    bool Write(const uint8_t* data, std::size_t size) override
+    {
+        ZSTD_inBuffer input = {data, size, 0};
+        while (input.pos < input.size)
+        {
+            if (!Compress(&input, ZSTD_e_continue))
+            {
+                return false;
+            }
+        }
+        return m_file.good();
+    }
+
+    bool Close() override
+    {
+        ZSTD_inBuffer input = {nullptr, 0, 0};
+        bool ok = Compress(&input, ZSTD_e_end);
+        return PcapOutput::Close() && ok;
+    }
+
+  private:
+    /**
+     * Compress some input, and write the compressed bytes.  With
+     * ZSTD_e_end, this loops until the frame is complete.
+     * \param input The input.
+     * \param directive The Zstandard end directive.
+     * \return false if an error occurred.
+     */
+    bool Compress(ZSTD_inBuffer* input, ZSTD_EndDirective directive)
+    {
+        if (m_context == nullptr)
+        {
+            return false;
+        }
+        std::size_t remaining;
+        do
+        {
+            ZSTD_outBuffer output = {m_buffer.data(), m_buffer.size(), 0};
+            remaining = ZSTD_compressStream2(m_context, &output, input, directive);
+            if (ZSTD_isError(remaining))
+            {
+                return false;
+            }
+            m_file.write(reinterpret_cast<const char*>(m_buffer.data()), output.pos);
+        } while (directive == ZSTD_e_end && remaining != 0);
+        return true;
+    }
+
+    ZSTD_CCtx* m_context;          //!< The compressor state
+    std::vector<uint8_t> m_buffer; //!< The compressed bytes
+};
+#endif /* HAVE_ZSTD */
+
+/**
+ * \brief The thread writing the batches of all the background writers.
+ *
+ * It exists while at least one background writer is open.
+ */
+class PcapWriterThread
+{
+  public:
+    /**
+     * Get the thread, starting it if needed, and register a writer.
+     * \returns the thread
+     */
+    static PcapWriterThread* Acquire();
+    /**
+     * Unregister a writer, and stop the thread if it was the last one.
+     */
+    static void Release();
+
+    /**
+     * Queue a batch.  This blocks while too many bytes are queued.
+     * \param writer The writer of the batch.
+     * \param batch The batch, which is recycled once written.
+     * \param size The size of the batch.
+     */
+    void Submit(PcapAsyncWriter* writer, std::vector<uint8_t>* batch, std::size_t size);
+    /**
+     * Wait until all the batches queued by a writer are written.
+     * \param writer The writer.
+     */
+    void Wait(PcapAsyncWriter* writer);
+    /**
+     * Get an empty batch buffer.
+     * \param size The minimum size of the buffer.
+     * \returns the buffer
+     */
+    std::vector<uint8_t>* GetBuffer(std::size_t size);
+    /**
+     * Return a batch buffer which will not be submitted.
+     * \param batch The buffer.
+     */
+    void PutBuffer(std::vector<uint8_t>* batch);
+
+  private:
+    /** A queued batch. */
+    struct Job
+    {
+        PcapAsyncWriter* writer;     //!< The writer of the batch
+        std::vector<uint8_t>* batch; //!< The batch
+        std::size_t size;            //!< The size of the batch
+    };
+
+    PcapWriterThread();
+    ~PcapWriterThread();
+
+    /** The loop of the thread. */
+    void Run();
+    /**
+     * Write a batch.
+     * \param job The batch.
+     */
+    void Process(const Job& job);
+
+    /** The maximum number of bytes queued before Submit() blocks. */
+    static constexpr std::size_t MAX_QUEUED_BYTES = 64 * 1024 * 1024;
+
+    MpscQueue<Job> m_jobs;                     //!< The queued batches
+    std::atomic<std::size_t> m_queuedBytes;    //!< The number of bytes queued
+    std::atomic<bool> m_sleeping;              //!< Whether the thread waits for batches
+    bool m_stop;                               //!< Whether the thread must exit
+    std::mutex m_mutex;                        //!< Mutex protecting m_free and the waits
+    std::condition_variable m_wake;            //!< Wakes the thread up
+    std::condition_variable m_done;            //!< Signals that a batch was written
+    std::vector<std::vector<uint8_t>*> m_free; //!< The recycled batch buffers
+    std::thread m_thread;                      //!< The thread
+
+    static std::mutex g_instanceMutex;   //!< Mutex protecting the instance
+    static PcapWriterThread* g_instance; //!< The instance, if running
+    static uint32_t g_users;             //!< The number of writers registered
+};
+
+std::mutex PcapWriterThread::g_instanceMutex;
+PcapWriterThread* PcapWriterThread::g_instance = nullptr;
+uint32_t PcapWriterThread::g_users = 0;
+
+PcapWriterThread*
+PcapWriterThread::Acquire()
+{
+    std::unique_lock lock{g_instanceMutex};
+    if (g_instance == nullptr)
+    {
+        g_instance = new PcapWriterThread();
+    }
+    g_users++;
+    return g_instance;
+}
+
+void
+PcapWriterThread::Release()
+{
+    std::unique_lock lock{g_instanceMutex};
+    NS_ASSERT(g_users > 0);
+    if (--g_users == 0)
+    {
+        delete g_instance;
+        g_instance = nullptr;
+    }
+}
+
+PcapWriterThread::PcapWriterThread()
+    : m_jobs(1024),
+      m_queuedBytes(0),
+      m_sleeping(false),
+      m_stop(false)
+{
+    m_thread = std::thread(&PcapWriterThread::Run, this);
+}
+
+PcapWriterThread::~PcapWriterThread()
+{
+    {
+        std::unique_lock lock{m_mutex};
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    for (auto batch : m_free)
+    {
+        delete batch;
+    }
+}
+
+void
+PcapWriterThread::Submit(PcapAsyncWriter* writer, std::vector<uint8_t>* batch, std::size_t size)
+{
+    if (m_queuedBytes.load(std::memory_order_relaxed) > MAX_QUEUED_BYTES)
+    {
+        std::unique_lock lock{m_mutex};
+        m_done.wait(lock, [this] { return m_queuedBytes.load() <= MAX_QUEUED_BYTES; });
+    }
+    writer->m_pending++;
+    m_queuedBytes += size;
+    m_jobs.Push({writer, batch, size});
+    if (m_sleeping.load())
+    {
+        // Taking the mutex ensures the thread is either before its last
+        // check of the queue, or waiting
+        std::unique_lock lock{m_mutex};
+        m_wake.notify_one();
+    }
+}
+
+void
+PcapWriterThread::Wait(PcapAsyncWriter* writer)
+{
+    std::unique_lock lock{m_mutex};
+    m_done.wait(lock, [writer] { return writer->m_pending.load() == 0; });
+}
+
+std::vector<uint8_t>*
+PcapWriterThread::GetBuffer(std::size_t size)
+{
+    std::vector<uint8_t>* batch = nullptr;
+    {
+        std::unique_lock lock{m_mutex};
+        if (!m_free.empty())
+        {
+            batch = m_free.back();
+            m_free.pop_back();
+        }
+    }
+    if (batch == nullptr)
+    {
+        batch = new std::vector<uint8_t>();
+    }
+    if (batch->size() < size)
+    {
+        batch->resize(size);
+    }
+    return batch;
+}
+
+void
+PcapWriterThread::PutBuffer(std::vector<uint8_t>* batch)
+{
+    std::unique_lock lock{m_mutex};
+    m_free.push_back(batch);
+}
+
+void
+PcapWriterThread::Process(const Job& job)
+{
+    job.writer->WriteBatch(job.batch->data(), job.size);
+    m_queuedBytes -= job.size;
+    {
+        std::unique_lock lock{m_mutex};
+        m_free.push_back(job.batch);
+        // The writer may be destroyed as soon as this reaches zero
+        job.writer->m_pending--;
+    }
+    m_done.notify_all();
+}
+
+void
+PcapWriterThread::Run()
+{
+    while (true)
+    {
+        if (m_jobs.Drain([this](const Job& job) { Process(job); }) > 0)
+        {
+            continue;
+        }
+        std::unique_lock lock{m_mutex};
+        if (m_stop && m_jobs.IsEmpty())
+        {
+            break;
+        }
+        m_sleeping.store(true);
+        if (m_jobs.IsEmpty())
+        {
+            // The timeout bounds the delay of a wake up missed between the
+            // check above and Submit() testing m_sleeping
+            m_wake.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        m_sleeping.store(false);
+    }
+}
+
+PcapAsyncWriter::PcapAsyncWriter(const std::string& filename,
+                                 std::ios::openmode mode,
+                                 Compression compression,
+                                 bool background,
+                                 uint32_t batchSize)
+    : m_filename(filename),
+      m_thread(nullptr),
+      m_batch(nullptr),
+      m_used(0),
+      m_batchSize(batchSize),
+      m_background(background),
+      m_closed(false),
+      m_pending(0),
+      m_fail(false)
+{
+    NS_LOG_FUNCTION(this << filename << mode << compression << background << batchSize);
+    NS_ABORT_MSG_UNLESS(IsSupported(compression),
+                        "PcapAsyncWriter: compression " << compression
+                                                        << " is not supported by this build");
+    const char* suffix = compression == GZIP ? ".gz" : compression == ZSTD ? ".zst" : "";
+    std::string s(suffix);
+    if (m_filename.size() < s.size() ||
+        m_filename.compare(m_filename.size() - s.size(), s.size(), s) != 0)
+    {
+        m_filename += s;
+    }
+
+    switch (compression)
+    {
+#ifdef HAVE_ZLIB
+    case GZIP:
+        m_output = std::make_unique<GzipOutput>(m_filename, mode);
+        break;
+#endif
+#ifdef HAVE_ZSTD
+    case ZSTD:
+        m_output = std::make_unique<ZstdOutput>(m_filename, mode);
+        break;
+#endif
+    default:
+        m_output = std::make_unique<PcapOutput>(m_filename, mode);
+        break;
+    }
+    m_fail = !m_output->IsOpen();
+
+    if (m_background)
+    {
+        m_thread = PcapWriterThread::Acquire();
+        m_batch = m_thread->GetBuffer(m_batchSize);
+    }
+    else
+    {
+        m_batch = new std::vector<uint8_t>(m_batchSize);
+    }
+}
+
+PcapAsyncWriter::~PcapAsyncWriter()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+bool
+PcapAsyncWriter::IsSupported(Compression compression)
+{
+    switch (compression)
+    {
+    case NONE:
+        return true;
+    case GZIP:
+#ifdef HAVE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case ZSTD:
+#ifdef HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+bool
+PcapAsyncWriter::Fail() const
+{
+    return m_fail.load();
+}
+
+std::string
+PcapAsyncWriter::GetFilename() const
+{
+    return m_filename;
+}
+
+uint8_t*
+PcapAsyncWriter::Reserve(uint32_t size)
+{
+    NS_ASSERT(!m_closed);
+    if (m_used + size > m_batch->size())
+    {
+        Flush();
+        if (size > m_batch->size())
+        {
+            m_batch->resize(size);
+        }
+    }
+    uint8_t* start = m_batch->data() + m_used;
+    m_used += size;
+    return start;
+}
+
+void
+PcapAsyncWriter::Flush()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_used == 0)
+    {
+        return;
+    }
+    if (m_background)
+    {
+        m_thread->Submit(this, m_batch, m_used);
+        m_batch = m_thread->GetBuffer(m_batchSize);
+    }
+    else
+    {
+        WriteBatch(m_batch->data(), m_used);
+    }
+    m_used = 0;
+}
+
+void
+PcapAsyncWriter::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_closed)
+    {
+        return;
+    }
+    Flush();
+    if (m_background)
+    {
+        m_thread->Wait(this);
+        m_thread->PutBuffer(m_batch);
+        m_thread = nullptr;
+        PcapWriterThread::Release();
+    }
+    else
+    {
+        delete m_batch;
+    }
+    m_batch = nullptr;
+    if (!m_output->Close())
+    {
+        m_fail = true;
+    }
+    m_closed = true;
+}
+
+void
+PcapAsyncWriter::WriteBatch(const uint8_t* data, std::size_t size)
+{
+    if (!m_output->Write(data, size))
+    {
+        m_fail = true;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,148 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_ASYNC_WRITER_H
+#define PCAP_ASYNC_WRITER_H
+
+#include "ns3/simple-ref-count.h"
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class PcapOutput;
+class PcapWriterThread;
+
+/**
+ * \brief A buffered, optionally compressed, trace file writer.
+ *
+ * The records are serialized by the caller directly into a batch buffer,
+ * obtained with Reserve().  When the batch is full, or when Flush() is
+ * called, it is handed over to the output.  In background mode, the
+ * batches of all the writers are queued in a lock-free ring and written,
+ * and compressed if requested, by a single thread shared by all the
+ * writers, so that the simulation does not wait for the file system.
+ * Otherwise, the batches are written by the calling thread.
+ *
+ * The batches of a given writer are always written in order.  A writer
+ * must only be used by one thread at a time.
+ */
+class PcapAsyncWriter : public SimpleRefCount<PcapAsyncWriter>
+{
+  public:
+    /**
+     * The compression applied to the output.
+     */
+    enum Compression
+    {
+        NONE, //!< No compression
+        GZIP, //!< gzip (deflate) compression, with the ".gz" file name suffix
+        ZSTD  //!< Zstandard compression, with the ".zst" file name suffix
+    };
+
+    /**
+     * Open the output file.
+     *
+     * If a compression is requested, its suffix is appended to the file name
+     * unless it is already there.
+     *
+     * \param filename The name of the file.
+     * \param mode The access mode for the file; std::ios::binary is added.
+     * \param compression The compression of the output.
+     * \param background Whether the batches are written by the background thread.
+     * \param batchSize The size of the batches, in bytes.
+     */
+    PcapAsyncWriter(const std::string& filename,
+                    std::ios::openmode mode,
+                    Compression compression,
+                    bool background,
+                    uint32_t batchSize);
+    ~PcapAsyncWriter();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    PcapAsyncWriter(const PcapAsyncWriter&) = delete;
+    PcapAsyncWriter& operator=(const PcapAsyncWriter&) = delete;
+
+    /**
+     * \param compression A compression.
+     * \returns true if this build of ns-3 supports \p compression.
+     */
+    static bool IsSupported(Compression compression);
+
+    /**
+     * \return true if the file could not be opened, or if a batch could not be written.
+     */
+    bool Fail() const;
+
+    /**
+     * Get the name of the file, including the compression suffix.
+     * \returns the file name
+     */
+    std::string GetFilename() const;
+
+    /**
+     * Append bytes to the current batch.
+     *
+     * The current batch is flushed first if it cannot hold \p size more bytes.
+     *
+     * \param size The number of bytes.
+     * \returns a pointer to the \p size bytes, to be filled in before the
+     * next call to any other method of this writer.
+     */
+    uint8_t* Reserve(uint32_t size);
+
+    /**
+     * Hand the current batch over to the output.  In background mode, this
+     * returns before the batch is written.
+     */
+    void Flush();
+
+    /**
+     * Flush the current batch, wait until all the batches are written,
+     * and close the file.
+     */
+    void Close();
+
+  private:
+    friend class PcapWriterThread;
+
+    /**
+     * Write a batch to the output, and record any failure.
+     * \param data The batch.
+     * \param size The size of the batch.
+     */
+    void WriteBatch(const uint8_t* data, std::size_t size);
+
+    std::string m_filename;               //!< The file name
+    std::unique_ptr<PcapOutput> m_output; //!< The output, possibly compressing
+    PcapWriterThread* m_thread;           //!< The background thread, if used
+    std::vector<uint8_t>* m_batch;        //!< The current batch
+    std::size_t m_used;                   //!< The number of bytes used in the current batch
+    uint32_t m_batchSize;                 //!< The size of the batches
+    bool m_background;                    //!< Whether the batches are written in the background
+    bool m_closed;                        //!< Whether Close() was called
+    std::atomic<uint32_t> m_pending;      //!< The number of batches queued and not yet written
+    std::atomic<bool> m_fail;             //!< Whether an error occurred
+};
+
+} // namespace ns3
+
+#endif /* PCAP_ASYNC_WRITER_H */
@@ -17,12 +17,16 @@
 
 #include "pcap-file-wrapper.h"
 
+#include "ns3/abort.h"
 #include "ns3/boolean.h"
 #include "ns3/buffer.h"
+#include "ns3/enum.h"
 #include "ns3/header.h"
 #include "ns3/log.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -30,6 +34,56 @@ NS_LOG_COMPONENT_DEFINE("PcapFileWrapper");
 
 NS_OBJECT_ENSURE_REGISTERED(PcapFileWrapper);
 
+namespace
+{
+
+const uint32_t PCAP_MAGIC = 0xa1b2c3d4;              //!< pcap magic number, microsecond timestamps
+const uint32_t PCAP_NS_MAGIC = 0xa1b23c4d;           //!< pcap magic number, nanosecond timestamps
+const uint32_t PCAPNG_SHB = 0x0a0d0d0a;              //!< pcapng Section Header Block type
+const uint32_t PCAPNG_IDB = 0x00000001;              //!< pcapng Interface Description Block type
+const uint32_t PCAPNG_EPB = 0x00000006;              //!< pcapng Enhanced Packet Block type
+const uint32_t PCAPNG_BYTE_ORDER_MAGIC = 0x1a2b3c4d; //!< pcapng byte order magic
+
+/**
+ * Write a 16 bit value in little endian order, as PcapFile does.
+ * \param [in,out] p The write position, advanced past the value.
+ * \param v The value.
+ */
+inline void
+WriteU16(uint8_t*& p, uint16_t v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p += 2;
+}
+
+/**
+ * Write a 32 bit value in little endian order, as PcapFile does.
+ * \param [in,out] p The write position, advanced past the value.
+ * \param v The value.
+ */
+inline void
+WriteU32(uint8_t*& p, uint32_t v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    p[3] = (v >> 24) & 0xff;
+    p += 4;
+}
+
+/**
+ * \param len A length.
+ * \returns \p len rounded up to a multiple of 4, as pcapng blocks require.
+ */
+inline uint32_t
+Pad4(uint32_t len)
+{
+    return (len + 3) & ~3U;
+}
+
+} // namespace
+
 TypeId
 PcapFileWrapper::GetTypeId()
 {
@@ -48,11 +102,48 @@ PcapFileWrapper::GetTypeId()
                           "microseconds(default).",
                           BooleanValue(false),
                           MakeBooleanAccessor(&PcapFileWrapper::m_nanosecMode),
-                          MakeBooleanChecker());
+                          MakeBooleanChecker())
+            .AddAttribute("Asynchronous",
+                          "Whether the packets written are batched and written to the file by a "
+                          "background thread, instead of being written during the call to Write.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PcapFileWrapper::m_asynchronous),
+                          MakeBooleanChecker())
+            .AddAttribute("Format",
+                          "The format of the files written. The pcapng files have nanosecond "
+                          "timestamps.",
+                          EnumValue(PcapFileWrapper::PCAP),
+                          MakeEnumAccessor(&PcapFileWrapper::m_format),
+                          MakeEnumChecker(PcapFileWrapper::PCAP,
+                                          "Pcap",
+                                          PcapFileWrapper::PCAPNG,
+                                          "PcapNg"))
+            .AddAttribute("Compression",
+                          "The compression of the files written. The \".gz\" or \".zst\" suffix "
+                          "is appended to their name. Each is only available if ns-3 was "
+                          "built with zlib or zstd.",
+                          EnumValue(PcapAsyncWriter::NONE),
+                          MakeEnumAccessor(&PcapFileWrapper::m_compression),
+                          MakeEnumChecker(PcapAsyncWriter::NONE,
+                                          "None",
+                                          PcapAsyncWriter::GZIP,
+                                          "Gzip",
+                                          PcapAsyncWriter::ZSTD,
+                                          "Zstd"))
+            .AddAttribute("BufferSize",
+                          "The size in bytes of the batches of records written at once, "
+                          "unless the file is written in the pcap format, synchronously and "
+                          "without compression.",
+                          UintegerValue(256 * 1024),
+                          MakeUintegerAccessor(&PcapFileWrapper::m_bufferSize),
+                          MakeUintegerChecker<uint32_t>(4096));
     return tid;
 }
 
 PcapFileWrapper::PcapFileWrapper()
+    : m_fileSnapLen(0),
+      m_dataLinkType(0),
+      m_tzCorrection(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -67,6 +158,10 @@ bool
 PcapFileWrapper::Fail() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_writer)
+    {
+        return m_writer->Fail();
+    }
     return m_file.Fail();
 }
 
@@ -74,6 +169,10 @@ bool
 PcapFileWrapper::Eof() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_writer)
+    {
+        return false;
+    }
     return m_file.Eof();
 }
 
@@ -81,13 +180,22 @@ void
 PcapFileWrapper::Clear()
 {
     NS_LOG_FUNCTION(this);
-    m_file.Clear();
+    if (!m_writer)
+    {
+        m_file.Clear();
+    }
 }
 
 void
 PcapFileWrapper::Close()
 {
     NS_LOG_FUNCTION(this);
+    if (m_writer)
+    {
+        // Keep the writer, so that Fail() reports the errors of the last batches
+        m_writer->Close();
+        return;
+    }
     m_file.Close();
 }
 
@@ -95,7 +203,26 @@ void
 PcapFileWrapper::Open(const std::string& filename, std::ios::openmode mode)
 {
     NS_LOG_FUNCTION(this << filename << mode);
-    m_file.Open(filename, mode);
+    m_writer = nullptr;
+    if ((mode & std::ios::in) ||
+        (!m_asynchronous && m_format == PCAP && m_compression == PcapAsyncWriter::NONE))
+    {
+        m_file.Open(filename, mode);
+        return;
+    }
+    NS_ABORT_MSG_UNLESS(PcapAsyncWriter::IsSupported(m_compression),
+                        "PcapFileWrapper: the requested compression is not supported by this "
+                        "build, check that ns-3 was configured with zlib or zstd");
+    m_writer = Create<PcapAsyncWriter>(filename, mode, m_compression, m_asynchronous, m_bufferSize);
+
+    // Name the pcapng interface after the file, e.g. "prefix-0-1" for "dir/prefix-0-1.pcap"
+    std::string::size_type slash = filename.find_last_of("/\\");
+    m_interfaceName = slash == std::string::npos ? filename : filename.substr(slash + 1);
+    std::string::size_type dot = m_interfaceName.rfind('.');
+    if (dot != std::string::npos && dot > 0)
+    {
+        m_interfaceName.erase(dot);
+    }
 }
 
 void
@@ -107,6 +234,14 @@ PcapFileWrapper::Init(uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrect
     // a snaplen, we use the one provided.
     //
     NS_LOG_FUNCTION(this << dataLinkType << snapLen << tzCorrection);
+    if (m_writer)
+    {
+        m_fileSnapLen = snapLen != std::numeric_limits<uint32_t>::max() ? snapLen : m_snapLen;
+        m_dataLinkType = dataLinkType;
+        m_tzCorrection = tzCorrection;
+        WriteFileHeader();
+        return;
+    }
     if (snapLen != std::numeric_limits<uint32_t>::max())
     {
         m_file.Init(dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
@@ -117,10 +252,103 @@ PcapFileWrapper::Init(uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrect
     }
 }
 
+void
+PcapFileWrapper::WriteFileHeader()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_format == PCAP)
+    {
+        uint8_t* h = m_writer->Reserve(24);
+        WriteU32(h, m_nanosecMode ? PCAP_NS_MAGIC : PCAP_MAGIC);
+        WriteU16(h, 2);
+        WriteU16(h, 4);
+        WriteU32(h, static_cast<uint32_t>(m_tzCorrection));
+        WriteU32(h, 0);
+        WriteU32(h, m_fileSnapLen);
+        WriteU32(h, m_dataLinkType);
+        return;
+    }
+
+    // Section Header Block, with an unspecified section length
+    uint8_t* h = m_writer->Reserve(28);
+    WriteU32(h, PCAPNG_SHB);
+    WriteU32(h, 28);
+    WriteU32(h, PCAPNG_BYTE_ORDER_MAGIC);
+    WriteU16(h, 1);
+    WriteU16(h, 0);
+    WriteU32(h, 0xffffffff);
+    WriteU32(h, 0xffffffff);
+    WriteU32(h, 28);
+
+    // Interface Description Block, with the if_name and if_tsresol options
+    uint32_t nameLen = m_interfaceName.size();
+    uint32_t blockLen = 20 + 4 + Pad4(nameLen) + 8 + 4;
+    uint8_t* start = m_writer->Reserve(blockLen);
+    std::memset(start, 0, blockLen);
+    h = start;
+    WriteU32(h, PCAPNG_IDB);
+    WriteU32(h, blockLen);
+    WriteU16(h, static_cast<uint16_t>(m_dataLinkType));
+    WriteU16(h, 0);
+    WriteU32(h, m_fileSnapLen);
+    WriteU16(h, 2);
+    WriteU16(h, static_cast<uint16_t>(nameLen));
+    std::memcpy(h, m_interfaceName.data(), nameLen);
+    h += Pad4(nameLen);
+    WriteU16(h, 9);
+    WriteU16(h, 1);
+    *h = 9; // 10^-9 s
+    h += 4;
+    WriteU32(h, 0); // opt_endofopt
+    WriteU32(h, blockLen);
+}
+
+uint8_t*
+PcapFileWrapper::ReserveRecord(Time t, uint32_t totalLen, uint32_t& inclLen)
+{
+    inclLen = std::min(totalLen, m_fileSnapLen);
+    if (m_format == PCAP)
+    {
+        uint8_t* h = m_writer->Reserve(16 + inclLen);
+        uint64_t current = m_nanosecMode ? t.GetNanoSeconds() : t.GetMicroSeconds();
+        uint64_t unit = m_nanosecMode ? 1000000000 : 1000000;
+        WriteU32(h, static_cast<uint32_t>(current / unit));
+        WriteU32(h, static_cast<uint32_t>(current % unit));
+        WriteU32(h, inclLen);
+        WriteU32(h, totalLen);
+        return h;
+    }
+
+    // Enhanced Packet Block on interface 0, without options
+    uint32_t padded = Pad4(inclLen);
+    uint32_t blockLen = 28 + padded + 4;
+    uint8_t* h = m_writer->Reserve(blockLen);
+    uint64_t ns = t.GetNanoSeconds();
+    WriteU32(h, PCAPNG_EPB);
+    WriteU32(h, blockLen);
+    WriteU32(h, 0);
+    WriteU32(h, static_cast<uint32_t>(ns >> 32));
+    WriteU32(h, static_cast<uint32_t>(ns));
+    WriteU32(h, inclLen);
+    WriteU32(h, totalLen);
+    uint8_t* trailer = h + inclLen;
+    std::memset(trailer, 0, padded - inclLen);
+    trailer += padded - inclLen;
+    WriteU32(trailer, blockLen);
+    return h;
+}
+
 void
 PcapFileWrapper::Write(Time t, Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(this << t << p);
+    if (m_writer)
+    {
+        uint32_t inclLen;
+        uint8_t* data = ReserveRecord(t, p->GetSize(), inclLen);
+        p->CopyData(data, inclLen);
+        return;
+    }
     if (m_file.IsNanoSecMode())
     {
         uint64_t current = t.GetNanoSeconds();
@@ -141,6 +369,19 @@ void
 PcapFileWrapper::Write(Time t, const Header& header, Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(this << t << &header << p);
+    if (m_writer)
+    {
+        uint32_t headerSize = header.GetSerializedSize();
+        uint32_t inclLen;
+        uint8_t* data = ReserveRecord(t, headerSize + p->GetSize(), inclLen);
+        Buffer headerBuffer;
+        headerBuffer.AddAtStart(headerSize);
+        header.Serialize(headerBuffer.Begin());
+        uint32_t toCopy = std::min(headerSize, inclLen);
+        headerBuffer.CopyData(data, toCopy);
+        p->CopyData(data + toCopy, inclLen - toCopy);
+        return;
+    }
     if (m_file.IsNanoSecMode())
     {
         uint64_t current = t.GetNanoSeconds();
@@ -161,6 +402,13 @@ void
 PcapFileWrapper::Write(Time t, const uint8_t* buffer, uint32_t length)
 {
     NS_LOG_FUNCTION(this << t << &buffer << length);
+    if (m_writer)
+    {
+        uint32_t inclLen;
+        uint8_t* data = ReserveRecord(t, length, inclLen);
+        std::memcpy(data, buffer, inclLen);
+        return;
+    }
     if (m_file.IsNanoSecMode())
     {
         uint64_t current = t.GetNanoSeconds();
@@ -211,6 +459,14 @@ uint32_t
 PcapFileWrapper::GetMagic()
 {
     NS_LOG_FUNCTION(this);
+    if (m_writer)
+    {
+        if (m_format == PCAPNG)
+        {
+            return PCAPNG_BYTE_ORDER_MAGIC;
+        }
+        return m_nanosecMode ? PCAP_NS_MAGIC : PCAP_MAGIC;
+    }
     return m_file.GetMagic();
 }
 
@@ -218,6 +474,10 @@ uint16_t
 PcapFileWrapper::GetVersionMajor()
 {
     NS_LOG_FUNCTION(this);
+    if (m_writer)
+    {
+        return m_format == PCAPNG ? 1 : 2;
+    }
     return m_file.GetVersionMajor();
 }
 
@@ -225,6 +485,10 @@ uint16_t
 PcapFileWrapper::GetVersionMinor()
 {
     NS_LOG_FUNCTION(this);
+    if (m_writer)
+    {
+        return m_format == PCAPNG ? 0 : 4;
+    }
     return m_file.GetVersionMinor();
 }
 
@@ -232,6 +496,10 @@ int32_t
 PcapFileWrapper::GetTimeZoneOffset()
 {
     NS_LOG_FUNCTION(this);
+    if (m_writer)
+    {
+        return m_tzCorrection;
+    }
     return m_file.GetTimeZoneOffset();
 }
 
@@ -239,6 +507,10 @@ uint32_t
 PcapFileWrapper::GetSigFigs()
 {
     NS_LOG_FUNCTION(this);
+    if (m_writer)
+    {
+        return 0;
+    }
     return m_file.GetSigFigs();
 }
 
@@ -246,6 +518,10 @@ uint32_t
 PcapFileWrapper::GetSnapLen()
 {
     NS_LOG_FUNCTION(this);
+    if (m_writer)
+    {
+        return m_fileSnapLen;
+    }
     return m_file.GetSnapLen();
 }
 
@@ -253,6 +529,10 @@ uint32_t
 PcapFileWrapper::GetDataLinkType()
 {
     NS_LOG_FUNCTION(this);
+    if (m_writer)
+    {
+        return m_dataLinkType;
+    }
     return m_file.GetDataLinkType();
 }
 
@@ -18,6 +18,7 @@
 #ifndef PCAP_FILE_WRAPPER_H
 #define PCAP_FILE_WRAPPER_H
 
+#include "pcap-async-writer.h"
 #include "pcap-file.h"
 
 #include "ns3/nstime.h"
@@ -37,10 +38,31 @@ namespace ns3
  * ns-3 interface to the low-level public methods of PcapFile.  Users are
  * encouraged to use this object instead of class ns3::PcapFile in ns-3
  * public APIs.
+ *
+ * When a file is opened for writing, the "Asynchronous", "Format" and
+ * "Compression" attributes select how the packets are written.  By default,
+ * each packet is written to a pcap file by PcapFile, during the call to
+ * Write().  Otherwise, the records are serialized into batches handed over
+ * to a PcapAsyncWriter, which writes them on a background thread if
+ * "Asynchronous" is true.  The files can then be written in the pcapng
+ * format, with a single interface named after the file and nanosecond
+ * timestamps, and compressed with gzip or Zstandard, in which case the
+ * ".gz" or ".zst" suffix is appended to the file name.  As PcapHelper
+ * creates its files with these attributes, setting their default values
+ * applies to all the pcap traces enabled through the helpers.
  */
 class PcapFileWrapper : public Object
 {
   public:
+    /**
+     * The format of the files written.
+     */
+    enum Format
+    {
+        PCAP,  //!< The libpcap format
+        PCAPNG //!< The pcapng format
+    };
+
     /**
      * \brief Get the type ID.
      * \return the object TypeId
@@ -222,9 +244,33 @@ class PcapFileWrapper : public Object
     uint32_t GetDataLinkType();
 
   private:
-    PcapFile m_file;    //!< Pcap file
-    uint32_t m_snapLen; //!< max length of saved packets
-    bool m_nanosecMode; //!< Timestamps in nanosecond mode
+    /**
+     * \brief Write the file header to the batched writer.
+     */
+    void WriteFileHeader();
+
+    /**
+     * \brief Reserve a record in the batched writer, and fill in its framing.
+     *
+     * \param t Packet timestamp as ns3::Time.
+     * \param totalLen The length of the packet.
+     * \param inclLen [out] The number of bytes of the packet to store.
+     * \returns a pointer to the \p inclLen bytes to fill in with the packet.
+     */
+    uint8_t* ReserveRecord(Time t, uint32_t totalLen, uint32_t& inclLen);
+
+    PcapFile m_file;                            //!< Pcap file
+    uint32_t m_snapLen;                         //!< max length of saved packets
+    bool m_nanosecMode;                         //!< Timestamps in nanosecond mode
+    bool m_asynchronous;                        //!< Write the batches in the background
+    Format m_format;                            //!< Format of the files written
+    PcapAsyncWriter::Compression m_compression; //!< Compression of the files written
+    uint32_t m_bufferSize;                      //!< Size of the batches
+    Ptr<PcapAsyncWriter> m_writer;              //!< Batched writer, if used instead of m_file
+    std::string m_interfaceName;                //!< Interface name, for the pcapng format
+    uint32_t m_fileSnapLen;                     //!< Snap length of the batched file
+    uint32_t m_dataLinkType;                    //!< Data link type of the batched file
+    int32_t m_tzCorrection;                     //!< Time zone correction of the batched file
 };
 
 } // namespace ns3
@@ -0,0 +1,227 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "cached-propagation-loss-model.h"
+
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/pointer.h"
+#include "ns3/uinteger.h"
+
+#include <functional>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CachedPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED(CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CachedPropagationLossModel")
+            .SetParent<PropagationLossModel>()
+            .SetGroupName("Propagation")
+            .AddConstructor<CachedPropagationLossModel>()
+            .AddAttribute("PropagationLossModel",
+                          "The propagation loss model whose results are cached.",
+                          PointerValue(),
+                          MakePointerAccessor(&CachedPropagationLossModel::SetPropagationLossModel,
+                                              &CachedPropagationLossModel::GetPropagationLossModel),
+                          MakePointerChecker<PropagationLossModel>())
+            .AddAttribute("MaxEntries",
+                          "The maximum number of entries in the cache. The least recently "
+                          "used entries are evicted beyond.",
+                          UintegerValue(65536),
+                          MakeUintegerAccessor(&CachedPropagationLossModel::m_maxEntries),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("CacheRandomModels",
+                          "Whether to cache the results of the propagation loss models "
+                          "which are not deterministic, e.g., which draw a random fading "
+                          "at each call. If true, the first value drawn for a link is "
+                          "kept until one of its ends moves, which changes the results "
+                          "of the simulation.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&CachedPropagationLossModel::m_cacheRandom),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+CachedPropagationLossModel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Clear();
+    m_model = nullptr;
+    PropagationLossModel::DoDispose();
+}
+
+void
+CachedPropagationLossModel::SetPropagationLossModel(Ptr<PropagationLossModel> model)
+{
+    NS_LOG_FUNCTION(this << model);
+    m_model = model;
+    Clear();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetPropagationLossModel() const
+{
+    return m_model;
+}
+
+void
+CachedPropagationLossModel::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& [model, tracked] : m_tracked)
+    {
+        tracked.mobility->TraceDisconnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&CachedPropagationLossModel::CourseChanged, this));
+    }
+    m_tracked.clear();
+    m_index.clear();
+    m_entries.clear();
+}
+
+std::size_t
+CachedPropagationLossModel::GetNEntries() const
+{
+    return m_entries.size();
+}
+
+bool
+CachedPropagationLossModel::Key::operator==(const Key& other) const
+{
+    return a == other.a && b == other.b && txPowerDbm == other.txPowerDbm;
+}
+
+std::size_t
+CachedPropagationLossModel::KeyHash::operator()(const Key& key) const
+{
+    std::size_t h = std::hash<const void*>()(key.a);
+    h ^= std::hash<const void*>()(key.b) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h ^= std::hash<double>()(key.txPowerDbm) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+CachedPropagationLossModel::Tracked&
+CachedPropagationLossModel::Track(Ptr<MobilityModel> mobility) const
+{
+    auto [it, inserted] = m_tracked.try_emplace(PeekPointer(mobility));
+    if (inserted)
+    {
+        it->second.mobility = mobility;
+        it->second.epoch = 0;
+        mobility->TraceConnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&CachedPropagationLossModel::CourseChanged,
+                         const_cast<CachedPropagationLossModel*>(this)));
+    }
+    return it->second;
+}
+
+void
+CachedPropagationLossModel::CourseChanged(Ptr<const MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << mobility);
+    auto it = m_tracked.find(PeekPointer(mobility));
+    if (it != m_tracked.end())
+    {
+        // the entries of the model become stale, and are recomputed or evicted lazily
+        ++it->second.epoch;
+    }
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower(double txPowerDbm,
+                                          Ptr<MobilityModel> a,
+                                          Ptr<MobilityModel> b) const
+{
+    NS_ASSERT_MSG(m_model, "No propagation loss model to cache");
+    if ((!m_cacheRandom && !m_model->IsDeterministic()) || a->GetVelocity().GetLength() > 0 ||
+        b->GetVelocity().GetLength() > 0)
+    {
+        return m_model->CalcRxPower(txPowerDbm, a, b);
+    }
+
+    uint32_t epochA = Track(a).epoch;
+    uint32_t epochB = Track(b).epoch;
+    Key key{PeekPointer(a), PeekPointer(b), txPowerDbm};
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        Entry& entry = *it->second;
+        if (entry.epochA != epochA || entry.epochB != epochB)
+        {
+            NS_LOG_LOGIC("stale entry");
+            entry.rxPowerDbm = m_model->CalcRxPower(txPowerDbm, a, b);
+            entry.epochA = epochA;
+            entry.epochB = epochB;
+        }
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return entry.rxPowerDbm;
+    }
+
+    if (m_entries.size() >= m_maxEntries)
+    {
+        NS_LOG_LOGIC("evicting the least recently used entry");
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+    }
+    double rxPowerDbm = m_model->CalcRxPower(txPowerDbm, a, b);
+    m_entries.push_front(Entry{key, rxPowerDbm, epochA, epochB});
+    m_index.emplace(key, m_entries.begin());
+    return rxPowerDbm;
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams(int64_t stream)
+{
+    return m_model ? m_model->AssignStreams(stream) : 0;
+}
+
+double
+CachedPropagationLossModel::DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const
+{
+    if (!m_model)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return m_model->GetMaxRange(txPowerDbm, minRxPowerDbm);
+}
+
+bool
+CachedPropagationLossModel::DoIsDeterministic() const
+{
+    return m_model && m_model->IsDeterministic();
+}
+
+} // namespace ns3
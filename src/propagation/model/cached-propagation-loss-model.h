@@ -0,0 +1,164 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CACHED_PROPAGATION_LOSS_MODEL_H
+#define CACHED_PROPAGATION_LOSS_MODEL_H
+
+#include "propagation-loss-model.h"
+
+#include <list>
+#include <unordered_map>
+
+namespace ns3
+{
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Memoizes the reception power computed by another propagation loss model.
+ *
+ * The reception power computed by the wrapped model, and by the models
+ * chained to it, is stored for each (transmitter, receiver, transmission
+ * power) triple, as long as neither the transmitter nor the receiver moves.
+ * The entries of a mobility model are invalidated when it notifies a
+ * course change, and the mobility models with a non-null velocity are never
+ * cached.  The least recently used entries are evicted when the cache holds
+ * MaxEntries entries.
+ *
+ * A cached reception power is only valid if the wrapped models are
+ * deterministic, see PropagationLossModel::IsDeterministic.  The other
+ * models, e.g., those drawing a random fading at each call, are not cached
+ * unless CacheRandomModels is set, in which case the first value drawn for a
+ * link is kept until one of its ends moves.
+ *
+ * The carrier frequency is a parameter of the wrapped model, hence a
+ * channel carrying several frequencies needs one cache per frequency.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    CachedPropagationLossModel();
+    ~CachedPropagationLossModel() override;
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    CachedPropagationLossModel(const CachedPropagationLossModel&) = delete;
+    CachedPropagationLossModel& operator=(const CachedPropagationLossModel&) = delete;
+
+    /**
+     * \param model the propagation loss model whose results are cached
+     */
+    void SetPropagationLossModel(Ptr<PropagationLossModel> model);
+
+    /**
+     * \returns the propagation loss model whose results are cached
+     */
+    Ptr<PropagationLossModel> GetPropagationLossModel() const;
+
+    /**
+     * Remove all the entries of the cache.
+     */
+    void Clear();
+
+    /**
+     * \returns the number of entries in the cache
+     */
+    std::size_t GetNEntries() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    double DoCalcRxPower(double txPowerDbm,
+                         Ptr<MobilityModel> a,
+                         Ptr<MobilityModel> b) const override;
+    int64_t DoAssignStreams(int64_t stream) override;
+    double DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const override;
+    bool DoIsDeterministic() const override;
+
+    /// The key of a cache entry
+    struct Key
+    {
+        const MobilityModel* a; //!< the mobility model of the transmitter
+        const MobilityModel* b; //!< the mobility model of the receiver
+        double txPowerDbm;      //!< the transmission power (dBm)
+
+        /**
+         * \param other another key
+         * \returns true if both keys are equal
+         */
+        bool operator==(const Key& other) const;
+    };
+
+    /// Hash function of the keys
+    struct KeyHash
+    {
+        /**
+         * \param key a key
+         * \returns the hash of the key
+         */
+        std::size_t operator()(const Key& key) const;
+    };
+
+    /// A cache entry
+    struct Entry
+    {
+        Key key;           //!< the key
+        double rxPowerDbm; //!< the reception power (dBm)
+        uint32_t epochA;   //!< the epoch of the transmitter when computed
+        uint32_t epochB;   //!< the epoch of the receiver when computed
+    };
+
+    /// A mobility model of a cached link
+    struct Tracked
+    {
+        Ptr<MobilityModel> mobility; //!< the mobility model, kept alive while tracked
+        uint32_t epoch;              //!< the number of course changes notified
+    };
+
+    /**
+     * Get the tracked mobility model, and start tracking it if needed.
+     * \param mobility the mobility model
+     * \returns the tracked mobility model
+     */
+    Tracked& Track(Ptr<MobilityModel> mobility) const;
+
+    /**
+     * Invalidate the entries of a mobility model. Connected to the
+     * CourseChange trace source.
+     * \param mobility the mobility model
+     */
+    void CourseChanged(Ptr<const MobilityModel> mobility);
+
+    Ptr<PropagationLossModel> m_model; //!< the propagation loss model whose results are cached
+    uint32_t m_maxEntries;             //!< the maximum number of entries
+    bool m_cacheRandom;                //!< whether non-deterministic models are cached
+
+    /// the entries, from the most recently used
+    mutable std::list<Entry> m_entries;
+    /// the entries, by key
+    mutable std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+    /// the mobility models of the cached links
+    mutable std::unordered_map<const MobilityModel*, Tracked> m_tracked;
+};
+
+} // namespace ns3
+
+#endif /* CACHED_PROPAGATION_LOSS_MODEL_H */
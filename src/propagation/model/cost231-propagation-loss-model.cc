@@ -189,4 +189,10 @@ Cost231PropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+bool
+Cost231PropagationLossModel::DoIsDeterministic() const
+{
+    return true;
+}
+
 } // namespace ns3
@@ -109,4 +109,10 @@ ItuR1411LosPropagationLossModel::DoAssignStreams(int64_t stream)
 {
     return 0;
 }
+
+bool
+ItuR1411LosPropagationLossModel::DoIsDeterministic() const
+{
+    return true;
+}
 } // namespace ns3
@@ -78,6 +78,7 @@ class ItuR1411LosPropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> b) const override;
 
     int64_t DoAssignStreams(int64_t stream) override;
+    bool DoIsDeterministic() const override;
 
     double m_lambda; //!< wavelength
 };
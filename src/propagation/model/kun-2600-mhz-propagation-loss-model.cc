@@ -76,4 +76,10 @@ Kun2600MhzPropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+bool
+Kun2600MhzPropagationLossModel::DoIsDeterministic() const
+{
+    return true;
+}
+
 } // namespace ns3
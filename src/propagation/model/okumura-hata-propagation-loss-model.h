@@ -69,6 +69,7 @@ class OkumuraHataPropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> a,
                          Ptr<MobilityModel> b) const override;
     int64_t DoAssignStreams(int64_t stream) override;
+    bool DoIsDeterministic() const override;
 
     EnvironmentType m_environment; //!< Environment Scenario
     CitySize m_citySize;           //!< Size of the city
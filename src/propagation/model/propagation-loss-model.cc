@@ -30,6 +30,8 @@
 #include "ns3/string.h"
 
 #include <cmath>
+#include <limits>
+#include <vector>
 
 namespace ns3
 {
@@ -82,6 +84,72 @@ PropagationLossModel::CalcRxPower(double txPowerDbm,
     return self;
 }
 
+double
+PropagationLossModel::GetMaxRange(double txPowerDbm, double minRxPowerDbm) const
+{
+    // Each model of the chain sees at most the transmission power plus the maximum
+    // gains of the models before it, and the signal must leave it above the threshold
+    // minus the maximum gains of the models after it to be received above the threshold.
+    std::vector<const PropagationLossModel*> chain;
+    std::vector<double> gains;
+    for (const PropagationLossModel* model = this; model; model = PeekPointer(model->m_next))
+    {
+        chain.push_back(model);
+        gains.push_back(model->DoGetMaxGain());
+    }
+    double remainingGain = 0;
+    for (std::size_t i = 1; i < gains.size(); ++i)
+    {
+        remainingGain += gains[i];
+    }
+    double range = std::numeric_limits<double>::infinity();
+    double maxInputDbm = txPowerDbm;
+    for (std::size_t i = 0; i < chain.size(); ++i)
+    {
+        double thresholdDbm = minRxPowerDbm - remainingGain;
+        range = std::min(range, chain[i]->DoGetMaxRange(maxInputDbm, thresholdDbm));
+        maxInputDbm += gains[i];
+        if (i + 1 < chain.size())
+        {
+            remainingGain -= gains[i + 1];
+        }
+    }
+    NS_LOG_DEBUG("txPower=" << txPowerDbm << "dBm, minRxPower=" << minRxPowerDbm
+                            << "dBm, range=" << range << "m");
+    return range;
+}
+
+bool
+PropagationLossModel::IsDeterministic() const
+{
+    for (const PropagationLossModel* model = this; model; model = PeekPointer(model->m_next))
+    {
+        if (!model->DoIsDeterministic())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+double
+PropagationLossModel::DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const
+{
+    return std::numeric_limits<double>::infinity();
+}
+
+double
+PropagationLossModel::DoGetMaxGain() const
+{
+    return std::numeric_limits<double>::infinity();
+}
+
+bool
+PropagationLossModel::DoIsDeterministic() const
+{
+    return false;
+}
+
 int64_t
 PropagationLossModel::AssignStreams(int64_t stream)
 {
@@ -287,6 +355,31 @@ FriisPropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+double
+FriisPropagationLossModel::DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const
+{
+    double maxLossDb = txPowerDbm - minRxPowerDbm;
+    if (m_minLoss > maxLossDb)
+    {
+        return 0;
+    }
+    // invert lossDb = 20 log10 (4 * pi * d / lambda) + 10 log10 (L)
+    double systemLossDb = 10 * std::log10(m_systemLoss);
+    return m_lambda / (4 * M_PI) * std::pow(10, (maxLossDb - systemLossDb) / 20);
+}
+
+double
+FriisPropagationLossModel::DoGetMaxGain() const
+{
+    return -m_minLoss;
+}
+
+bool
+FriisPropagationLossModel::DoIsDeterministic() const
+{
+    return true;
+}
+
 // ------------------------------------------------------------------------- //
 // -- Two-Ray Ground Model ported from NS-2 -- tomhewer@mac.com -- Nov09 //
 
@@ -468,6 +561,33 @@ TwoRayGroundPropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+double
+TwoRayGroundPropagationLossModel::DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const
+{
+    // Beyond the crossover distance, the two-ray loss is larger than the Friis loss,
+    // hence the Friis range bounds the range whatever the antenna heights
+    double systemLossDb = 10 * std::log10(m_systemLoss);
+    double friisRange =
+        m_lambda / (4 * M_PI) * std::pow(10, (txPowerDbm - minRxPowerDbm - systemLossDb) / 20);
+    return std::max(m_minDistance, friisRange);
+}
+
+double
+TwoRayGroundPropagationLossModel::DoGetMaxGain() const
+{
+    // the Friis gain is the largest just beyond the minimum distance
+    double friisGainDb =
+        10 * std::log10(m_lambda * m_lambda /
+                        (16 * M_PI * M_PI * m_minDistance * m_minDistance * m_systemLoss));
+    return std::max(0.0, friisGainDb);
+}
+
+bool
+TwoRayGroundPropagationLossModel::DoIsDeterministic() const
+{
+    return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED(LogDistancePropagationLossModel);
@@ -560,6 +680,37 @@ LogDistancePropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+double
+LogDistancePropagationLossModel::DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const
+{
+    if (m_exponent <= 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    double maxLossDb = txPowerDbm - minRxPowerDbm;
+    if (m_referenceLoss > maxLossDb)
+    {
+        return 0;
+    }
+    return m_referenceDistance * std::pow(10, (maxLossDb - m_referenceLoss) / (10 * m_exponent));
+}
+
+double
+LogDistancePropagationLossModel::DoGetMaxGain() const
+{
+    if (m_exponent < 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return -m_referenceLoss;
+}
+
+bool
+LogDistancePropagationLossModel::DoIsDeterministic() const
+{
+    return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED(ThreeLogDistancePropagationLossModel);
@@ -659,6 +810,53 @@ ThreeLogDistancePropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+double
+ThreeLogDistancePropagationLossModel::DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const
+{
+    if (m_exponent0 < 0 || m_exponent1 < 0 || m_exponent2 <= 0 || m_distance1 < m_distance0 ||
+        m_distance2 < m_distance1)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    // the loss is zero below the first distance field, and increases beyond
+    double maxLossDb = txPowerDbm - minRxPowerDbm;
+    if (maxLossDb < 0 && maxLossDb < m_referenceLoss)
+    {
+        return 0;
+    }
+    if (maxLossDb < m_referenceLoss)
+    {
+        return m_distance0;
+    }
+    double lossDb1 = m_referenceLoss + 10 * m_exponent0 * std::log10(m_distance1 / m_distance0);
+    if (maxLossDb < lossDb1)
+    {
+        return m_distance0 * std::pow(10, (maxLossDb - m_referenceLoss) / (10 * m_exponent0));
+    }
+    double lossDb2 = lossDb1 + 10 * m_exponent1 * std::log10(m_distance2 / m_distance1);
+    if (maxLossDb < lossDb2)
+    {
+        return m_distance1 * std::pow(10, (maxLossDb - lossDb1) / (10 * m_exponent1));
+    }
+    return m_distance2 * std::pow(10, (maxLossDb - lossDb2) / (10 * m_exponent2));
+}
+
+double
+ThreeLogDistancePropagationLossModel::DoGetMaxGain() const
+{
+    if (m_exponent0 < 0 || m_exponent1 < 0 || m_exponent2 < 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return std::max(0.0, -m_referenceLoss);
+}
+
+bool
+ThreeLogDistancePropagationLossModel::DoIsDeterministic() const
+{
+    return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED(NakagamiPropagationLossModel);
@@ -824,6 +1022,12 @@ FixedRssLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+bool
+FixedRssLossModel::DoIsDeterministic() const
+{
+    return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED(MatrixPropagationLossModel);
@@ -909,6 +1113,12 @@ MatrixPropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+bool
+MatrixPropagationLossModel::DoIsDeterministic() const
+{
+    return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED(RangePropagationLossModel);
@@ -954,6 +1164,28 @@ RangePropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+double
+RangePropagationLossModel::DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const
+{
+    if (minRxPowerDbm <= -1000)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return txPowerDbm < minRxPowerDbm ? 0 : m_range;
+}
+
+double
+RangePropagationLossModel::DoGetMaxGain() const
+{
+    return 0;
+}
+
+bool
+RangePropagationLossModel::DoIsDeterministic() const
+{
+    return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 } // namespace ns3
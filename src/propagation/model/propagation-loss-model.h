@@ -101,6 +101,31 @@ class PropagationLossModel : public Object
      */
     double CalcRxPower(double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
 
+    /**
+     * Get a distance beyond which the reception power computed by this model,
+     * and by the models chained to it, is always below a threshold.  Channels
+     * use it to skip the receivers that are out of range without computing
+     * their propagation loss.
+     *
+     * The distance is infinite if any model in the chain cannot bound its
+     * loss, e.g., because the loss is random.
+     *
+     * \param txPowerDbm the transmission power (in dBm)
+     * \param minRxPowerDbm the reception power threshold (in dBm)
+     * \returns the distance (in meters), possibly infinite
+     */
+    double GetMaxRange(double txPowerDbm, double minRxPowerDbm) const;
+
+    /**
+     * Check whether the reception power computed by this model, and by the
+     * models chained to it, only depends on the transmission power and on the
+     * mobility models, i.e., whether it can be cached until one of the nodes
+     * moves.
+     *
+     * \returns true if all the models in the chain are deterministic
+     */
+    bool IsDeterministic() const;
+
     /**
      * If this loss model uses objects of type RandomVariableStream,
      * set the stream numbers to the integers starting with the offset
@@ -139,6 +164,41 @@ class PropagationLossModel : public Object
                                  Ptr<MobilityModel> a,
                                  Ptr<MobilityModel> b) const = 0;
 
+    /**
+     * Get a distance beyond which DoCalcRxPower returns less than
+     * \p minRxPowerDbm for any transmission power up to \p txPowerDbm.
+     *
+     * The default implementation returns infinity, which is correct for
+     * every model.
+     *
+     * \param txPowerDbm the maximum transmission power (in dBm)
+     * \param minRxPowerDbm the reception power threshold (in dBm)
+     * \returns the distance (in meters), possibly infinite
+     */
+    virtual double DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const;
+
+    /**
+     * Get an upper bound of the difference between the value returned by
+     * DoCalcRxPower and the transmission power, for any distance.
+     *
+     * The default implementation returns infinity, which is correct for
+     * every model.
+     *
+     * \returns the maximum gain (in dB), possibly infinite
+     */
+    virtual double DoGetMaxGain() const;
+
+    /**
+     * Check whether DoCalcRxPower only depends on its parameters and on the
+     * positions of the mobility models.
+     *
+     * The default implementation returns false, which is correct for every
+     * model.
+     *
+     * \returns true if the model is deterministic
+     */
+    virtual bool DoIsDeterministic() const;
+
     Ptr<PropagationLossModel> m_next; //!< Next propagation loss model in the list
 };
 
@@ -304,6 +364,9 @@ class FriisPropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> a,
                          Ptr<MobilityModel> b) const override;
     int64_t DoAssignStreams(int64_t stream) override;
+    double DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const override;
+    double DoGetMaxGain() const override;
+    bool DoIsDeterministic() const override;
 
     /**
      * Transforms a Dbm value to Watt
@@ -414,6 +477,9 @@ class TwoRayGroundPropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> a,
                          Ptr<MobilityModel> b) const override;
     int64_t DoAssignStreams(int64_t stream) override;
+    double DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const override;
+    double DoGetMaxGain() const override;
+    bool DoIsDeterministic() const override;
 
     /**
      * Transforms a Dbm value to Watt
@@ -493,6 +559,9 @@ class LogDistancePropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> b) const override;
 
     int64_t DoAssignStreams(int64_t stream) override;
+    double DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const override;
+    double DoGetMaxGain() const override;
+    bool DoIsDeterministic() const override;
 
     /**
      *  Creates a default reference loss model
@@ -569,6 +638,9 @@ class ThreeLogDistancePropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> b) const override;
 
     int64_t DoAssignStreams(int64_t stream) override;
+    double DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const override;
+    double DoGetMaxGain() const override;
+    bool DoIsDeterministic() const override;
 
     double m_distance0; //!< Beginning of the first (near) distance field
     double m_distance1; //!< Beginning of the second (middle) distance field.
@@ -686,6 +758,7 @@ class FixedRssLossModel : public PropagationLossModel
                          Ptr<MobilityModel> b) const override;
 
     int64_t DoAssignStreams(int64_t stream) override;
+    bool DoIsDeterministic() const override;
 
     double m_rss; //!< the received signal strength
 };
@@ -738,6 +811,7 @@ class MatrixPropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> b) const override;
 
     int64_t DoAssignStreams(int64_t stream) override;
+    bool DoIsDeterministic() const override;
 
     double m_default; //!< default loss
 
@@ -778,6 +852,9 @@ class RangePropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> b) const override;
 
     int64_t DoAssignStreams(int64_t stream) override;
+    double DoGetMaxRange(double txPowerDbm, double minRxPowerDbm) const override;
+    double DoGetMaxGain() const override;
+    bool DoIsDeterministic() const override;
 
     double m_range; //!< Maximum Transmission Range (meters)
 };
@@ -16,13 +16,20 @@
  */
 
 #include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/cached-propagation-loss-model.h"
 #include "ns3/config.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
+#include "ns3/pointer.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <cmath>
 
 using namespace ns3;
 
@@ -489,6 +496,198 @@ RangePropagationLossModelTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief PropagationLossModel::GetMaxRange Test
+ */
+class MaxRangePropagationLossModelTestCase : public TestCase
+{
+  public:
+    MaxRangePropagationLossModelTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Check that the reception power is below the threshold just beyond the
+     * range, and optionally that it is not just before.
+     *
+     * \param model the loss model
+     * \param txPowerDbm the transmission power (dBm)
+     * \param minRxPowerDbm the reception power threshold (dBm)
+     * \param tight whether the reception power reaches the threshold just before the range
+     */
+    void CheckRange(Ptr<PropagationLossModel> model,
+                    double txPowerDbm,
+                    double minRxPowerDbm,
+                    bool tight);
+};
+
+MaxRangePropagationLossModelTestCase::MaxRangePropagationLossModelTestCase()
+    : TestCase("Test PropagationLossModel::GetMaxRange")
+{
+}
+
+void
+MaxRangePropagationLossModelTestCase::CheckRange(Ptr<PropagationLossModel> model,
+                                                 double txPowerDbm,
+                                                 double minRxPowerDbm,
+                                                 bool tight)
+{
+    double range = model->GetMaxRange(txPowerDbm, minRxPowerDbm);
+    NS_TEST_ASSERT_MSG_EQ(std::isfinite(range), true, "Range should be finite");
+    Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel>();
+    a->SetPosition(Vector(0, 0, 1.5));
+    Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel>();
+    for (double distance = range * 1.001; distance < range * 10; distance *= 1.1)
+    {
+        b->SetPosition(Vector(distance, 0, 1.5));
+        NS_TEST_EXPECT_MSG_LT(model->CalcRxPower(txPowerDbm, a, b),
+                              minRxPowerDbm,
+                              "Signal above the threshold beyond the range " << range);
+    }
+    if (tight)
+    {
+        b->SetPosition(Vector(range * 0.999, 0, 1.5));
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(model->CalcRxPower(txPowerDbm, a, b),
+                                    minRxPowerDbm,
+                                    "Range " << range << " is not tight");
+    }
+}
+
+void
+MaxRangePropagationLossModelTestCase::DoRun()
+{
+    Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel>();
+    CheckRange(friis, 20, -90, true);
+    CheckRange(friis, 0, -50, true);
+
+    Ptr<LogDistancePropagationLossModel> logDistance =
+        CreateObject<LogDistancePropagationLossModel>();
+    CheckRange(logDistance, 16, -96, true);
+
+    Ptr<ThreeLogDistancePropagationLossModel> threeLog =
+        CreateObject<ThreeLogDistancePropagationLossModel>();
+    CheckRange(threeLog, 16, -60, true);
+    CheckRange(threeLog, 16, -120, true);
+    CheckRange(threeLog, 16, -200, true);
+
+    Ptr<TwoRayGroundPropagationLossModel> twoRay =
+        CreateObject<TwoRayGroundPropagationLossModel>();
+    CheckRange(twoRay, 16, -96, false);
+
+    // a RangePropagationLossModel limits the range of the chain
+    Ptr<RangePropagationLossModel> range = CreateObject<RangePropagationLossModel>();
+    range->SetAttribute("MaxRange", DoubleValue(50));
+    logDistance->SetNext(range);
+    NS_TEST_EXPECT_MSG_EQ_TOL(logDistance->GetMaxRange(16, -96),
+                              50,
+                              1e-9,
+                              "Range not limited by the chained model");
+    CheckRange(logDistance, 16, -96, false);
+
+    // a random loss cannot be bounded
+    Ptr<RandomPropagationLossModel> random = CreateObject<RandomPropagationLossModel>();
+    friis->SetNext(random);
+    NS_TEST_EXPECT_MSG_EQ(std::isinf(friis->GetMaxRange(20, -90)),
+                          true,
+                          "Range of a random model should be infinite");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief CachedPropagationLossModel Test
+ */
+class CachedPropagationLossModelTestCase : public TestCase
+{
+  public:
+    CachedPropagationLossModelTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase()
+    : TestCase("Test CachedPropagationLossModel")
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun()
+{
+    Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel>();
+    a->SetPosition(Vector(0, 0, 0));
+    Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel>();
+    b->SetPosition(Vector(100, 0, 0));
+    Ptr<MobilityModel> c = CreateObject<ConstantPositionMobilityModel>();
+    c->SetPosition(Vector(0, 200, 0));
+
+    Ptr<LogDistancePropagationLossModel> logDistance =
+        CreateObject<LogDistancePropagationLossModel>();
+    Ptr<CachedPropagationLossModel> cache = CreateObject<CachedPropagationLossModel>();
+    cache->SetAttribute("PropagationLossModel", PointerValue(logDistance));
+    cache->SetAttribute("MaxEntries", UintegerValue(2));
+    NS_TEST_EXPECT_MSG_EQ(cache->IsDeterministic(), true, "Log distance model is deterministic");
+
+    double tolerance = 1e-9;
+    NS_TEST_EXPECT_MSG_EQ_TOL(cache->CalcRxPower(10, a, b),
+                              logDistance->CalcRxPower(10, a, b),
+                              tolerance,
+                              "Wrong cached value");
+    NS_TEST_EXPECT_MSG_EQ_TOL(cache->CalcRxPower(10, a, b),
+                              logDistance->CalcRxPower(10, a, b),
+                              tolerance,
+                              "Wrong cached value");
+    NS_TEST_EXPECT_MSG_EQ(cache->GetNEntries(), 1, "Link a -> b not cached once");
+
+    // the entries of a model are refreshed after it moves
+    b->SetPosition(Vector(300, 0, 0));
+    NS_TEST_EXPECT_MSG_EQ_TOL(cache->CalcRxPower(10, a, b),
+                              logDistance->CalcRxPower(10, a, b),
+                              tolerance,
+                              "Stale value returned after a course change");
+    NS_TEST_EXPECT_MSG_EQ(cache->GetNEntries(), 1, "Stale entry not reused");
+
+    // the least recently used entry is evicted
+    cache->CalcRxPower(10, a, c);
+    cache->CalcRxPower(10, a, b);
+    cache->CalcRxPower(10, b, c);
+    NS_TEST_EXPECT_MSG_EQ(cache->GetNEntries(), 2, "Cache exceeds MaxEntries");
+    c->SetPosition(Vector(0, 50, 0));
+    NS_TEST_EXPECT_MSG_EQ_TOL(cache->CalcRxPower(10, a, c),
+                              logDistance->CalcRxPower(10, a, c),
+                              tolerance,
+                              "Wrong value after eviction");
+
+    // moving models are not cached
+    Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel>();
+    moving->SetVelocity(Vector(1, 0, 0));
+    cache->Clear();
+    NS_TEST_EXPECT_MSG_EQ_TOL(cache->CalcRxPower(10, a, moving),
+                              logDistance->CalcRxPower(10, a, moving),
+                              tolerance,
+                              "Wrong value for a moving model");
+    NS_TEST_EXPECT_MSG_EQ(cache->GetNEntries(), 0, "Moving model cached");
+
+    // random models are only cached on demand
+    Ptr<RandomPropagationLossModel> random = CreateObject<RandomPropagationLossModel>();
+    logDistance->SetNext(random);
+    NS_TEST_EXPECT_MSG_EQ(cache->IsDeterministic(), false, "Random model is not deterministic");
+    cache->CalcRxPower(10, a, b);
+    NS_TEST_EXPECT_MSG_EQ(cache->GetNEntries(), 0, "Random model cached");
+    cache->SetAttribute("CacheRandomModels", BooleanValue(true));
+    double rxPowerDbm = cache->CalcRxPower(10, a, b);
+    NS_TEST_EXPECT_MSG_EQ(cache->CalcRxPower(10, a, b), rxPowerDbm, "Random value not cached");
+    NS_TEST_EXPECT_MSG_EQ(cache->GetNEntries(), 1, "Random model not cached on demand");
+
+    cache->Dispose();
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup propagation-tests
  *
@@ -500,6 +699,8 @@ RangePropagationLossModelTestCase::DoRun()
  *   - LogDistancePropagationLossModel
  *   - MatrixPropagationLossModel
  *   - RangePropagationLossModel
+ *   - PropagationLossModel::GetMaxRange
+ *   - CachedPropagationLossModel
  */
 class PropagationLossModelsTestSuite : public TestSuite
 {
@@ -515,6 +716,8 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite()
     AddTestCase(new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
     AddTestCase(new MatrixPropagationLossModelTestCase, TestCase::QUICK);
     AddTestCase(new RangePropagationLossModelTestCase, TestCase::QUICK);
+    AddTestCase(new MaxRangePropagationLossModelTestCase, TestCase::QUICK);
+    AddTestCase(new CachedPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
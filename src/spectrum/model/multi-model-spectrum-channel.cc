@@ -91,6 +91,8 @@ MultiModelSpectrumChannel::DoDispose()
     NS_LOG_FUNCTION(this);
     m_txSpectrumModelInfoMap.clear();
     m_rxSpectrumModelInfoMap.clear();
+    m_rxIndices.clear();
+    m_rxPhysInRange.clear();
     SpectrumChannel::DoDispose();
 }
 
@@ -125,6 +127,7 @@ MultiModelSpectrumChannel::RemoveRx(Ptr<SpectrumPhy> phy)
         if (phyIt != rxInfoIterator->second.m_rxPhys.end())
         {
             rxInfoIterator->second.m_rxPhys.erase(phyIt);
+            m_rxIndices[rxInfoIterator->first].valid = false;
             --m_numDevices;
             break; // there should be at most one entry
         }
@@ -154,6 +157,7 @@ MultiModelSpectrumChannel::AddRx(Ptr<SpectrumPhy> phy)
     // rxInfoIterator points either to the newly inserted element or to the element that
     // prevented insertion. In both cases, add the phy to the element pointed to by rxInfoIterator
     rxInfoIterator->second.m_rxPhys.push_back(phy);
+    m_rxIndices[rxSpectrumModelUid].valid = false;
 
     if (inserted)
     {
@@ -283,9 +287,16 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
             convertedTxPowerSpectrum = rxConverterIterator->second.Convert(txParams->psd);
         }
 
-        for (auto rxPhyIterator = rxInfoIterator->second.m_rxPhys.begin();
-             rxPhyIterator != rxInfoIterator->second.m_rxPhys.end();
-             ++rxPhyIterator)
+        // receivers beyond range are skipped altogether
+        const std::vector<Ptr<SpectrumPhy>>& rxPhys =
+            GetRxPhysInRange(txParams,
+                             rxInfoIterator->second.m_rxPhys,
+                             m_rxIndices[rxSpectrumModelUid],
+                             m_rxPhysInRange)
+                ? m_rxPhysInRange
+                : rxInfoIterator->second.m_rxPhys;
+
+        for (auto rxPhyIterator = rxPhys.begin(); rxPhyIterator != rxPhys.end(); ++rxPhyIterator)
         {
             NS_ASSERT_MSG((*rxPhyIterator)->GetRxSpectrumModel()->GetUid() == rxSpectrumModelUid,
                           "SpectrumModel change was not notified to MultiModelSpectrumChannel "
@@ -308,10 +319,8 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                     }
                 }
 
-                NS_LOG_LOGIC("copying signal parameters " << txParams);
-                Ptr<SpectrumSignalParameters> rxParams = txParams->Copy();
-                rxParams->psd = Copy<SpectrumValue>(convertedTxPowerSpectrum);
                 Time delay = MicroSeconds(0);
+                double pathGainLinear = 1;
 
                 Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility();
 
@@ -321,10 +330,10 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                     double rxAntennaGain = 0;
                     double propagationGainDb = 0;
                     double pathLossDb = 0;
-                    if (rxParams->txAntenna)
+                    if (txParams->txAntenna)
                     {
                         Angles txAngles(receiverMobility->GetPosition(), txMobility->GetPosition());
-                        txAntennaGain = rxParams->txAntenna->GetGainDb(txAngles);
+                        txAntennaGain = txParams->txAntenna->GetGainDb(txAngles);
                         NS_LOG_LOGIC("txAntennaGain = " << txAntennaGain << " dB");
                         pathLossDb -= txAntennaGain;
                     }
@@ -359,8 +368,7 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                         // beyond range
                         continue;
                     }
-                    double pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
-                    *(rxParams->psd) *= pathGainLinear;
+                    pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
 
                     if (m_propagationDelay)
                     {
@@ -368,30 +376,16 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                     }
                 }
 
-                if (rxNetDevice)
-                {
-                    // the receiver has a NetDevice, so we expect that it is attached to a Node
-                    uint32_t dstNode = rxNetDevice->GetNode()->GetId();
-                    Simulator::ScheduleWithContext(dstNode,
-                                                   delay,
-                                                   &MultiModelSpectrumChannel::StartRx,
-                                                   this,
-                                                   rxParams,
-                                                   *rxPhyIterator);
-                }
-                else
-                {
-                    // the receiver is not attached to a NetDevice, so we cannot assume that it is
-                    // attached to a node
-                    Simulator::Schedule(delay,
-                                        &MultiModelSpectrumChannel::StartRx,
-                                        this,
-                                        rxParams,
-                                        *rxPhyIterator);
-                }
+                // the signal parameters are only copied for the receivers in range
+                NS_LOG_LOGIC("copying signal parameters " << txParams);
+                Ptr<SpectrumSignalParameters> rxParams = txParams->Copy();
+                rxParams->psd = Copy<SpectrumValue>(convertedTxPowerSpectrum);
+                *(rxParams->psd) *= pathGainLinear;
+                ScheduleRx(delay, rxParams, *rxPhyIterator);
             }
         }
     }
+    ScheduleRxBatches();
 }
 
 void
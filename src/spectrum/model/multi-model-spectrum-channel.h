@@ -142,7 +142,7 @@ class MultiModelSpectrumChannel : public SpectrumChannel
      * \param params The signal parameters.
      * \param receiver A pointer to the receiver SpectrumPhy.
      */
-    virtual void StartRx(Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
+    void StartRx(Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver) override;
 
     /**
      * Data structure holding, for each TX SpectrumModel,  all the
@@ -158,6 +158,16 @@ class MultiModelSpectrumChannel : public SpectrumChannel
      */
     RxSpectrumModelInfoMap_t m_rxSpectrumModelInfoMap;
 
+    /**
+     * Spatial index of the SpectrumPhy instances of each RX spectrum model.
+     */
+    std::map<SpectrumModelUid_t, RxIndex> m_rxIndices;
+
+    /**
+     * Receivers within range of the current transmission.
+     */
+    std::vector<Ptr<SpectrumPhy>> m_rxPhysInRange;
+
     /**
      * Number of devices connected to the channel.
      */
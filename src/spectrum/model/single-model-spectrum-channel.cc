@@ -54,6 +54,8 @@ SingleModelSpectrumChannel::DoDispose()
 {
     NS_LOG_FUNCTION(this);
     m_phyList.clear();
+    m_rxIndex = RxIndex();
+    m_rxPhysInRange.clear();
     m_spectrumModel = nullptr;
     SpectrumChannel::DoDispose();
 }
@@ -77,6 +79,7 @@ SingleModelSpectrumChannel::RemoveRx(Ptr<SpectrumPhy> phy)
     if (it != std::end(m_phyList))
     {
         m_phyList.erase(it);
+        m_rxIndex.valid = false;
     }
 }
 
@@ -87,6 +90,7 @@ SingleModelSpectrumChannel::AddRx(Ptr<SpectrumPhy> phy)
     if (std::find(m_phyList.cbegin(), m_phyList.cend(), phy) == m_phyList.cend())
     {
         m_phyList.push_back(phy);
+        m_rxIndex.valid = false;
     }
 }
 
@@ -117,8 +121,12 @@ SingleModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
 
     Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility();
 
-    for (PhyList::const_iterator rxPhyIterator = m_phyList.begin();
-         rxPhyIterator != m_phyList.end();
+    // receivers beyond range are skipped altogether
+    const PhyList& rxPhys =
+        GetRxPhysInRange(txParams, m_phyList, m_rxIndex, m_rxPhysInRange) ? m_rxPhysInRange
+                                                                          : m_phyList;
+
+    for (PhyList::const_iterator rxPhyIterator = rxPhys.begin(); rxPhyIterator != rxPhys.end();
          ++rxPhyIterator)
     {
         Ptr<NetDevice> rxNetDevice = (*rxPhyIterator)->GetDevice();
@@ -138,10 +146,9 @@ SingleModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
         if ((*rxPhyIterator) != txParams->txPhy)
         {
             Time delay = MicroSeconds(0);
+            double pathGainLinear = 1;
 
             Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility();
-            NS_LOG_LOGIC("copying signal parameters " << txParams);
-            Ptr<SpectrumSignalParameters> rxParams = txParams->Copy();
 
             if (senderMobility && receiverMobility)
             {
@@ -149,10 +156,10 @@ SingleModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                 double rxAntennaGain = 0;
                 double propagationGainDb = 0;
                 double pathLossDb = 0;
-                if (rxParams->txAntenna)
+                if (txParams->txAntenna)
                 {
                     Angles txAngles(receiverMobility->GetPosition(), senderMobility->GetPosition());
-                    txAntennaGain = rxParams->txAntenna->GetGainDb(txAngles);
+                    txAntennaGain = txParams->txAntenna->GetGainDb(txAngles);
                     NS_LOG_LOGIC("txAntennaGain = " << txAntennaGain << " dB");
                     pathLossDb -= txAntennaGain;
                 }
@@ -187,8 +194,7 @@ SingleModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                     // beyond range
                     continue;
                 }
-                double pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
-                *(rxParams->psd) *= pathGainLinear;
+                pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
 
                 if (m_propagationDelay)
                 {
@@ -196,29 +202,14 @@ SingleModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                 }
             }
 
-            if (rxNetDevice)
-            {
-                // the receiver has a NetDevice, so we expect that it is attached to a Node
-                uint32_t dstNode = rxNetDevice->GetNode()->GetId();
-                Simulator::ScheduleWithContext(dstNode,
-                                               delay,
-                                               &SingleModelSpectrumChannel::StartRx,
-                                               this,
-                                               rxParams,
-                                               *rxPhyIterator);
-            }
-            else
-            {
-                // the receiver is not attached to a NetDevice, so we cannot assume that it is
-                // attached to a node
-                Simulator::Schedule(delay,
-                                    &SingleModelSpectrumChannel::StartRx,
-                                    this,
-                                    rxParams,
-                                    *rxPhyIterator);
-            }
+            // the signal parameters are only copied for the receivers in range
+            NS_LOG_LOGIC("copying signal parameters " << txParams);
+            Ptr<SpectrumSignalParameters> rxParams = txParams->Copy();
+            *(rxParams->psd) *= pathGainLinear;
+            ScheduleRx(delay, rxParams, *rxPhyIterator);
         }
     }
+    ScheduleRxBatches();
 }
 
 void
@@ -66,13 +66,23 @@ class SingleModelSpectrumChannel : public SpectrumChannel
      * \param params
      * \param receiver
      */
-    void StartRx(Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
+    void StartRx(Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver) override;
 
     /**
      * List of SpectrumPhy instances attached to the channel.
      */
     PhyList m_phyList;
 
+    /**
+     * Spatial index of m_phyList.
+     */
+    RxIndex m_rxIndex;
+
+    /**
+     * Receivers within range of the current transmission.
+     */
+    PhyList m_rxPhysInRange;
+
     /**
      * SpectrumModel that this channel instance is supporting.
      */
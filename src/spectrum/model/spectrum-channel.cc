@@ -19,9 +19,18 @@
 
 #include "spectrum-channel.h"
 
+#include <ns3/antenna-model.h>
+#include <ns3/boolean.h>
 #include <ns3/double.h>
 #include <ns3/log.h>
+#include <ns3/net-device.h>
+#include <ns3/node.h>
 #include <ns3/pointer.h>
+#include <ns3/simulator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace ns3
 {
@@ -31,6 +40,7 @@ NS_LOG_COMPONENT_DEFINE("SpectrumChannel");
 NS_OBJECT_ENSURE_REGISTERED(SpectrumChannel);
 
 SpectrumChannel::SpectrumChannel()
+    : m_batchReceptions(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -46,6 +56,159 @@ SpectrumChannel::DoDispose()
     m_propagationLoss = nullptr;
     m_propagationDelay = nullptr;
     m_spectrumPropagationLoss = nullptr;
+    m_rxBatches.clear();
+}
+
+bool
+SpectrumChannel::GetRxPhysInRange(Ptr<const SpectrumSignalParameters> txParams,
+                                  const std::vector<Ptr<SpectrumPhy>>& rxPhys,
+                                  RxIndex& index,
+                                  std::vector<Ptr<SpectrumPhy>>& inRange)
+{
+    Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility();
+    if (!txMobility)
+    {
+        return false;
+    }
+    if (!index.valid)
+    {
+        index.rxAntennas = std::any_of(rxPhys.begin(), rxPhys.end(), [](Ptr<SpectrumPhy> phy) {
+            return static_cast<bool>(DynamicCast<AntennaModel>(phy->GetAntenna()));
+        });
+        index.grid = nullptr;
+        index.valid = true;
+    }
+    double range = m_maxRange;
+    if (m_propagationLoss && !txParams->txAntenna && !index.rxAntennas)
+    {
+        // the path loss is then the propagation loss
+        range = std::min(range, m_propagationLoss->GetMaxRange(0, -m_maxLossDb));
+    }
+    if (std::isinf(range))
+    {
+        return false;
+    }
+    if (!index.grid)
+    {
+        NS_LOG_LOGIC("indexing " << rxPhys.size() << " receivers, range " << range << "m");
+        index.grid = Create<MobilityGridIndex>(std::max(range, 1.0));
+        for (uint32_t id = 0; id < rxPhys.size(); ++id)
+        {
+            index.grid->Add(id, rxPhys[id]->GetMobility());
+        }
+    }
+    index.grid->GetNeighbors(txMobility->GetPosition(), range, m_rxIds);
+    inRange.clear();
+    for (uint32_t id : m_rxIds)
+    {
+        inRange.push_back(rxPhys[id]);
+    }
+    NS_LOG_LOGIC(inRange.size() << " of " << rxPhys.size() << " receivers within " << range
+                                << "m");
+    return true;
+}
+
+void
+SpectrumChannel::ScheduleRx(Time delay,
+                            Ptr<SpectrumSignalParameters> params,
+                            Ptr<SpectrumPhy> receiver)
+{
+    if (m_batchReceptions)
+    {
+        m_rxBatches.emplace_back(delay, Rx(params, receiver));
+        return;
+    }
+    ScheduleStartRx(delay, params, receiver);
+}
+
+void
+SpectrumChannel::ScheduleStartRx(Time delay,
+                                 Ptr<SpectrumSignalParameters> params,
+                                 Ptr<SpectrumPhy> receiver)
+{
+    Ptr<NetDevice> rxNetDevice = receiver->GetDevice();
+    if (rxNetDevice)
+    {
+        // the receiver has a NetDevice, so we expect that it is attached to a Node
+        uint32_t dstNode = rxNetDevice->GetNode()->GetId();
+        Simulator::ScheduleWithContext(dstNode,
+                                       delay,
+                                       &SpectrumChannel::StartRx,
+                                       this,
+                                       params,
+                                       receiver);
+    }
+    else
+    {
+        // the receiver is not attached to a NetDevice, so we cannot assume that it is
+        // attached to a node
+        Simulator::Schedule(delay, &SpectrumChannel::StartRx, this, params, receiver);
+    }
+}
+
+void
+SpectrumChannel::ScheduleRxBatches()
+{
+    if (m_rxBatches.empty())
+    {
+        return;
+    }
+    std::stable_sort(m_rxBatches.begin(), m_rxBatches.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    for (auto first = m_rxBatches.begin(); first != m_rxBatches.end();)
+    {
+        Time delay = first->first;
+        auto last = std::find_if(first, m_rxBatches.end(), [delay](const auto& rx) {
+            return rx.first != delay;
+        });
+        if (last - first == 1)
+        {
+            ScheduleStartRx(delay, first->second.first, first->second.second);
+            first = last;
+            continue;
+        }
+        std::vector<Rx> batch;
+        batch.reserve(last - first);
+        for (auto it = first; it != last; ++it)
+        {
+            batch.push_back(std::move(it->second));
+        }
+        NS_LOG_LOGIC("batch of " << batch.size() << " receptions in " << delay);
+        // the receptions run in the context of the node of the first receiver
+        Ptr<NetDevice> rxNetDevice = batch.front().second->GetDevice();
+        if (rxNetDevice)
+        {
+            Simulator::ScheduleWithContext(rxNetDevice->GetNode()->GetId(),
+                                           delay,
+                                           &SpectrumChannel::StartRxBatch,
+                                           this,
+                                           std::move(batch));
+        }
+        else
+        {
+            Simulator::Schedule(delay, &SpectrumChannel::StartRxBatch, this, std::move(batch));
+        }
+        first = last;
+    }
+    m_rxBatches.clear();
+}
+
+void
+SpectrumChannel::StartRxBatch(const std::vector<Rx>& batch)
+{
+    NS_LOG_FUNCTION(this << batch.size());
+    for (const auto& [params, receiver] : batch)
+    {
+        StartRx(params, receiver);
+    }
+}
+
+void
+SpectrumChannel::StartRx(Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
+{
+    NS_LOG_FUNCTION(this << params << receiver);
+    receiver->StartRx(params);
 }
 
 TypeId
@@ -70,6 +233,31 @@ SpectrumChannel::GetTypeId()
                           MakeDoubleAccessor(&SpectrumChannel::m_maxLossDb),
                           MakeDoubleChecker<double>())
 
+            .AddAttribute("MaxRange",
+                          "The maximum distance (m) between the transmitter and the "
+                          "receiving PHYs. Signals are not propagated to the receivers "
+                          "beyond this distance, and no path loss is computed nor traced "
+                          "for them. If neither the transmitter nor the receivers have an "
+                          "AntennaModel, the distance beyond which the PropagationLossModel "
+                          "loss exceeds MaxLossDb is used when smaller. The receivers in "
+                          "range are found with a spatial index following the course "
+                          "changes of their mobility models, so that the cost of a "
+                          "transmission does not grow with the number of distant receivers.",
+                          DoubleValue(std::numeric_limits<double>::infinity()),
+                          MakeDoubleAccessor(&SpectrumChannel::m_maxRange),
+                          MakeDoubleChecker<double>(0, std::numeric_limits<double>::infinity()))
+
+            .AddAttribute("BatchReceptions",
+                          "If true, the receptions of a signal which start at the same "
+                          "time, i.e., with the same propagation delay, are started by a "
+                          "single event rather than one event per receiver, in the same "
+                          "order. The receptions of a batch run in the context of the node "
+                          "of its first receiver, hence this is not suitable for the "
+                          "parallel simulator implementations.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&SpectrumChannel::m_batchReceptions),
+                          MakeBooleanChecker())
+
             .AddAttribute("PropagationLossModel",
                           "A pointer to the propagation loss model attached to this channel.",
                           PointerValue(nullptr),
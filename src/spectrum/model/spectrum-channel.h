@@ -21,6 +21,7 @@
 #define SPECTRUM_CHANNEL_H
 
 #include <ns3/channel.h>
+#include <ns3/mobility-grid-index.h>
 #include <ns3/mobility-model.h>
 #include <ns3/nstime.h>
 #include <ns3/object.h>
@@ -32,6 +33,8 @@
 #include <ns3/spectrum-signal-parameters.h>
 #include <ns3/traced-callback.h>
 
+#include <vector>
+
 namespace ns3
 {
 
@@ -187,6 +190,61 @@ class SpectrumChannel : public Channel
     typedef void (*SignalParametersTracedCallback)(Ptr<SpectrumSignalParameters> params);
 
   protected:
+    /**
+     * Spatial index of a list of receivers, built on the first transmission
+     * following a change of the list.
+     */
+    struct RxIndex
+    {
+        bool valid{false};           //!< whether the index matches the list
+        bool rxAntennas{false};      //!< whether a receiver has an AntennaModel
+        Ptr<MobilityGridIndex> grid; //!< the receivers, by position in the list, if a range applies
+    };
+
+    /**
+     * Get the receivers of a list that are within range of a transmission.
+     *
+     * The range is the MaxRange attribute or, if smaller and no antenna gain
+     * applies, the distance beyond which the propagation loss exceeds
+     * MaxLossDb.  The receivers without a mobility model are always in range.
+     *
+     * \param txParams the parameters of the signal being transmitted
+     * \param rxPhys the list of receivers
+     * \param index the spatial index of the list
+     * \param [out] inRange the receivers within range, in the order of the list
+     * \returns false, without filling \p inRange, if the range is infinite
+     */
+    bool GetRxPhysInRange(Ptr<const SpectrumSignalParameters> txParams,
+                          const std::vector<Ptr<SpectrumPhy>>& rxPhys,
+                          RxIndex& index,
+                          std::vector<Ptr<SpectrumPhy>>& inRange);
+
+    /**
+     * Schedule the start of the reception of a signal by a receiver, in the
+     * context of the node of the receiver. If BatchReceptions is set, the
+     * reception is instead added to the batch of the receptions with the same
+     * propagation delay, which are scheduled by ScheduleRxBatches().
+     *
+     * \param delay the propagation delay
+     * \param params the parameters of the received signal
+     * \param receiver the receiver
+     */
+    void ScheduleRx(Time delay, Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
+
+    /**
+     * Schedule one event per propagation delay starting the receptions added
+     * by ScheduleRx() since the last call, in the order they were added.
+     */
+    void ScheduleRxBatches();
+
+    /**
+     * Start the reception of a signal by a receiver, after the propagation delay.
+     *
+     * \param params the parameters of the received signal
+     * \param receiver the receiver
+     */
+    virtual void StartRx(Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
+
     /**
      * The `PathLoss` trace source. Exporting the pointers to the Tx and Rx
      * SpectrumPhy and a pathloss value, in dB.
@@ -218,6 +276,16 @@ class SpectrumChannel : public Channel
      */
     double m_maxLossDb;
 
+    /**
+     * Maximum distance [m] between the transmitter and the receivers.
+     */
+    double m_maxRange;
+
+    /**
+     * Positions in the list of receivers, reused across transmissions.
+     */
+    std::vector<uint32_t> m_rxIds;
+
     /**
      * Single-frequency propagation loss model to be used with this channel.
      */
@@ -237,6 +305,39 @@ class SpectrumChannel : public Channel
      * Frequency-dependent propagation loss model to be used with this channel.
      */
     Ptr<PhasedArraySpectrumPropagationLossModel> m_phasedArraySpectrumPropagationLoss;
+
+  private:
+    /// A reception to start, and the parameters of the received signal
+    using Rx = std::pair<Ptr<SpectrumSignalParameters>, Ptr<SpectrumPhy>>;
+
+    /**
+     * Schedule the start of the reception of a signal by a receiver, in the
+     * context of the node of the receiver.
+     *
+     * \param delay the propagation delay
+     * \param params the parameters of the received signal
+     * \param receiver the receiver
+     */
+    void ScheduleStartRx(Time delay,
+                         Ptr<SpectrumSignalParameters> params,
+                         Ptr<SpectrumPhy> receiver);
+
+    /**
+     * Start the receptions of a batch.
+     *
+     * \param batch the receptions
+     */
+    void StartRxBatch(const std::vector<Rx>& batch);
+
+    /**
+     * Whether the receptions with the same propagation delay are started by a single event.
+     */
+    bool m_batchReceptions;
+
+    /**
+     * The receptions added by ScheduleRx() to the next batches, with their propagation delay.
+     */
+    std::vector<std::pair<Time, Rx>> m_rxBatches;
 };
 
 } // namespace ns3
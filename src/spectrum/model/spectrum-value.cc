@@ -22,11 +22,274 @@
 #include <ns3/math.h>
 #include <ns3/spectrum-value.h>
 
+#include <algorithm>
+#include <utility>
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#define SPECTRUM_VALUE_SIMD
+#include <immintrin.h>
+/// Compile a function for AVX2, whatever the target of the build
+#define SPECTRUM_VALUE_AVX2 __attribute__((target("avx2")))
+#endif
+
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("SpectrumValue");
 
+namespace
+{
+
+// The kernels below compute y[i] = Op (y[i], x[i]) or y[i] = Op (y[i], x1[i], x2[i])
+// for all the elements of a SpectrumValue, where the operands x are either another
+// SpectrumValue or a scalar.  They use AVX2 when the CPU supports it, SSE2 on the
+// other x86 CPUs, and plain loops elsewhere.  Each element is computed with the same
+// IEEE operations in the same order in all the variants, and without fused
+// multiply-add, so the results do not depend on the instruction set.
+
+#ifdef SPECTRUM_VALUE_SIMD
+/**
+ * \returns true if the CPU supports AVX2
+ */
+bool
+HasAvx2()
+{
+#ifdef __AVX2__
+    return true;
+#else
+    static const bool avx2 = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return avx2;
+#endif
+}
+#endif
+
+/// An operand made of the elements of a SpectrumValue
+struct VectorOperand
+{
+    const double* x; //!< the elements
+
+    /**
+     * \param i an index
+     * \returns the element at the index
+     */
+    double Get(std::size_t i) const
+    {
+        return x[i];
+    }
+#ifdef SPECTRUM_VALUE_SIMD
+    /**
+     * \param i an index
+     * \returns the two elements from the index
+     */
+    __m128d Get2(std::size_t i) const
+    {
+        return _mm_loadu_pd(x + i);
+    }
+
+    /**
+     * \param i an index
+     * \returns the four elements from the index
+     */
+    SPECTRUM_VALUE_AVX2 __m256d Get4(std::size_t i) const
+    {
+        return _mm256_loadu_pd(x + i);
+    }
+#endif
+};
+
+/// An operand with the same value for all the elements
+struct ScalarOperand
+{
+    double s; //!< the value
+
+    /**
+     * \returns the value
+     */
+    double Get(std::size_t) const
+    {
+        return s;
+    }
+#ifdef SPECTRUM_VALUE_SIMD
+    /**
+     * \returns the value, twice
+     */
+    __m128d Get2(std::size_t) const
+    {
+        return _mm_set1_pd(s);
+    }
+
+    /**
+     * \returns the value, four times
+     */
+    SPECTRUM_VALUE_AVX2 __m256d Get4(std::size_t) const
+    {
+        return _mm256_set1_pd(s);
+    }
+#endif
+};
+
+#ifdef SPECTRUM_VALUE_SIMD
+/**
+ * Define an element-wise binary operation and its SIMD variants.
+ * \param name the name of the operation
+ * \param expr the scalar expression of y and x
+ * \param sse2 the SSE2 intrinsic
+ * \param avx the AVX intrinsic
+ */
+#define SPECTRUM_VALUE_BINARY_OP(name, expr, sse2, avx)                                            \
+    struct name                                                                                    \
+    {                                                                                              \
+        static double Apply(double y, double x)                                                    \
+        {                                                                                          \
+            return expr;                                                                           \
+        }                                                                                          \
+        static __m128d Apply(__m128d y, __m128d x)                                                 \
+        {                                                                                          \
+            return sse2;                                                                           \
+        }                                                                                          \
+        SPECTRUM_VALUE_AVX2 static __m256d Apply(__m256d y, __m256d x)                             \
+        {                                                                                          \
+            return avx;                                                                            \
+        }                                                                                          \
+    }
+#else
+#define SPECTRUM_VALUE_BINARY_OP(name, expr, sse2, avx)                                            \
+    struct name                                                                                    \
+    {                                                                                              \
+        static double Apply(double y, double x)                                                    \
+        {                                                                                          \
+            return expr;                                                                           \
+        }                                                                                          \
+    }
+#endif
+
+/// y + x
+SPECTRUM_VALUE_BINARY_OP(AddOp, y + x, _mm_add_pd(y, x), _mm256_add_pd(y, x));
+/// y - x
+SPECTRUM_VALUE_BINARY_OP(SubtractOp, y - x, _mm_sub_pd(y, x), _mm256_sub_pd(y, x));
+/// x - y
+SPECTRUM_VALUE_BINARY_OP(SubtractFromOp, x - y, _mm_sub_pd(x, y), _mm256_sub_pd(x, y));
+/// y * x
+SPECTRUM_VALUE_BINARY_OP(MultiplyOp, y * x, _mm_mul_pd(y, x), _mm256_mul_pd(y, x));
+/// y / x
+SPECTRUM_VALUE_BINARY_OP(DivideOp, y / x, _mm_div_pd(y, x), _mm256_div_pd(y, x));
+/// x / y
+SPECTRUM_VALUE_BINARY_OP(DivideFromOp, x / y, _mm_div_pd(x, y), _mm256_div_pd(x, y));
+
+/// y + x1 * x2, rounding the product before the sum
+struct MultiplyAddOp
+{
+    /**
+     * \param y the accumulator
+     * \param x1 the first factor
+     * \param x2 the second factor
+     * \returns y + x1 * x2
+     */
+    static double Apply(double y, double x1, double x2)
+    {
+        double product = x1 * x2;
+        return y + product;
+    }
+#ifdef SPECTRUM_VALUE_SIMD
+    /**
+     * \param y the accumulators
+     * \param x1 the first factors
+     * \param x2 the second factors
+     * \returns y + x1 * x2
+     */
+    static __m128d Apply(__m128d y, __m128d x1, __m128d x2)
+    {
+        return _mm_add_pd(y, _mm_mul_pd(x1, x2));
+    }
+
+    /**
+     * \param y the accumulators
+     * \param x1 the first factors
+     * \param x2 the second factors
+     * \returns y + x1 * x2
+     */
+    SPECTRUM_VALUE_AVX2 static __m256d Apply(__m256d y, __m256d x1, __m256d x2)
+    {
+        return _mm256_add_pd(y, _mm256_mul_pd(x1, x2));
+    }
+#endif
+};
+
+#ifdef SPECTRUM_VALUE_SIMD
+/**
+ * Apply an operation with AVX2.
+ * \param y the elements, replaced by the result
+ * \param n the number of elements
+ * \param x the other operands
+ */
+template <typename Op, typename... Operands>
+SPECTRUM_VALUE_AVX2 void
+ApplyAvx2(double* y, std::size_t n, Operands... x)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm256_storeu_pd(y + i, Op::Apply(_mm256_loadu_pd(y + i), x.Get4(i)...));
+    }
+    for (; i < n; ++i)
+    {
+        y[i] = Op::Apply(y[i], x.Get(i)...);
+    }
+}
+
+/**
+ * Apply an operation with SSE2.
+ * \param y the elements, replaced by the result
+ * \param n the number of elements
+ * \param x the other operands
+ */
+template <typename Op, typename... Operands>
+void
+ApplySse2(double* y, std::size_t n, Operands... x)
+{
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        _mm_storeu_pd(y + i, Op::Apply(_mm_loadu_pd(y + i), x.Get2(i)...));
+    }
+    for (; i < n; ++i)
+    {
+        y[i] = Op::Apply(y[i], x.Get(i)...);
+    }
+}
+#endif
+
+/**
+ * Apply an operation to all the elements of a SpectrumValue.
+ * \param y the elements, replaced by the result
+ * \param x the other operands
+ */
+template <typename Op, typename... Operands>
+void
+Apply(Values& y, Operands... x)
+{
+#ifdef SPECTRUM_VALUE_SIMD
+    if (HasAvx2())
+    {
+        ApplyAvx2<Op>(y.data(), y.size(), x...);
+    }
+    else
+    {
+        ApplySse2<Op>(y.data(), y.size(), x...);
+    }
+#else
+    for (std::size_t i = 0; i < y.size(); ++i)
+    {
+        y[i] = Op::Apply(y[i], x.Get(i)...);
+    }
+#endif
+}
+
+} // namespace
+
 SpectrumValue::SpectrumValue()
 {
 }
@@ -100,47 +363,23 @@ SpectrumValue::ConstBandsEnd() const
 void
 SpectrumValue::Add(const SpectrumValue& x)
 {
-    Values::iterator it1 = m_values.begin();
-    Values::const_iterator it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
     NS_ASSERT(m_values.size() == x.m_values.size());
-
-    while (it1 != m_values.end())
-    {
-        *it1 += *it2;
-        ++it1;
-        ++it2;
-    }
+    Apply<AddOp>(m_values, VectorOperand{x.m_values.data()});
 }
 
 void
 SpectrumValue::Add(double s)
 {
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
-    {
-        *it1 += s;
-        ++it1;
-    }
+    Apply<AddOp>(m_values, ScalarOperand{s});
 }
 
 void
 SpectrumValue::Subtract(const SpectrumValue& x)
 {
-    Values::iterator it1 = m_values.begin();
-    Values::const_iterator it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
     NS_ASSERT(m_values.size() == x.m_values.size());
-
-    while (it1 != m_values.end())
-    {
-        *it1 -= *it2;
-        ++it1;
-        ++it2;
-    }
+    Apply<SubtractOp>(m_values, VectorOperand{x.m_values.data()});
 }
 
 void
@@ -150,62 +389,66 @@ SpectrumValue::Subtract(double s)
 }
 
 void
-SpectrumValue::Multiply(const SpectrumValue& x)
+SpectrumValue::SubtractFrom(const SpectrumValue& x)
 {
-    Values::iterator it1 = m_values.begin();
-    Values::const_iterator it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
     NS_ASSERT(m_values.size() == x.m_values.size());
+    Apply<SubtractFromOp>(m_values, VectorOperand{x.m_values.data()});
+}
 
-    while (it1 != m_values.end())
-    {
-        *it1 *= *it2;
-        ++it1;
-        ++it2;
-    }
+void
+SpectrumValue::Multiply(const SpectrumValue& x)
+{
+    NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
+    NS_ASSERT(m_values.size() == x.m_values.size());
+    Apply<MultiplyOp>(m_values, VectorOperand{x.m_values.data()});
 }
 
 void
 SpectrumValue::Multiply(double s)
 {
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
-    {
-        *it1 *= s;
-        ++it1;
-    }
+    Apply<MultiplyOp>(m_values, ScalarOperand{s});
 }
 
 void
 SpectrumValue::Divide(const SpectrumValue& x)
 {
-    Values::iterator it1 = m_values.begin();
-    Values::const_iterator it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
     NS_ASSERT(m_values.size() == x.m_values.size());
-
-    while (it1 != m_values.end())
-    {
-        *it1 /= *it2;
-        ++it1;
-        ++it2;
-    }
+    Apply<DivideOp>(m_values, VectorOperand{x.m_values.data()});
 }
 
 void
 SpectrumValue::Divide(double s)
 {
     NS_LOG_FUNCTION(this << s);
-    Values::iterator it1 = m_values.begin();
+    Apply<DivideOp>(m_values, ScalarOperand{s});
+}
 
-    while (it1 != m_values.end())
-    {
-        *it1 /= s;
-        ++it1;
-    }
+void
+SpectrumValue::DivideFrom(const SpectrumValue& x)
+{
+    NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
+    NS_ASSERT(m_values.size() == x.m_values.size());
+    Apply<DivideFromOp>(m_values, VectorOperand{x.m_values.data()});
+}
+
+void
+SpectrumValue::MultiplyAdd(const SpectrumValue& x, const SpectrumValue& y)
+{
+    NS_ASSERT(m_spectrumModel == x.m_spectrumModel && m_spectrumModel == y.m_spectrumModel);
+    NS_ASSERT(m_values.size() == x.m_values.size() && m_values.size() == y.m_values.size());
+    Apply<MultiplyAddOp>(m_values,
+                         VectorOperand{x.m_values.data()},
+                         VectorOperand{y.m_values.data()});
+}
+
+void
+SpectrumValue::ScaleAdd(double s, const SpectrumValue& x)
+{
+    NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
+    NS_ASSERT(m_values.size() == x.m_values.size());
+    Apply<MultiplyAddOp>(m_values, VectorOperand{x.m_values.data()}, ScalarOperand{s});
 }
 
 void
@@ -403,154 +646,163 @@ operator<<(std::ostream& os, const SpectrumValue& pvf)
 }
 
 SpectrumValue
-operator+(const SpectrumValue& lhs, const SpectrumValue& rhs)
+operator+(SpectrumValue lhs, const SpectrumValue& rhs)
 {
-    SpectrumValue res = lhs;
-    res.Add(rhs);
-    return res;
+    lhs.Add(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator+(const SpectrumValue& lhs, double rhs)
+operator+(const SpectrumValue& lhs, SpectrumValue&& rhs)
 {
-    SpectrumValue res = lhs;
-    res.Add(rhs);
-    return res;
+    rhs.Add(lhs);
+    return std::move(rhs);
 }
 
 SpectrumValue
-operator+(double lhs, const SpectrumValue& rhs)
+operator+(SpectrumValue lhs, double rhs)
 {
-    SpectrumValue res = rhs;
-    res.Add(lhs);
-    return res;
+    lhs.Add(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator-(const SpectrumValue& lhs, const SpectrumValue& rhs)
+operator+(double lhs, SpectrumValue rhs)
 {
-    SpectrumValue res = rhs;
-    res.ChangeSign();
-    res.Add(lhs);
-    return res;
+    rhs.Add(lhs);
+    return rhs;
 }
 
 SpectrumValue
-operator-(const SpectrumValue& lhs, double rhs)
+operator-(SpectrumValue lhs, const SpectrumValue& rhs)
 {
-    SpectrumValue res = lhs;
-    res.Subtract(rhs);
-    return res;
+    lhs.Subtract(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator-(double lhs, const SpectrumValue& rhs)
+operator-(const SpectrumValue& lhs, SpectrumValue&& rhs)
 {
-    SpectrumValue res = rhs;
-    res.Subtract(lhs);
-    return res;
+    rhs.SubtractFrom(lhs);
+    return std::move(rhs);
 }
 
 SpectrumValue
-operator*(const SpectrumValue& lhs, const SpectrumValue& rhs)
+operator-(SpectrumValue lhs, double rhs)
 {
-    SpectrumValue res = lhs;
-    res.Multiply(rhs);
-    return res;
+    lhs.Subtract(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator*(const SpectrumValue& lhs, double rhs)
+operator-(double lhs, SpectrumValue rhs)
 {
-    SpectrumValue res = lhs;
-    res.Multiply(rhs);
-    return res;
+    rhs.Subtract(lhs);
+    return rhs;
 }
 
 SpectrumValue
-operator*(double lhs, const SpectrumValue& rhs)
+operator*(SpectrumValue lhs, const SpectrumValue& rhs)
 {
-    SpectrumValue res = rhs;
-    res.Multiply(lhs);
-    return res;
+    lhs.Multiply(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator/(const SpectrumValue& lhs, const SpectrumValue& rhs)
+operator*(const SpectrumValue& lhs, SpectrumValue&& rhs)
 {
-    SpectrumValue res = lhs;
-    res.Divide(rhs);
-    return res;
+    rhs.Multiply(lhs);
+    return std::move(rhs);
 }
 
 SpectrumValue
-operator/(const SpectrumValue& lhs, double rhs)
+operator*(SpectrumValue lhs, double rhs)
 {
-    SpectrumValue res = lhs;
-    res.Divide(rhs);
-    return res;
+    lhs.Multiply(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator/(double lhs, const SpectrumValue& rhs)
+operator*(double lhs, SpectrumValue rhs)
 {
-    SpectrumValue res = rhs;
-    res.Divide(lhs);
-    return res;
+    rhs.Multiply(lhs);
+    return rhs;
+}
+
+SpectrumValue
+operator/(SpectrumValue lhs, const SpectrumValue& rhs)
+{
+    lhs.Divide(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator+(const SpectrumValue& rhs)
+operator/(const SpectrumValue& lhs, SpectrumValue&& rhs)
 {
+    rhs.DivideFrom(lhs);
+    return std::move(rhs);
+}
+
+SpectrumValue
+operator/(SpectrumValue lhs, double rhs)
+{
+    lhs.Divide(rhs);
+    return lhs;
+}
+
+SpectrumValue
+operator/(double lhs, SpectrumValue rhs)
+{
+    rhs.Divide(lhs);
     return rhs;
 }
 
 SpectrumValue
-operator-(const SpectrumValue& rhs)
+operator+(SpectrumValue rhs)
 {
-    SpectrumValue res = rhs;
-    res.ChangeSign();
-    return res;
+    return rhs;
 }
 
 SpectrumValue
-Pow(double lhs, const SpectrumValue& rhs)
+operator-(SpectrumValue rhs)
 {
-    SpectrumValue res = rhs;
-    res.Exp(lhs);
-    return res;
+    rhs.ChangeSign();
+    return rhs;
 }
 
 SpectrumValue
-Pow(const SpectrumValue& lhs, double rhs)
+Pow(double lhs, SpectrumValue rhs)
 {
-    SpectrumValue res = lhs;
-    res.Pow(rhs);
-    return res;
+    rhs.Exp(lhs);
+    return rhs;
 }
 
 SpectrumValue
-Log10(const SpectrumValue& arg)
+Pow(SpectrumValue lhs, double rhs)
 {
-    SpectrumValue res = arg;
-    res.Log10();
-    return res;
+    lhs.Pow(rhs);
+    return lhs;
 }
 
 SpectrumValue
-Log2(const SpectrumValue& arg)
+Log10(SpectrumValue arg)
 {
-    SpectrumValue res = arg;
-    res.Log2();
-    return res;
+    arg.Log10();
+    return arg;
 }
 
 SpectrumValue
-Log(const SpectrumValue& arg)
+Log2(SpectrumValue arg)
 {
-    SpectrumValue res = arg;
-    res.Log();
-    return res;
+    arg.Log2();
+    return arg;
+}
+
+SpectrumValue
+Log(SpectrumValue arg)
+{
+    arg.Log();
+    return arg;
 }
 
 SpectrumValue&
@@ -612,13 +864,7 @@ SpectrumValue::operator/=(double rhs)
 SpectrumValue&
 SpectrumValue::operator=(double rhs)
 {
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
-    {
-        *it1 = rhs;
-        ++it1;
-    }
+    std::fill(m_values.begin(), m_values.end(), rhs);
     return *this;
 }
 
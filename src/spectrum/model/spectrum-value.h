@@ -55,6 +55,13 @@ typedef std::vector<double> Values;
  * The intended use of this class is to represent frequency-dependent
  * things, such as power spectral densities, frequency-dependent
  * propagation losses, spectral masks, etc.
+ *
+ * The arithmetic operators take their operands by value or by rvalue
+ * reference, so that the temporaries of an expression such as
+ * a * b + c are reused for its result rather than allocated for each
+ * operation, and the element-wise operations use SIMD instructions where
+ * available.  MultiplyAdd and ScaleAdd accumulate a product into an
+ * existing value without any temporary.
  */
 class SpectrumValue : public SimpleRefCount<SpectrumValue>
 {
@@ -173,7 +180,19 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs + rhs
      */
-    friend SpectrumValue operator+(const SpectrumValue& lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator+(SpectrumValue lhs, const SpectrumValue& rhs);
+
+    /**
+     *  addition operator
+     *
+     * The result is computed in the storage of rhs, which is moved from.
+     *
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     *
+     * @return the value of lhs + rhs
+     */
+    friend SpectrumValue operator+(const SpectrumValue& lhs, SpectrumValue&& rhs);
 
     /**
      *  addition operator
@@ -183,7 +202,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs + rhs
      */
-    friend SpectrumValue operator+(const SpectrumValue& lhs, double rhs);
+    friend SpectrumValue operator+(SpectrumValue lhs, double rhs);
 
     /**
      *  addition operator
@@ -193,17 +212,29 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs + rhs
      */
-    friend SpectrumValue operator+(double lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator+(double lhs, SpectrumValue rhs);
+
+    /**
+     *  subtraction operator
+     *
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     *
+     * @return the value of lhs - rhs
+     */
+    friend SpectrumValue operator-(SpectrumValue lhs, const SpectrumValue& rhs);
 
     /**
      *  subtraction operator
      *
+     * The result is computed in the storage of rhs, which is moved from.
+     *
      * @param lhs Left Hand Side of the operator
      * @param rhs Right Hand Side of the operator
      *
      * @return the value of lhs - rhs
      */
-    friend SpectrumValue operator-(const SpectrumValue& lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator-(const SpectrumValue& lhs, SpectrumValue&& rhs);
 
     /**
      *  subtraction operator
@@ -213,7 +244,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs - rhs
      */
-    friend SpectrumValue operator-(const SpectrumValue& lhs, double rhs);
+    friend SpectrumValue operator-(SpectrumValue lhs, double rhs);
 
     /**
      *  subtraction operator
@@ -223,7 +254,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs - rhs
      */
-    friend SpectrumValue operator-(double lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator-(double lhs, SpectrumValue rhs);
 
     /**
      *  multiplication component-by-component (Schur product)
@@ -233,7 +264,19 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs * rhs
      */
-    friend SpectrumValue operator*(const SpectrumValue& lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator*(SpectrumValue lhs, const SpectrumValue& rhs);
+
+    /**
+     *  multiplication component-by-component (Schur product)
+     *
+     * The result is computed in the storage of rhs, which is moved from.
+     *
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     *
+     * @return the value of lhs * rhs
+     */
+    friend SpectrumValue operator*(const SpectrumValue& lhs, SpectrumValue&& rhs);
 
     /**
      *  multiplication by a scalar
@@ -243,7 +286,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs * rhs
      */
-    friend SpectrumValue operator*(const SpectrumValue& lhs, double rhs);
+    friend SpectrumValue operator*(SpectrumValue lhs, double rhs);
 
     /**
      *  multiplication of a scalar
@@ -253,17 +296,29 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs * rhs
      */
-    friend SpectrumValue operator*(double lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator*(double lhs, SpectrumValue rhs);
+
+    /**
+     *  division component-by-component
+     *
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     *
+     * @return the value of lhs / rhs
+     */
+    friend SpectrumValue operator/(SpectrumValue lhs, const SpectrumValue& rhs);
 
     /**
      *  division component-by-component
      *
+     * The result is computed in the storage of rhs, which is moved from.
+     *
      * @param lhs Left Hand Side of the operator
      * @param rhs Right Hand Side of the operator
      *
      * @return the value of lhs / rhs
      */
-    friend SpectrumValue operator/(const SpectrumValue& lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator/(const SpectrumValue& lhs, SpectrumValue&& rhs);
 
     /**
      * division by a scalar
@@ -273,7 +328,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of *this / rhs
      */
-    friend SpectrumValue operator/(const SpectrumValue& lhs, double rhs);
+    friend SpectrumValue operator/(SpectrumValue lhs, double rhs);
 
     /**
      * division of a scalar
@@ -283,7 +338,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of *this / rhs
      */
-    friend SpectrumValue operator/(double lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator/(double lhs, SpectrumValue rhs);
 
     /**
      * unary plus operator
@@ -291,7 +346,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      * @param rhs Right Hand Side of the operator
      * @return the value of *this
      */
-    friend SpectrumValue operator+(const SpectrumValue& rhs);
+    friend SpectrumValue operator+(SpectrumValue rhs);
 
     /**
      * unary minus operator
@@ -299,7 +354,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      * @param rhs Right Hand Side of the operator
      * @return the value of - *this
      */
-    friend SpectrumValue operator-(const SpectrumValue& rhs);
+    friend SpectrumValue operator-(SpectrumValue rhs);
 
     /**
      * left shift operator
@@ -409,6 +464,24 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      */
     SpectrumValue& operator=(double rhs);
 
+    /**
+     * Add the product of two SpectrumValues, component by component, to
+     * *this, i.e., compute *this += x * y without creating a temporary.
+     *
+     * @param x the first factor
+     * @param y the second factor
+     */
+    void MultiplyAdd(const SpectrumValue& x, const SpectrumValue& y);
+
+    /**
+     * Add a SpectrumValue multiplied by a scalar to *this, i.e., compute
+     * *this += s * x without creating a temporary.
+     *
+     * @param s the scalar
+     * @param x the SpectrumValue
+     */
+    void ScaleAdd(double s, const SpectrumValue& x);
+
     /**
      *
      * @param x the operand
@@ -443,7 +516,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return each value in base raised to the exponent
      */
-    friend SpectrumValue Pow(const SpectrumValue& lhs, double rhs);
+    friend SpectrumValue Pow(SpectrumValue lhs, double rhs);
 
     /**
      *
@@ -452,7 +525,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value in base raised to each value in the exponent
      */
-    friend SpectrumValue Pow(double lhs, const SpectrumValue& rhs);
+    friend SpectrumValue Pow(double lhs, SpectrumValue rhs);
 
     /**
      *
@@ -461,7 +534,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the logarithm in base 10 of all values in the argument
      */
-    friend SpectrumValue Log10(const SpectrumValue& arg);
+    friend SpectrumValue Log10(SpectrumValue arg);
 
     /**
      *
@@ -470,7 +543,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the logarithm in base 2 of all values in the argument
      */
-    friend SpectrumValue Log2(const SpectrumValue& arg);
+    friend SpectrumValue Log2(SpectrumValue arg);
 
     /**
      *
@@ -479,7 +552,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the logarithm in base e of all values in the argument
      */
-    friend SpectrumValue Log(const SpectrumValue& arg);
+    friend SpectrumValue Log(SpectrumValue arg);
 
     /**
      *
@@ -527,6 +600,11 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      * \param s flat value
      */
     void Subtract(double s);
+    /**
+     * Subtracts the current elements from a SpectrumValue (element by element)
+     * \param x SpectrumValue
+     */
+    void SubtractFrom(const SpectrumValue& x);
     /**
      * Multiplies for a SpectrumValue (element to element multiplication)
      * \param x SpectrumValue
@@ -547,6 +625,11 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      * \param s flat value
      */
     void Divide(double s);
+    /**
+     * Divides a SpectrumValue by the current elements (element by element)
+     * \param x SpectrumValue
+     */
+    void DivideFrom(const SpectrumValue& x);
     /**
      * Change the values sign
      */
@@ -604,11 +687,11 @@ std::ostream& operator<<(std::ostream& os, const SpectrumValue& pvf);
 double Norm(const SpectrumValue& x);
 double Sum(const SpectrumValue& x);
 double Prod(const SpectrumValue& x);
-SpectrumValue Pow(const SpectrumValue& lhs, double rhs);
-SpectrumValue Pow(double lhs, const SpectrumValue& rhs);
-SpectrumValue Log10(const SpectrumValue& arg);
-SpectrumValue Log2(const SpectrumValue& arg);
-SpectrumValue Log(const SpectrumValue& arg);
+SpectrumValue Pow(SpectrumValue lhs, double rhs);
+SpectrumValue Pow(double lhs, SpectrumValue rhs);
+SpectrumValue Log10(SpectrumValue arg);
+SpectrumValue Log2(SpectrumValue arg);
+SpectrumValue Log(SpectrumValue arg);
 double Integral(const SpectrumValue& arg);
 
 } // namespace ns3
@@ -0,0 +1,256 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/boolean.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/log.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/net-device.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/simulator.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/test.h>
+
+#include <tuple>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE("SpectrumChannelTest");
+
+using namespace ns3;
+
+/// A reception: the time, the ID of the receiver and the received power
+using Reception = std::tuple<Time, uint32_t, double>;
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief A SpectrumPhy logging the receptions.
+ *
+ * Each reception also schedules an event logged at the same time, to check
+ * the order of the receptions with respect to the events they schedule.
+ */
+class LoggingSpectrumPhy : public SpectrumPhy
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param id the ID of the PHY
+     * \param model the spectrum model of the receptions
+     * \param log the log of the receptions
+     */
+    LoggingSpectrumPhy(uint32_t id, Ptr<const SpectrumModel> model, std::vector<Reception>* log);
+
+    void SetDevice(Ptr<NetDevice> d) override;
+    Ptr<NetDevice> GetDevice() const override;
+    void SetMobility(Ptr<MobilityModel> m) override;
+    Ptr<MobilityModel> GetMobility() const override;
+    void SetChannel(Ptr<SpectrumChannel> c) override;
+    Ptr<const SpectrumModel> GetRxSpectrumModel() const override;
+    Ptr<Object> GetAntenna() const override;
+    void StartRx(Ptr<SpectrumSignalParameters> params) override;
+
+  private:
+    uint32_t m_id;                    //!< the ID of the PHY
+    Ptr<const SpectrumModel> m_model; //!< the spectrum model of the receptions
+    Ptr<MobilityModel> m_mobility;    //!< the mobility model
+    std::vector<Reception>* m_log;    //!< the log of the receptions
+};
+
+LoggingSpectrumPhy::LoggingSpectrumPhy(uint32_t id,
+                                       Ptr<const SpectrumModel> model,
+                                       std::vector<Reception>* log)
+    : m_id(id),
+      m_model(model),
+      m_log(log)
+{
+}
+
+void
+LoggingSpectrumPhy::SetDevice(Ptr<NetDevice> d)
+{
+}
+
+Ptr<NetDevice>
+LoggingSpectrumPhy::GetDevice() const
+{
+    return nullptr;
+}
+
+void
+LoggingSpectrumPhy::SetMobility(Ptr<MobilityModel> m)
+{
+    m_mobility = m;
+}
+
+Ptr<MobilityModel>
+LoggingSpectrumPhy::GetMobility() const
+{
+    return m_mobility;
+}
+
+void
+LoggingSpectrumPhy::SetChannel(Ptr<SpectrumChannel> c)
+{
+}
+
+Ptr<const SpectrumModel>
+LoggingSpectrumPhy::GetRxSpectrumModel() const
+{
+    return m_model;
+}
+
+Ptr<Object>
+LoggingSpectrumPhy::GetAntenna() const
+{
+    return nullptr;
+}
+
+void
+LoggingSpectrumPhy::StartRx(Ptr<SpectrumSignalParameters> params)
+{
+    m_log->emplace_back(Simulator::Now(), m_id, (*params->psd)[0]);
+    Simulator::ScheduleNow([this]() { m_log->emplace_back(Simulator::Now(), m_id + 1000, 0); });
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Test that batching the receptions with the same propagation delay
+ * leaves the receptions and their order unchanged.
+ */
+class SpectrumChannelBatchReceptionsTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param multiModel whether to test MultiModelSpectrumChannel rather than
+     *                   SingleModelSpectrumChannel
+     */
+    SpectrumChannelBatchReceptionsTestCase(bool multiModel);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Transmit two signals from two of a set of receivers, some of which are at
+     * the same distance from the transmitters.
+     *
+     * \param batch the value of the BatchReceptions attribute
+     * \param log the log of the receptions
+     * \returns the number of events executed
+     */
+    uint64_t Run(bool batch, std::vector<Reception>& log);
+
+    bool m_multiModel; //!< whether to test MultiModelSpectrumChannel
+};
+
+SpectrumChannelBatchReceptionsTestCase::SpectrumChannelBatchReceptionsTestCase(bool multiModel)
+    : TestCase(std::string("Check the batched receptions of ") +
+               (multiModel ? "MultiModelSpectrumChannel" : "SingleModelSpectrumChannel")),
+      m_multiModel(multiModel)
+{
+}
+
+uint64_t
+SpectrumChannelBatchReceptionsTestCase::Run(bool batch, std::vector<Reception>& log)
+{
+    Ptr<SpectrumChannel> channel;
+    if (m_multiModel)
+    {
+        channel = CreateObject<MultiModelSpectrumChannel>();
+    }
+    else
+    {
+        channel = CreateObject<SingleModelSpectrumChannel>();
+    }
+    channel->SetAttribute("BatchReceptions", BooleanValue(batch));
+    channel->AddPropagationLossModel(CreateObject<FriisPropagationLossModel>());
+    channel->SetPropagationDelayModel(CreateObject<ConstantSpeedPropagationDelayModel>());
+
+    Ptr<SpectrumModel> model = Create<SpectrumModel>(std::vector<double>{2.4e9, 2.41e9});
+    // a 3x3 grid: the receivers on each side of the transmitters are equidistant
+    std::vector<Ptr<LoggingSpectrumPhy>> phys;
+    for (uint32_t id = 0; id < 9; ++id)
+    {
+        Ptr<LoggingSpectrumPhy> phy = CreateObject<LoggingSpectrumPhy>(id, model, &log);
+        Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(Vector((id % 3) * 30.0, (id / 3) * 30.0, 0));
+        phy->SetMobility(mobility);
+        channel->AddRx(phy);
+        phys.push_back(phy);
+    }
+
+    for (uint32_t tx : {4, 0})
+    {
+        Simulator::Schedule(NanoSeconds(50 * tx), [=]() {
+            Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters>();
+            params->psd = Create<SpectrumValue>(model);
+            (*params->psd) = 1e-3;
+            params->duration = MicroSeconds(100);
+            params->txPhy = phys[tx];
+            channel->StartTx(params);
+        });
+    }
+    uint64_t events = Simulator::GetEventCount();
+    Simulator::Run();
+    events = Simulator::GetEventCount() - events;
+    Simulator::Destroy();
+    return events;
+}
+
+void
+SpectrumChannelBatchReceptionsTestCase::DoRun()
+{
+    std::vector<Reception> expected;
+    uint64_t events = Run(false, expected);
+    std::vector<Reception> log;
+    uint64_t batchedEvents = Run(true, log);
+
+    NS_TEST_ASSERT_MSG_EQ(log.size(), 4U * 8, "Unexpected number of receptions");
+    NS_TEST_ASSERT_MSG_EQ(log.size(), expected.size(), "Unexpected number of receptions");
+    for (std::size_t i = 0; i < log.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(std::get<0>(log[i]), std::get<0>(expected[i]), "Wrong time " << i);
+        NS_TEST_EXPECT_MSG_EQ(std::get<1>(log[i]), std::get<1>(expected[i]), "Wrong PHY " << i);
+        NS_TEST_EXPECT_MSG_EQ(std::get<2>(log[i]), std::get<2>(expected[i]), "Wrong power " << i);
+    }
+    // the 8 receivers of the center are at 2 distances, and those of the corner at 5
+    NS_TEST_EXPECT_MSG_EQ(events - batchedEvents, 16U - 2 - 5, "Unexpected number of events");
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Spectrum Channel TestSuite
+ */
+class SpectrumChannelTestSuite : public TestSuite
+{
+  public:
+    SpectrumChannelTestSuite();
+};
+
+SpectrumChannelTestSuite::SpectrumChannelTestSuite()
+    : TestSuite("spectrum-channel", UNIT)
+{
+    AddTestCase(new SpectrumChannelBatchReceptionsTestCase(false), TestCase::QUICK);
+    AddTestCase(new SpectrumChannelBatchReceptionsTestCase(true), TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static SpectrumChannelTestSuite g_spectrumChannelTestSuite;
@@ -26,6 +26,7 @@
 #include <ns3/test.h>
 
 #include <cmath>
+#include <functional>
 #include <iostream>
 
 using namespace ns3;
@@ -93,6 +94,94 @@ SpectrumValueTestCase::DoRun()
     NS_TEST_ASSERT_MSG_SPECTRUM_VALUE_EQ_TOL(m_a, m_b, TOLERANCE, "");
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Test the element-wise operations of SpectrumValue on values of
+ * various sizes, which exercises both the SIMD and the scalar code paths.
+ */
+class SpectrumValueOperationsTestCase : public TestCase
+{
+  public:
+    SpectrumValueOperationsTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Check that all the elements of a value are equal to the expected ones.
+     * \param value the value
+     * \param expected the expected element at each index
+     * \param name the name of the operation
+     */
+    void Check(const SpectrumValue& value,
+               std::function<double(std::size_t)> expected,
+               const std::string& name);
+};
+
+SpectrumValueOperationsTestCase::SpectrumValueOperationsTestCase()
+    : TestCase("SpectrumValue element-wise operations")
+{
+}
+
+void
+SpectrumValueOperationsTestCase::Check(const SpectrumValue& value,
+                                       std::function<double(std::size_t)> expected,
+                                       const std::string& name)
+{
+    for (std::size_t i = 0; i < value.GetValuesN(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(value[i],
+                              expected(i),
+                              name << " of " << value.GetValuesN() << " values, index " << i);
+    }
+}
+
+void
+SpectrumValueOperationsTestCase::DoRun()
+{
+    // sizes around the SIMD widths, and those of a 100 RB LTE carrier and a 996 tone HE RU
+    for (std::size_t n : {2, 3, 4, 5, 7, 8, 100, 996, 1001})
+    {
+        std::vector<double> freqs;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            freqs.push_back(1e9 + i * 15e3);
+        }
+        Ptr<SpectrumModel> model = Create<SpectrumModel>(freqs);
+        SpectrumValue a(model);
+        SpectrumValue b(model);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            a[i] = 3 * std::sin(i + 1.0);
+            b[i] = 2 + std::cos(0.7 * i);
+        }
+        const double s = 1.123456;
+
+        Check(a + b, [&](std::size_t i) { return a[i] + b[i]; }, "a + b");
+        Check(a - b, [&](std::size_t i) { return a[i] - b[i]; }, "a - b");
+        Check(a * b, [&](std::size_t i) { return a[i] * b[i]; }, "a * b");
+        Check(a / b, [&](std::size_t i) { return a[i] / b[i]; }, "a / b");
+        Check(a + SpectrumValue(b), [&](std::size_t i) { return a[i] + b[i]; }, "a + b&&");
+        Check(a - SpectrumValue(b), [&](std::size_t i) { return a[i] - b[i]; }, "a - b&&");
+        Check(a * SpectrumValue(b), [&](std::size_t i) { return a[i] * b[i]; }, "a * b&&");
+        Check(a / SpectrumValue(b), [&](std::size_t i) { return a[i] / b[i]; }, "a / b&&");
+        Check(a + s, [&](std::size_t i) { return a[i] + s; }, "a + s");
+        Check(a - s, [&](std::size_t i) { return a[i] - s; }, "a - s");
+        Check(s * a, [&](std::size_t i) { return s * a[i]; }, "s * a");
+        Check(a / s, [&](std::size_t i) { return a[i] / s; }, "a / s");
+        Check(-a, [&](std::size_t i) { return -a[i]; }, "-a");
+        Check((a * b + a) / b, [&](std::size_t i) { return (a[i] * b[i] + a[i]) / b[i]; }, "chain");
+
+        SpectrumValue c = b;
+        c.MultiplyAdd(a, b);
+        Check(c, [&](std::size_t i) { return b[i] + a[i] * b[i]; }, "MultiplyAdd");
+        c = b;
+        c.ScaleAdd(s, a);
+        Check(c, [&](std::size_t i) { return b[i] + s * a[i]; }, "ScaleAdd");
+    }
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -107,6 +196,8 @@ class SpectrumValueTestSuite : public TestSuite
 SpectrumValueTestSuite::SpectrumValueTestSuite()
     : TestSuite("spectrum-value", UNIT)
 {
+    AddTestCase(new SpectrumValueOperationsTestCase, TestCase::QUICK);
+
     // NS_LOG_INFO("creating SpectrumValueTestSuite");
 
     std::vector<double> freqs;
@@ -0,0 +1,131 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This example can be used to benchmark the BatchReceptions attribute of the
+// Wi-Fi channels. A grid of access points sends beacons, each of which is
+// received by all the other access points. The receptions with the same
+// propagation delay are started by a single event if batching is enabled;
+// increase the propagation speed to make more delays equal.
+//
+// Sample usage:
+//   ./ns3 run 'wifi-batch-receptions --nAps=400 --batch=1'
+//   ./ns3 run 'wifi-batch-receptions --nAps=400 --batch=1 --spectrum=1 --speed=3e14'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/double.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-wifi-helper.h"
+#include "ns3/ssid.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+#include "ns3/wifi-mac-helper.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/yans-wifi-helper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sys/resource.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("WifiBatchReceptions");
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nAps = 100;
+    double distance = 10;
+    double speed = 299792458.0;
+    double simulationTime = 10;
+    bool spectrum = false;
+    bool batch = true;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the batched receptions of the beacons of a grid of access points");
+    cmd.AddValue("nAps", "Number of access points", nAps);
+    cmd.AddValue("distance", "Distance between neighbor access points (m)", distance);
+    cmd.AddValue("speed", "Propagation speed (m/s)", speed);
+    cmd.AddValue("simulationTime", "Simulation time (s)", simulationTime);
+    cmd.AddValue("spectrum", "Use SpectrumWifiPhy rather than YansWifiPhy", spectrum);
+    cmd.AddValue("batch", "Batch the receptions with the same propagation delay", batch);
+    cmd.Parse(argc, argv);
+
+    NodeContainer nodes;
+    nodes.Create(nAps);
+
+    Ptr<PropagationLossModel> loss = CreateObject<LogDistancePropagationLossModel>();
+    Ptr<PropagationDelayModel> delay =
+        CreateObjectWithAttributes<ConstantSpeedPropagationDelayModel>("Speed", DoubleValue(speed));
+
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211a);
+    WifiMacHelper mac;
+    mac.SetType("ns3::ApWifiMac", "Ssid", SsidValue(Ssid("batch")));
+
+    NetDeviceContainer devices;
+    if (spectrum)
+    {
+        Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel>();
+        channel->SetAttribute("BatchReceptions", BooleanValue(batch));
+        channel->AddPropagationLossModel(loss);
+        channel->SetPropagationDelayModel(delay);
+        SpectrumWifiPhyHelper phy;
+        phy.SetChannel(channel);
+        devices = wifi.Install(phy, mac, nodes);
+    }
+    else
+    {
+        Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel>();
+        channel->SetAttribute("BatchReceptions", BooleanValue(batch));
+        channel->SetPropagationLossModel(loss);
+        channel->SetPropagationDelayModel(delay);
+        YansWifiPhyHelper phy;
+        phy.SetChannel(channel);
+        devices = wifi.Install(phy, mac, nodes);
+    }
+    wifi.AssignStreams(devices, 1);
+
+    MobilityHelper mobility;
+    mobility.SetPositionAllocator("ns3::GridPositionAllocator",
+                                  "DeltaX",
+                                  DoubleValue(distance),
+                                  "DeltaY",
+                                  DoubleValue(distance),
+                                  "GridWidth",
+                                  UintegerValue(std::max<uint32_t>(1, std::sqrt(nAps))));
+    mobility.Install(nodes);
+
+    Simulator::Stop(Seconds(simulationTime));
+    SystemWallClockMs clock;
+    clock.Start();
+    Simulator::Run();
+    int64_t elapsed = std::max<int64_t>(1, clock.End());
+    uint64_t events = Simulator::GetEventCount();
+    Simulator::Destroy();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << (spectrum ? "spectrum" : "yans") << (batch ? " batched" : "") << ": " << events
+              << " events in " << elapsed << " ms (" << events * 1000.0 / elapsed
+              << " events/s), max RSS " << usage.ru_maxrss / 1024 << " MB" << std::endl;
+
+    return 0;
+}
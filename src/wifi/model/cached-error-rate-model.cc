@@ -0,0 +1,380 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "cached-error-rate-model.h"
+
+#include "nist-error-rate-model.h"
+#include "wifi-tx-vector.h"
+#include "wifi-utils.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+
+namespace ns3
+{
+
+/// The bound of the log(-log(csr)) values, beyond which csr is 0 or 1 in double precision
+static const double CACHED_ERROR_RATE_MODEL_BOUND = 700;
+
+NS_LOG_COMPONENT_DEFINE("CachedErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED(CachedErrorRateModel);
+
+TypeId
+CachedErrorRateModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CachedErrorRateModel")
+            .SetParent<ErrorRateModel>()
+            .SetGroupName("Wifi")
+            .AddConstructor<CachedErrorRateModel>()
+            .AddAttribute("ErrorRateModel",
+                          "The error rate model whose chunk success rates are cached.",
+                          PointerValue(CreateObject<NistErrorRateModel>()),
+                          MakePointerAccessor(&CachedErrorRateModel::SetErrorRateModel,
+                                              &CachedErrorRateModel::GetErrorRateModel),
+                          MakePointerChecker<ErrorRateModel>())
+            .AddAttribute("MinSnr",
+                          "The lowest SNR (dB) of the tables. The chunk success rates of the "
+                          "lower SNRs are computed by the error rate model.",
+                          DoubleValue(-10),
+                          MakeDoubleAccessor(&CachedErrorRateModel::m_minSnrDb),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("MaxSnr",
+                          "The highest SNR (dB) of the tables. The chunk success rates of the "
+                          "higher SNRs are computed by the error rate model.",
+                          DoubleValue(50),
+                          MakeDoubleAccessor(&CachedErrorRateModel::m_maxSnrDb),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("SnrStep",
+                          "The SNR step (dB) of the tables.",
+                          DoubleValue(0.1),
+                          MakeDoubleAccessor(&CachedErrorRateModel::m_snrStepDb),
+                          MakeDoubleChecker<double>(0.001))
+            .AddAttribute("MaxBitsExponent",
+                          "The largest chunk size of the tables is 2 to the power of this "
+                          "value, in bits. The chunk success rates of the larger chunks are "
+                          "computed by the error rate model.",
+                          UintegerValue(26),
+                          MakeUintegerAccessor(&CachedErrorRateModel::m_maxBitsExponent),
+                          MakeUintegerChecker<uint8_t>(1, 62))
+            .AddAttribute("CacheFile",
+                          "The file the tables are read from and appended to, so that they "
+                          "are only computed once. Empty to compute the tables in each run.",
+                          StringValue(""),
+                          MakeStringAccessor(&CachedErrorRateModel::m_cacheFile),
+                          MakeStringChecker());
+    return tid;
+}
+
+CachedErrorRateModel::CachedErrorRateModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+CachedErrorRateModel::~CachedErrorRateModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+CachedErrorRateModel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_tables.clear();
+    m_model = nullptr;
+    ErrorRateModel::DoDispose();
+}
+
+void
+CachedErrorRateModel::SetErrorRateModel(Ptr<ErrorRateModel> model)
+{
+    NS_LOG_FUNCTION(this << model);
+    m_model = model;
+    m_tables.clear();
+}
+
+Ptr<ErrorRateModel>
+CachedErrorRateModel::GetErrorRateModel() const
+{
+    return m_model;
+}
+
+bool
+CachedErrorRateModel::IsAwgn() const
+{
+    return !m_model || m_model->IsAwgn();
+}
+
+int64_t
+CachedErrorRateModel::AssignStreams(int64_t stream)
+{
+    return m_model ? m_model->AssignStreams(stream) : 0;
+}
+
+bool
+CachedErrorRateModel::TableKey::operator<(const TableKey& other) const
+{
+    return std::tie(mode, channelWidth, guardInterval, nss, ruType, ldpc, header, numRxAntennas) <
+           std::tie(other.mode,
+                    other.channelWidth,
+                    other.guardInterval,
+                    other.nss,
+                    other.ruType,
+                    other.ldpc,
+                    other.header,
+                    other.numRxAntennas);
+}
+
+CachedErrorRateModel::TableKey
+CachedErrorRateModel::GetTableKey(WifiMode mode,
+                                  const WifiTxVector& txVector,
+                                  uint8_t numRxAntennas,
+                                  uint16_t staId)
+{
+    TableKey key;
+    key.mode = mode.GetUid();
+    key.channelWidth = txVector.GetChannelWidth();
+    key.guardInterval = txVector.GetGuardInterval();
+    key.ldpc = txVector.IsLdpc();
+    key.numRxAntennas = numRxAntennas;
+    if (txVector.IsMu())
+    {
+        key.header = (staId == SU_STA_ID) || (mode != txVector.GetMode(staId));
+        key.nss = (staId == SU_STA_ID) ? 1 : txVector.GetNss(staId);
+        key.ruType = (staId == SU_STA_ID) ? 0 : txVector.GetRu(staId).GetRuType() + 1;
+    }
+    else
+    {
+        key.header = txVector.GetModeInitialized() && (mode != txVector.GetMode());
+        key.nss = txVector.GetNss();
+        key.ruType = 0;
+    }
+    return key;
+}
+
+double
+CachedErrorRateModel::DoGetChunkSuccessRate(WifiMode mode,
+                                            const WifiTxVector& txVector,
+                                            double snr,
+                                            uint64_t nbits,
+                                            uint8_t numRxAntennas,
+                                            WifiPpduField field,
+                                            uint16_t staId) const
+{
+    NS_LOG_FUNCTION(this << mode << txVector << snr << nbits << +numRxAntennas << field << staId);
+    NS_ASSERT_MSG(m_model, "No error rate model to cache");
+    double x = (RatioToDb(snr) - m_minSnrDb) / m_snrStepDb;
+    double maxX = std::round((m_maxSnrDb - m_minSnrDb) / m_snrStepDb);
+    if (nbits == 0 || nbits > (uint64_t(1) << m_maxBitsExponent) || !(x >= 0) || x > maxX)
+    {
+        NS_LOG_LOGIC("out of the tables");
+        return m_model
+            ->GetChunkSuccessRate(mode, txVector, snr, nbits, numRxAntennas, field, staId);
+    }
+
+    TableKey key = GetTableKey(mode, txVector, numRxAntennas, staId);
+    auto it = m_tables.find(key);
+    if (it == m_tables.end())
+    {
+        it = m_tables.emplace(key, GetTable(key, mode, txVector, field, staId)).first;
+    }
+    const Table& table = *it->second;
+
+    // bilinear interpolation in the SNR (dB) and the logarithm of the chunk size
+    double l = std::log2(static_cast<double>(nbits));
+    std::size_t nExponents = m_maxBitsExponent + 1;
+    std::size_t i = std::min<std::size_t>(x, maxX - 1);
+    std::size_t j = std::min<std::size_t>(l, nExponents - 2);
+    double fx = x - i;
+    double fl = l - j;
+    const double* low = &table[i * nExponents + j];
+    const double* high = low + nExponents;
+    double y =
+        (1 - fx) * ((1 - fl) * low[0] + fl * low[1]) + fx * ((1 - fl) * high[0] + fl * high[1]);
+    return std::exp(-std::exp(y));
+}
+
+std::shared_ptr<const CachedErrorRateModel::Table>
+CachedErrorRateModel::GetTable(const TableKey& key,
+                               WifiMode mode,
+                               const WifiTxVector& txVector,
+                               WifiPpduField field,
+                               uint16_t staId) const
+{
+    NS_LOG_FUNCTION(this << mode);
+    NS_ABORT_MSG_IF(m_maxSnrDb - m_minSnrDb < m_snrStepDb, "MaxSnr must exceed MinSnr by SnrStep");
+
+    // the tables are shared by the instances wrapping the same model, possibly
+    // in different threads, and are never modified once computed
+    static std::mutex mutex;
+    static std::map<std::tuple<const ErrorRateModel*, std::string, TableKey>,
+                    std::weak_ptr<const Table>>
+        shared;
+
+    std::string header = GetCacheFileHeader();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = shared[std::make_tuple(PeekPointer(m_model), header, key)];
+    if (auto table = entry.lock())
+    {
+        return table;
+    }
+
+    std::ostringstream oss;
+    oss << mode.GetUniqueName() << "/" << key.channelWidth << "/" << key.guardInterval << "/"
+        << +key.nss << "/" << +key.ruType << "/" << key.ldpc << "/" << key.header << "/"
+        << +key.numRxAntennas;
+    auto table = std::make_shared<Table>();
+    if (!ReadTable(oss.str(), *table))
+    {
+        *table = ComputeTable(key, mode, txVector, field, staId);
+        WriteTable(oss.str(), *table);
+    }
+    entry = table;
+    return table;
+}
+
+CachedErrorRateModel::Table
+CachedErrorRateModel::ComputeTable(const TableKey& key,
+                                   WifiMode mode,
+                                   const WifiTxVector& txVector,
+                                   WifiPpduField field,
+                                   uint16_t staId) const
+{
+    NS_LOG_FUNCTION(this << mode);
+    std::size_t nSnrs = std::round((m_maxSnrDb - m_minSnrDb) / m_snrStepDb) + 1;
+    std::size_t nExponents = m_maxBitsExponent + 1;
+    Table table;
+    table.reserve(nSnrs * nExponents);
+    for (std::size_t i = 0; i < nSnrs; ++i)
+    {
+        double snr = DbToRatio(m_minSnrDb + i * m_snrStepDb);
+        for (std::size_t j = 0; j < nExponents; ++j)
+        {
+            double csr = m_model->GetChunkSuccessRate(mode,
+                                                      txVector,
+                                                      snr,
+                                                      uint64_t(1) << j,
+                                                      key.numRxAntennas,
+                                                      field,
+                                                      staId);
+            double y = CACHED_ERROR_RATE_MODEL_BOUND;
+            if (csr >= 1)
+            {
+                y = -CACHED_ERROR_RATE_MODEL_BOUND;
+            }
+            else if (csr > 0)
+            {
+                y = std::clamp(std::log(-std::log(csr)),
+                               -CACHED_ERROR_RATE_MODEL_BOUND,
+                               CACHED_ERROR_RATE_MODEL_BOUND);
+            }
+            table.push_back(y);
+        }
+    }
+    return table;
+}
+
+std::string
+CachedErrorRateModel::GetCacheFileHeader() const
+{
+    std::ostringstream oss;
+    oss << "ns3::CachedErrorRateModel " << (m_model ? m_model->GetInstanceTypeId().GetName() : "")
+        << " " << m_minSnrDb << " " << m_maxSnrDb << " " << m_snrStepDb << " "
+        << +m_maxBitsExponent;
+    return oss.str();
+}
+
+bool
+CachedErrorRateModel::ReadTable(const std::string& name, Table& table) const
+{
+    NS_LOG_FUNCTION(this << name);
+    if (m_cacheFile.empty())
+    {
+        return false;
+    }
+    std::ifstream file(m_cacheFile);
+    std::string line;
+    if (!std::getline(file, line) || line != GetCacheFileHeader())
+    {
+        return false;
+    }
+    std::size_t size = (std::round((m_maxSnrDb - m_minSnrDb) / m_snrStepDb) + 1) *
+                       (m_maxBitsExponent + 1);
+    while (std::getline(file, line))
+    {
+        std::istringstream iss(line);
+        std::string tableName;
+        if (!(iss >> tableName) || tableName != name)
+        {
+            continue;
+        }
+        table.clear();
+        double y;
+        while (iss >> y)
+        {
+            table.push_back(y);
+        }
+        if (table.size() == size)
+        {
+            NS_LOG_DEBUG("table " << name << " read from " << m_cacheFile);
+            return true;
+        }
+        NS_LOG_WARN("truncated table " << name << " in " << m_cacheFile);
+    }
+    return false;
+}
+
+void
+CachedErrorRateModel::WriteTable(const std::string& name, const Table& table) const
+{
+    NS_LOG_FUNCTION(this << name);
+    if (m_cacheFile.empty())
+    {
+        return;
+    }
+    std::string header = GetCacheFileHeader();
+    std::string line;
+    bool append = std::getline(std::ifstream(m_cacheFile), line) && line == header;
+    std::ofstream file(m_cacheFile, append ? std::ios::app : std::ios::trunc);
+    if (!file)
+    {
+        NS_LOG_WARN("cannot write " << m_cacheFile);
+        return;
+    }
+    if (!append)
+    {
+        file << header << "\n";
+    }
+    file << name << std::setprecision(17);
+    for (double y : table)
+    {
+        file << " " << y;
+    }
+    file << "\n";
+}
+
+} // namespace ns3
@@ -0,0 +1,197 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CACHED_ERROR_RATE_MODEL_H
+#define CACHED_ERROR_RATE_MODEL_H
+
+#include "error-rate-model.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup wifi
+ * \brief Interpolates the chunk success rate of another error rate model in
+ * precomputed tables.
+ *
+ * The first time a Wi-Fi mode is used with a given channel width, guard
+ * interval, number of spatial streams, RU type, LDPC flag and number of RX
+ * antennas, for a PHY header or not, the chunk success rate of the wrapped
+ * model is computed over a grid of SNRs, from MinSnr to MaxSnr with a step
+ * of SnrStep (dB), and of chunk sizes, the powers of two from 1 to
+ * 2^MaxBitsExponent bits. Then the chunk
+ * success rates are interpolated bilinearly in the SNR (dB) and the
+ * logarithm of the chunk size. The interpolated value is log(-log(csr)),
+ * which is linear in the logarithm of the chunk size when the bit errors are
+ * independent, as in NistErrorRateModel and YansErrorRateModel. The SNRs and
+ * the chunk sizes out of the grid are passed to the wrapped model.
+ *
+ * The tables are shared by the instances wrapping the same model, and they
+ * are appended to the CacheFile, if any, from which later runs read them
+ * instead of computing them again. The file is only used if it was built
+ * for the same type of wrapped model and the same grid; it must be removed
+ * when the attributes of the wrapped model change.
+ *
+ * The wrapped model must not depend on other parameters of the chunk, and
+ * its chunk success rate must be smooth in the SNR and in the chunk size.
+ */
+class CachedErrorRateModel : public ErrorRateModel
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    CachedErrorRateModel();
+    ~CachedErrorRateModel() override;
+
+    /**
+     * \param model the error rate model whose chunk success rates are cached
+     */
+    void SetErrorRateModel(Ptr<ErrorRateModel> model);
+
+    /**
+     * \returns the error rate model whose chunk success rates are cached
+     */
+    Ptr<ErrorRateModel> GetErrorRateModel() const;
+
+    bool IsAwgn() const override;
+    int64_t AssignStreams(int64_t stream) override;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    double DoGetChunkSuccessRate(WifiMode mode,
+                                 const WifiTxVector& txVector,
+                                 double snr,
+                                 uint64_t nbits,
+                                 uint8_t numRxAntennas,
+                                 WifiPpduField field,
+                                 uint16_t staId) const override;
+
+    /// The log(-log(csr)) values of a table, by SNR then by chunk size exponent
+    using Table = std::vector<double>;
+
+    /**
+     * The parameters of a chunk other than its SNR and size which may change
+     * its success rate, hence which select a table
+     */
+    struct TableKey
+    {
+        uint32_t mode;          //!< the UID of the Wi-Fi mode
+        uint16_t channelWidth;  //!< the channel width of the TXVECTOR (MHz)
+        uint16_t guardInterval; //!< the guard interval of the TXVECTOR (ns)
+        uint8_t nss;            //!< the number of spatial streams of the station
+        uint8_t ruType;         //!< the type of the RU of the station, for MU
+        bool ldpc;              //!< whether LDPC is used
+        bool header;            //!< whether the chunk belongs to a PHY header
+        uint8_t numRxAntennas;  //!< the number of active RX antennas
+
+        /**
+         * \param other another key
+         * \returns true if this key is lower than the other key
+         */
+        bool operator<(const TableKey& other) const;
+    };
+
+    /**
+     * \param mode the Wi-Fi mode of the chunk
+     * \param txVector the TXVECTOR of the chunk
+     * \param numRxAntennas the number of active RX antennas
+     * \param staId the station ID for MU
+     * \return the key of the table of the chunk
+     */
+    static TableKey GetTableKey(WifiMode mode,
+                                const WifiTxVector& txVector,
+                                uint8_t numRxAntennas,
+                                uint16_t staId);
+
+    /**
+     * Get a table, from the tables shared by the instances wrapping the same
+     * model, from the CacheFile, or by computing it.
+     *
+     * \param key the key of the table
+     * \param mode the Wi-Fi mode of the chunk
+     * \param txVector the TXVECTOR of the chunk
+     * \param field the PPDU field of the chunk
+     * \param staId the station ID for MU
+     * \return the table
+     */
+    std::shared_ptr<const Table> GetTable(const TableKey& key,
+                                          WifiMode mode,
+                                          const WifiTxVector& txVector,
+                                          WifiPpduField field,
+                                          uint16_t staId) const;
+
+    /**
+     * Compute a table with the wrapped model.
+     *
+     * \param key the key of the table
+     * \param mode the Wi-Fi mode of the chunk
+     * \param txVector the TXVECTOR of the chunk
+     * \param field the PPDU field of the chunk
+     * \param staId the station ID for MU
+     * \return the table
+     */
+    Table ComputeTable(const TableKey& key,
+                       WifiMode mode,
+                       const WifiTxVector& txVector,
+                       WifiPpduField field,
+                       uint16_t staId) const;
+
+    /**
+     * \return the header of the CacheFile, identifying the wrapped model and the grid
+     */
+    std::string GetCacheFileHeader() const;
+
+    /**
+     * Read a table from the CacheFile.
+     *
+     * \param name the name of the table
+     * \param table the table read, if found
+     * \return true if the table was found
+     */
+    bool ReadTable(const std::string& name, Table& table) const;
+
+    /**
+     * Append a table to the CacheFile.
+     *
+     * \param name the name of the table
+     * \param table the table
+     */
+    void WriteTable(const std::string& name, const Table& table) const;
+
+    Ptr<ErrorRateModel> m_model; //!< the error rate model whose results are cached
+    double m_minSnrDb;           //!< the lowest SNR of the tables (dB)
+    double m_maxSnrDb;           //!< the highest SNR of the tables (dB)
+    double m_snrStepDb;          //!< the SNR step of the tables (dB)
+    uint8_t m_maxBitsExponent;   //!< the exponent of the largest chunk size of the tables
+    std::string m_cacheFile;     //!< the file persisting the tables, if any
+
+    /// the tables used by this instance
+    mutable std::map<TableKey, std::shared_ptr<const Table>> m_tables;
+};
+
+} // namespace ns3
+
+#endif /* CACHED_ERROR_RATE_MODEL_H */
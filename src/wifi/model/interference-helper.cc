@@ -25,6 +25,7 @@
 #include "wifi-psdu.h"
 #include "wifi-utils.h"
 
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
@@ -178,6 +179,114 @@ InterferenceHelper::NiChange::GetEvent() const
     return m_event;
 }
 
+/****************************************************************
+ *       Class which records SNIR change events in flat arrays
+ ****************************************************************/
+
+InterferenceHelper::FlatNiChanges::FlatNiChanges()
+    : m_begin(0)
+{
+}
+
+std::size_t
+InterferenceHelper::FlatNiChanges::Begin() const
+{
+    return m_begin;
+}
+
+std::size_t
+InterferenceHelper::FlatNiChanges::End() const
+{
+    return m_times.size();
+}
+
+std::size_t
+InterferenceHelper::FlatNiChanges::LowerBound(Time moment) const
+{
+    return std::lower_bound(m_times.begin() + m_begin, m_times.end(), moment) - m_times.begin();
+}
+
+std::size_t
+InterferenceHelper::FlatNiChanges::UpperBound(Time moment) const
+{
+    return std::upper_bound(m_times.begin() + m_begin, m_times.end(), moment) - m_times.begin();
+}
+
+std::size_t
+InterferenceHelper::FlatNiChanges::Find(Ptr<const Event> event, std::size_t from) const
+{
+    auto it = std::find(m_events.begin() + from, m_events.end(), event);
+    return it - m_events.begin();
+}
+
+Time
+InterferenceHelper::FlatNiChanges::GetTime(std::size_t i) const
+{
+    NS_ASSERT(i >= m_begin && i < m_times.size());
+    return m_times[i];
+}
+
+double
+InterferenceHelper::FlatNiChanges::GetPower(std::size_t i) const
+{
+    NS_ASSERT(i >= m_begin && i < m_powers.size());
+    return m_powers[i];
+}
+
+std::size_t
+InterferenceHelper::FlatNiChanges::Insert(Time moment, double power, Ptr<Event> event)
+{
+    std::size_t i = UpperBound(moment);
+    m_times.insert(m_times.begin() + i, moment);
+    m_powers.insert(m_powers.begin() + i, power);
+    m_events.insert(m_events.begin() + i, event);
+    return i;
+}
+
+void
+InterferenceHelper::FlatNiChanges::AddPower(std::size_t first, std::size_t last, double power)
+{
+    NS_ASSERT(first >= m_begin && first <= last && last <= m_powers.size());
+    for (std::size_t i = first; i < last; ++i)
+    {
+        m_powers[i] += power;
+    }
+}
+
+void
+InterferenceHelper::FlatNiChanges::Release(std::size_t last)
+{
+    NS_ASSERT(last >= m_begin && last < m_times.size());
+    if (last == m_begin)
+    {
+        return;
+    }
+    m_times[last] = m_times[m_begin];
+    m_powers[last] = m_powers[m_begin];
+    m_events[last] = m_events[m_begin];
+    for (std::size_t i = m_begin; i < last; ++i)
+    {
+        m_events[i] = nullptr;
+    }
+    m_begin = last;
+    if (m_begin >= m_times.size() / 2)
+    {
+        m_times.erase(m_times.begin(), m_times.begin() + m_begin);
+        m_powers.erase(m_powers.begin(), m_powers.begin() + m_begin);
+        m_events.erase(m_events.begin(), m_events.begin() + m_begin);
+        m_begin = 0;
+    }
+}
+
+void
+InterferenceHelper::FlatNiChanges::Clear()
+{
+    m_times.clear();
+    m_powers.clear();
+    m_events.clear();
+    m_begin = 0;
+}
+
 /****************************************************************
  *       The actual InterferenceHelper
  ****************************************************************/
@@ -185,6 +294,7 @@ InterferenceHelper::NiChange::GetEvent() const
 InterferenceHelper::InterferenceHelper()
     : m_errorRateModel(nullptr),
       m_numRxAntennas(1),
+      m_flat(true),
       m_rxing(false)
 {
     NS_LOG_FUNCTION(this);
@@ -198,13 +308,31 @@ InterferenceHelper::~InterferenceHelper()
 TypeId
 InterferenceHelper::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::InterferenceHelper")
-                            .SetParent<ns3::Object>()
-                            .SetGroupName("Wifi")
-                            .AddConstructor<InterferenceHelper>();
+    static TypeId tid =
+        TypeId("ns3::InterferenceHelper")
+            .SetParent<ns3::Object>()
+            .SetGroupName("Wifi")
+            .AddConstructor<InterferenceHelper>()
+            .AddAttribute("FlatNiChanges",
+                          "Whether to store the noise and interference changes of each band "
+                          "in flat arrays sorted by time, which are searched by bisection, "
+                          "rather than in multimaps. Both give the same results. This "
+                          "attribute cannot be changed once bands are added.",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&InterferenceHelper::SetFlatNiChanges),
+                          MakeBooleanChecker());
     return tid;
 }
 
+void
+InterferenceHelper::SetFlatNiChanges(bool enable)
+{
+    NS_LOG_FUNCTION(this << enable);
+    NS_ABORT_MSG_IF(!m_niChanges.empty() || !m_flatNiChanges.empty(),
+                    "Cannot change the storage of the NI changes once bands are added");
+    m_flat = enable;
+}
+
 void
 InterferenceHelper::DoDispose()
 {
@@ -218,6 +346,7 @@ InterferenceHelper::DoDispose()
         niChangesPerBand.clear();
     }
     m_niChanges.clear();
+    m_flatNiChanges.clear();
     for (auto it : m_firstPowers)
     {
         it.second.clear();
@@ -259,8 +388,16 @@ void
 InterferenceHelper::RemoveBands(FrequencyRange range)
 {
     NS_LOG_FUNCTION(this << range);
-    if ((m_niChanges.count(range) == 0) && (m_firstPowers.count(range) == 0))
+    if ((m_niChanges.count(range) == 0) && (m_flatNiChanges.count(range) == 0) &&
+        (m_firstPowers.count(range) == 0))
+    {
+        return;
+    }
+    if (m_flat)
     {
+        m_flatNiChanges.erase(range);
+        m_firstPowers.at(range).clear();
+        m_firstPowers.erase(range);
         return;
     }
     auto niChangesPerBand = m_niChanges.at(range);
@@ -278,6 +415,10 @@ bool
 InterferenceHelper::HasBand(WifiSpectrumBand band, const FrequencyRange& range) const
 {
     NS_LOG_FUNCTION(this << band.first << band.second << range);
+    if (m_flat)
+    {
+        return (m_flatNiChanges.count(range) > 0 && m_flatNiChanges.at(range).count(band) > 0);
+    }
     return (m_niChanges.count(range) > 0 && m_niChanges.at(range).count(band) > 0);
 }
 
@@ -287,6 +428,15 @@ InterferenceHelper::AddBand(WifiSpectrumBand band, const FrequencyRange& range)
     NS_LOG_FUNCTION(this << band.first << band.second << range);
     NS_ASSERT(m_niChanges.count(range) == 0 || m_niChanges.at(range).count(band) == 0);
     NS_ASSERT(m_firstPowers.count(range) == 0 || m_firstPowers.at(range).count(band) == 0);
+    if (m_flat)
+    {
+        auto result = m_flatNiChanges[range].insert({band, FlatNiChanges()});
+        NS_ASSERT(result.second);
+        // Always have a zero power noise event in the list
+        result.first->second.Insert(Time(0), 0.0, nullptr);
+        m_firstPowers[range].insert({band, 0.0});
+        return;
+    }
     NiChanges niChanges;
     auto result = m_niChanges[range].insert({band, niChanges});
     NS_ASSERT(result.second);
@@ -326,6 +476,24 @@ InterferenceHelper::GetEnergyDuration(double energyW,
 {
     NS_LOG_FUNCTION(this << energyW << band.first << band.second << range);
     Time now = Simulator::Now();
+    if (m_flat)
+    {
+        NS_ABORT_IF(m_flatNiChanges.count(range) == 0);
+        auto niIt = m_flatNiChanges.at(range).find(band);
+        NS_ABORT_IF(niIt == m_flatNiChanges.at(range).end());
+        const auto& ni = niIt->second;
+        auto i = ni.UpperBound(now) - 1;
+        Time end = ni.GetTime(i);
+        for (; i != ni.End(); ++i)
+        {
+            end = ni.GetTime(i);
+            if (ni.GetPower(i) < energyW)
+            {
+                break;
+            }
+        }
+        return end > now ? end - now : MicroSeconds(0);
+    }
     NS_ABORT_IF(m_niChanges.count(range) == 0);
     auto niIt = m_niChanges.at(range).find(band);
     NS_ABORT_IF(niIt == m_niChanges.at(range).end());
@@ -349,6 +517,35 @@ InterferenceHelper::AppendEvent(Ptr<Event> event,
                                 bool isStartOfdmaRxing)
 {
     NS_LOG_FUNCTION(this << event << range << isStartOfdmaRxing);
+    if (m_flat)
+    {
+        NS_ABORT_IF(m_flatNiChanges.count(range) == 0);
+        NS_ABORT_IF(m_firstPowers.count(range) == 0);
+        for (const auto& it : event->GetRxPowerWPerBand())
+        {
+            WifiSpectrumBand band = it.first;
+            auto niIt = m_flatNiChanges.at(range).find(band);
+            NS_ABORT_IF(niIt == m_flatNiChanges.at(range).end());
+            auto& ni = niIt->second;
+            auto previousPowerPosition = ni.UpperBound(event->GetStartTime()) - 1;
+            double previousPowerStart = ni.GetPower(previousPowerPosition);
+            double previousPowerEnd = ni.GetPower(ni.UpperBound(event->GetEndTime()) - 1);
+            if (!m_rxing)
+            {
+                m_firstPowers.at(range).find(band)->second = previousPowerStart;
+                // Always leave the first zero power noise event in the list
+                ni.Release(previousPowerPosition);
+            }
+            else if (isStartOfdmaRxing)
+            {
+                m_firstPowers.at(range).find(band)->second = previousPowerStart;
+            }
+            auto first = ni.Insert(event->GetStartTime(), previousPowerStart, event);
+            auto last = ni.Insert(event->GetEndTime(), previousPowerEnd, event);
+            ni.AddPower(first, last, it.second);
+        }
+        return;
+    }
     NS_ABORT_IF(m_niChanges.count(range) == 0);
     NS_ABORT_IF(m_firstPowers.count(range) == 0);
     for (const auto& it : event->GetRxPowerWPerBand())
@@ -390,8 +587,23 @@ InterferenceHelper::UpdateEvent(Ptr<Event> event,
                                 const FrequencyRange& range)
 {
     NS_LOG_FUNCTION(this << event << range);
-    NS_ABORT_IF(m_niChanges.count(range) == 0);
     // This is called for UL MU events, in order to scale power as long as UL MU PPDUs arrive
+    if (m_flat)
+    {
+        NS_ABORT_IF(m_flatNiChanges.count(range) == 0);
+        for (const auto& it : rxPower)
+        {
+            auto niIt = m_flatNiChanges.at(range).find(it.first);
+            NS_ABORT_IF(niIt == m_flatNiChanges.at(range).end());
+            auto& ni = niIt->second;
+            auto first = ni.UpperBound(event->GetStartTime()) - 1;
+            auto last = ni.UpperBound(event->GetEndTime()) - 1;
+            ni.AddPower(first, last, it.second);
+        }
+        event->UpdateRxPowerW(rxPower);
+        return;
+    }
+    NS_ABORT_IF(m_niChanges.count(range) == 0);
     for (const auto& it : rxPower)
     {
         WifiSpectrumBand band = it.first;
@@ -441,37 +653,64 @@ InterferenceHelper::CalculateSnr(double signal,
 
 double
 InterferenceHelper::CalculateNoiseInterferenceW(Ptr<Event> event,
-                                                NiChangesPerBand* nis,
                                                 WifiSpectrumBand band,
-                                                const FrequencyRange& range) const
+                                                const FrequencyRange& range,
+                                                EventNiChanges* ni,
+                                                FlatNiChanges* copy) const
 {
     NS_LOG_FUNCTION(this << band.first << band.second << range);
     NS_ABORT_IF(m_firstPowers.count(range) == 0);
     auto firstPower_it = m_firstPowers.at(range).find(band);
     NS_ABORT_IF(firstPower_it == m_firstPowers.at(range).end());
     double noiseInterferenceW = firstPower_it->second;
-    NS_ABORT_IF(m_niChanges.count(range) == 0);
-    auto niIt = m_niChanges.at(range).find(band);
-    NS_ABORT_IF(niIt == m_niChanges.at(range).end());
-    auto it = niIt->second.find(event->GetStartTime());
-    for (; it != niIt->second.end() && it->first < Simulator::Now(); ++it)
-    {
-        noiseInterferenceW = it->second.GetPower() - event->GetRxPowerW(band);
-    }
-    it = niIt->second.find(event->GetStartTime());
-    NS_ABORT_IF(it == niIt->second.end());
-    for (; it != niIt->second.end() && it->second.GetEvent() != event; ++it)
+    if (m_flat)
     {
-        ;
+        NS_ABORT_IF(m_flatNiChanges.count(range) == 0);
+        auto niIt = m_flatNiChanges.at(range).find(band);
+        NS_ABORT_IF(niIt == m_flatNiChanges.at(range).end());
+        const auto& changes = niIt->second;
+        auto start = changes.LowerBound(event->GetStartTime());
+        NS_ABORT_IF(start == changes.End() || changes.GetTime(start) != event->GetStartTime());
+        // the last change before now, if it is not before the start of the event
+        auto now = changes.LowerBound(Simulator::Now());
+        if (now > start)
+        {
+            noiseInterferenceW = changes.GetPower(now - 1) - event->GetRxPowerW(band);
+        }
+        ni->changes = &changes;
+        ni->first = changes.Find(event, start);
+        NS_ABORT_IF(ni->first == changes.End());
+        ni->last = changes.Find(event,
+                                std::max(ni->first + 1, changes.LowerBound(event->GetEndTime())));
+        NS_ABORT_IF(ni->last == changes.End());
     }
-    NiChanges ni;
-    ni.emplace(event->GetStartTime(), NiChange(0, event));
-    while (++it != niIt->second.end() && it->second.GetEvent() != event)
+    else
     {
-        ni.insert(*it);
+        NS_ABORT_IF(m_niChanges.count(range) == 0);
+        auto niIt = m_niChanges.at(range).find(band);
+        NS_ABORT_IF(niIt == m_niChanges.at(range).end());
+        auto it = niIt->second.find(event->GetStartTime());
+        for (; it != niIt->second.end() && it->first < Simulator::Now(); ++it)
+        {
+            noiseInterferenceW = it->second.GetPower() - event->GetRxPowerW(band);
+        }
+        it = niIt->second.find(event->GetStartTime());
+        NS_ABORT_IF(it == niIt->second.end());
+        for (; it != niIt->second.end() && it->second.GetEvent() != event; ++it)
+        {
+            ;
+        }
+        copy->Clear();
+        copy->Insert(event->GetStartTime(), 0, event);
+        while (++it != niIt->second.end() && it->second.GetEvent() != event)
+        {
+            copy->Insert(it->first, it->second.GetPower(), it->second.GetEvent());
+        }
+        copy->Insert(event->GetEndTime(), 0, event);
+        ni->changes = copy;
+        ni->first = copy->Begin();
+        ni->last = copy->End() - 1;
     }
-    ni.emplace(event->GetEndTime(), NiChange(0, event));
-    nis->insert({band, ni});
     NS_ASSERT_MSG(noiseInterferenceW >= 0,
                   "CalculateNoiseInterferenceW returns negative value " << noiseInterferenceW);
     return noiseInterferenceW;
@@ -523,7 +762,7 @@ InterferenceHelper::CalculatePayloadChunkSuccessRate(double snir,
 double
 InterferenceHelper::CalculatePayloadPer(Ptr<const Event> event,
                                         uint16_t channelWidth,
-                                        NiChangesPerBand* nis,
+                                        const EventNiChanges& ni,
                                         WifiSpectrumBand band,
                                         const FrequencyRange& range,
                                         uint16_t staId,
@@ -532,17 +771,16 @@ InterferenceHelper::CalculatePayloadPer(Ptr<const Event> event,
     NS_LOG_FUNCTION(this << channelWidth << band.first << band.second << staId << window.first
                          << window.second);
     double psr = 1.0; /* Packet Success Rate */
-    const auto& niIt = nis->find(band)->second;
-    auto j = niIt.cbegin();
-    Time previous = j->first;
+    const auto& changes = *ni.changes;
+    auto j = ni.first;
     WifiMode payloadMode = event->GetTxVector().GetMode(staId);
-    Time phyPayloadStart = j->first;
+    Time phyPayloadStart = changes.GetTime(j);
     if (event->GetPpdu()->GetType() != WIFI_PPDU_TYPE_UL_MU &&
         event->GetPpdu()->GetType() !=
-            WIFI_PPDU_TYPE_DL_MU) // j->first corresponds to the start of the OFDMA payload
+            WIFI_PPDU_TYPE_DL_MU) // j corresponds to the start of the OFDMA payload
     {
-        phyPayloadStart =
-            j->first + WifiPhy::CalculatePhyPreambleAndHeaderDuration(event->GetTxVector());
+        phyPayloadStart = changes.GetTime(j) +
+                          WifiPhy::CalculatePhyPreambleAndHeaderDuration(event->GetTxVector());
     }
     Time windowStart = phyPayloadStart + window.first;
     Time windowEnd = phyPayloadStart + window.second;
@@ -550,9 +788,18 @@ InterferenceHelper::CalculatePayloadPer(Ptr<const Event> event,
     NS_ABORT_IF(m_firstPowers.at(range).count(band) == 0);
     double noiseInterferenceW = m_firstPowers.at(range).at(band);
     double powerW = event->GetRxPowerW(band);
-    while (++j != niIt.cend())
+    // the chunks ending before the windowed payload do not contribute to the PER, hence
+    // skip to the chunk preceding the first change at or after the start of the window
+    auto windowFirst = std::min(changes.LowerBound(windowStart), ni.last);
+    if (windowFirst > j + 1)
+    {
+        j = windowFirst - 1;
+        noiseInterferenceW = changes.GetPower(j) - powerW;
+    }
+    Time previous = changes.GetTime(j);
+    while (++j <= ni.last)
     {
-        Time current = j->first;
+        Time current = changes.GetTime(j);
         NS_LOG_DEBUG("previous= " << previous << ", current=" << current);
         NS_ASSERT(current >= previous);
         double snr = CalculateSnr(powerW,
@@ -580,8 +827,8 @@ InterferenceHelper::CalculatePayloadPer(Ptr<const Event> event,
                 "previous is before windowed payload and current is in the windowed payload: mode="
                 << payloadMode << ", psr=" << psr);
         }
-        noiseInterferenceW = j->second.GetPower() - powerW;
-        previous = j->first;
+        noiseInterferenceW = changes.GetPower(j) - powerW;
+        previous = current;
         if (previous > windowEnd)
         {
             NS_LOG_DEBUG("Stop: new previous=" << previous
@@ -596,7 +843,7 @@ InterferenceHelper::CalculatePayloadPer(Ptr<const Event> event,
 double
 InterferenceHelper::CalculatePhyHeaderSectionPsr(
     Ptr<const Event> event,
-    NiChangesPerBand* nis,
+    const EventNiChanges& ni,
     uint16_t channelWidth,
     WifiSpectrumBand band,
     const FrequencyRange& range,
@@ -604,8 +851,8 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr(
 {
     NS_LOG_FUNCTION(this << band.first << band.second << range);
     double psr = 1.0; /* Packet Success Rate */
-    auto niIt = nis->find(band)->second;
-    auto j = niIt.begin();
+    const auto& changes = *ni.changes;
+    auto j = ni.first;
 
     NS_ASSERT(!phyHeaderSections.empty());
     Time stopLastSection = Seconds(0);
@@ -614,14 +861,14 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr(
         stopLastSection = Max(stopLastSection, section.second.first.second);
     }
 
-    Time previous = j->first;
+    Time previous = changes.GetTime(j);
     NS_ABORT_IF(m_firstPowers.count(range) == 0);
     NS_ABORT_IF(m_firstPowers.at(range).count(band) == 0);
     double noiseInterferenceW = m_firstPowers.at(range).at(band);
     double powerW = event->GetRxPowerW(band);
-    while (++j != niIt.end())
+    while (++j <= ni.last)
     {
-        Time current = j->first;
+        Time current = changes.GetTime(j);
         NS_LOG_DEBUG("previous= " << previous << ", current=" << current);
         NS_ASSERT(current >= previous);
         double snr = CalculateSnr(powerW, noiseInterferenceW, channelWidth, 1);
@@ -647,8 +894,8 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr(
                 }
             }
         }
-        noiseInterferenceW = j->second.GetPower() - powerW;
-        previous = j->first;
+        noiseInterferenceW = changes.GetPower(j) - powerW;
+        previous = current;
         if (previous > stopLastSection)
         {
             NS_LOG_DEBUG("Stop: new previous=" << previous << " after stop of last section="
@@ -661,19 +908,18 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr(
 
 double
 InterferenceHelper::CalculatePhyHeaderPer(Ptr<const Event> event,
-                                          NiChangesPerBand* nis,
+                                          const EventNiChanges& ni,
                                           uint16_t channelWidth,
                                           WifiSpectrumBand band,
                                           const FrequencyRange& range,
                                           WifiPpduField header) const
 {
     NS_LOG_FUNCTION(this << band.first << band.second << range << header);
-    auto niIt = nis->find(band)->second;
     auto phyEntity = WifiPhy::GetStaticPhyEntity(event->GetTxVector().GetModulationClass());
 
     PhyEntity::PhyHeaderSections sections;
     for (const auto& section :
-         phyEntity->GetPhyHeaderSections(event->GetTxVector(), niIt.begin()->first))
+         phyEntity->GetPhyHeaderSections(event->GetTxVector(), ni.changes->GetTime(ni.first)))
     {
         if (section.first == header)
         {
@@ -684,7 +930,7 @@ InterferenceHelper::CalculatePhyHeaderPer(Ptr<const Event> event,
     double psr = 1.0;
     if (!sections.empty())
     {
-        psr = CalculatePhyHeaderSectionPsr(event, nis, channelWidth, band, range, sections);
+        psr = CalculatePhyHeaderSectionPsr(event, ni, channelWidth, band, range, sections);
     }
     return 1 - psr;
 }
@@ -699,8 +945,9 @@ InterferenceHelper::CalculatePayloadSnrPer(Ptr<Event> event,
 {
     NS_LOG_FUNCTION(this << channelWidth << band.first << band.second << range << staId
                          << relativeMpduStartStop.first << relativeMpduStartStop.second);
-    NiChangesPerBand ni;
-    double noiseInterferenceW = CalculateNoiseInterferenceW(event, &ni, band, range);
+    EventNiChanges ni;
+    FlatNiChanges copy;
+    double noiseInterferenceW = CalculateNoiseInterferenceW(event, band, range, &ni, &copy);
     double snr = CalculateSnr(event->GetRxPowerW(band),
                               noiseInterferenceW,
                               channelWidth,
@@ -710,7 +957,7 @@ InterferenceHelper::CalculatePayloadSnrPer(Ptr<Event> event,
      * all SNIR changes in the SNIR vector.
      */
     double per =
-        CalculatePayloadPer(event, channelWidth, &ni, band, range, staId, relativeMpduStartStop);
+        CalculatePayloadPer(event, channelWidth, ni, band, range, staId, relativeMpduStartStop);
 
     return PhyEntity::SnrPer(snr, per);
 }
@@ -722,8 +969,9 @@ InterferenceHelper::CalculateSnr(Ptr<Event> event,
                                  WifiSpectrumBand band,
                                  const FrequencyRange& range) const
 {
-    NiChangesPerBand ni;
-    double noiseInterferenceW = CalculateNoiseInterferenceW(event, &ni, band, range);
+    EventNiChanges ni;
+    FlatNiChanges copy;
+    double noiseInterferenceW = CalculateNoiseInterferenceW(event, band, range, &ni, &copy);
     double snr = CalculateSnr(event->GetRxPowerW(band), noiseInterferenceW, channelWidth, nss);
     return snr;
 }
@@ -736,14 +984,15 @@ InterferenceHelper::CalculatePhyHeaderSnrPer(Ptr<Event> event,
                                              WifiPpduField header) const
 {
     NS_LOG_FUNCTION(this << band.first << band.second << header);
-    NiChangesPerBand ni;
-    double noiseInterferenceW = CalculateNoiseInterferenceW(event, &ni, band, range);
+    EventNiChanges ni;
+    FlatNiChanges copy;
+    double noiseInterferenceW = CalculateNoiseInterferenceW(event, band, range, &ni, &copy);
     double snr = CalculateSnr(event->GetRxPowerW(band), noiseInterferenceW, channelWidth, 1);
 
     /* calculate the SNIR at the start of the PHY header and accumulate
      * all SNIR changes in the SNIR vector.
      */
-    double per = CalculatePhyHeaderPer(event, &ni, channelWidth, band, range, header);
+    double per = CalculatePhyHeaderPer(event, ni, channelWidth, band, range, header);
 
     return PhyEntity::SnrPer(snr, per);
 }
@@ -752,8 +1001,21 @@ void
 InterferenceHelper::EraseEvents(const FrequencyRange& range)
 {
     NS_LOG_FUNCTION(this << range);
-    NS_ABORT_IF(m_niChanges.count(range) == 0);
     NS_ABORT_IF(m_firstPowers.count(range) == 0);
+    if (m_flat)
+    {
+        NS_ABORT_IF(m_flatNiChanges.count(range) == 0);
+        for (auto& [band, ni] : m_flatNiChanges.at(range))
+        {
+            ni.Clear();
+            // Always have a zero power noise event in the list
+            ni.Insert(Time(0), 0.0, nullptr);
+            m_firstPowers.at(range).at(band) = 0.0;
+        }
+        m_rxing = false;
+        return;
+    }
+    NS_ABORT_IF(m_niChanges.count(range) == 0);
     for (auto niIt = m_niChanges.at(range).begin(); niIt != m_niChanges.at(range).end(); ++niIt)
     {
         niIt->second.clear();
@@ -797,10 +1059,21 @@ void
 InterferenceHelper::NotifyRxEnd(Time endTime, const FrequencyRange& range)
 {
     NS_LOG_FUNCTION(this << endTime << range);
-    NS_ABORT_IF(m_niChanges.count(range) == 0);
     NS_ABORT_IF(m_firstPowers.count(range) == 0);
     m_rxing = false;
     // Update m_firstPowers for frame capture
+    if (m_flat)
+    {
+        NS_ABORT_IF(m_flatNiChanges.count(range) == 0);
+        for (const auto& [band, ni] : m_flatNiChanges.at(range))
+        {
+            NS_ASSERT(ni.End() - ni.Begin() > 1);
+            auto i = ni.UpperBound(endTime) - 1;
+            m_firstPowers.at(range).find(band)->second = ni.GetPower(i - 1);
+        }
+        return;
+    }
+    NS_ABORT_IF(m_niChanges.count(range) == 0);
     for (auto niIt = m_niChanges.at(range).begin(); niIt != m_niChanges.at(range).end(); ++niIt)
     {
         NS_ASSERT(niIt->second.size() > 1);
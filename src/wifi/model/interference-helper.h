@@ -417,6 +417,103 @@ class InterferenceHelper : public Object
      */
     using NiChanges = std::multimap<Time, NiChange>;
 
+    /**
+     * The NI changes of a band sorted by time, stored in flat arrays.
+     *
+     * As in NiChanges, each change holds the total noise and interference
+     * power from its time on, i.e., the prefix sum of the power variations,
+     * hence the power at a given time is found by a binary search. The changes
+     * preceding the current reception are released from the front of the
+     * arrays in constant time, and their storage is reclaimed once they make
+     * up half of the arrays.
+     */
+    class FlatNiChanges
+    {
+      public:
+        FlatNiChanges();
+
+        /**
+         * \return the index of the first change
+         */
+        std::size_t Begin() const;
+        /**
+         * \return the index past the last change
+         */
+        std::size_t End() const;
+        /**
+         * \param moment the time
+         * \return the index of the first change at or after the given time
+         */
+        std::size_t LowerBound(Time moment) const;
+        /**
+         * \param moment the time
+         * \return the index of the first change after the given time
+         */
+        std::size_t UpperBound(Time moment) const;
+        /**
+         * \param event the event
+         * \param from the index to start from
+         * \return the index of the first change caused by the event at or after the given
+         *         index, or End() if there is none
+         */
+        std::size_t Find(Ptr<const Event> event, std::size_t from) const;
+        /**
+         * \param i the index of a change
+         * \return the time of the change
+         */
+        Time GetTime(std::size_t i) const;
+        /**
+         * \param i the index of a change
+         * \return the power in watts from the change on
+         */
+        double GetPower(std::size_t i) const;
+
+        /**
+         * Insert a change after the changes at the same time.
+         *
+         * \param moment the time of the change
+         * \param power the power in watts from the change on
+         * \param event the event causing the change
+         * \return the index of the change
+         */
+        std::size_t Insert(Time moment, double power, Ptr<Event> event);
+        /**
+         * Add a given amount of power to a range of changes.
+         *
+         * \param first the index of the first change
+         * \param last the index past the last change
+         * \param power the power to be added in watts
+         */
+        void AddPower(std::size_t first, std::size_t last, double power);
+        /**
+         * Release the changes following the first one, up to a given change included.
+         * The first change is kept, in place of the given change.
+         *
+         * \param last the index of the last change to release
+         */
+        void Release(std::size_t last);
+        /**
+         * Remove all the changes.
+         */
+        void Clear();
+
+      private:
+        std::vector<Time> m_times;        //!< the time of the changes
+        std::vector<double> m_powers;     //!< the power from the changes on, in watts
+        std::vector<Ptr<Event>> m_events; //!< the event causing the changes
+        std::size_t m_begin;              //!< the index of the first change
+    };
+
+    /**
+     * The NI changes during an event, from the change at its start to the change at its end.
+     */
+    struct EventNiChanges
+    {
+        const FlatNiChanges* changes; //!< the changes
+        std::size_t first;            //!< the index of the change at the start of the event
+        std::size_t last;             //!< the index of the change at the end of the event
+    };
+
     /**
      * Map of NiChanges per band
      */
@@ -427,6 +524,12 @@ class InterferenceHelper : public Object
      */
     using NiChangesPerBandPerRange = std::map<FrequencyRange, NiChangesPerBand>;
 
+    /**
+     * Map of FlatNiChanges per band and per range
+     */
+    using FlatNiChangesPerBandPerRange =
+        std::map<FrequencyRange, std::map<WifiSpectrumBand, FlatNiChanges>>;
+
     /**
      * Map of first power per band
      */
@@ -451,16 +554,18 @@ class InterferenceHelper : public Object
      * Calculate noise and interference power in W.
      *
      * \param event the event
-     * \param nis the NiChanges
      * \param band the band
      * \param range the frequency range
+     * \param ni the NI changes during the event
+     * \param copy the storage of the NI changes during the event, if they are copied
      *
      * \return noise and interference power
      */
     double CalculateNoiseInterferenceW(Ptr<Event> event,
-                                       NiChangesPerBand* nis,
                                        WifiSpectrumBand band,
-                                       const FrequencyRange& range) const;
+                                       const FrequencyRange& range,
+                                       EventNiChanges* ni,
+                                       FlatNiChanges* copy) const;
     /**
      * Calculate the error rate of the given PHY payload only in the provided time
      * window (thus enabling per MPDU PER information). The PHY payload can be divided into
@@ -468,7 +573,7 @@ class InterferenceHelper : public Object
      *
      * \param event the event
      * \param channelWidth the channel width used to transmit the PSDU (in MHz)
-     * \param nis the NiChanges
+     * \param ni the NI changes during the event
      * \param band identify the band used by the PSDU
      * \param range the frequency range the band belongs to
      * \param staId the station ID of the PSDU (only used for MU)
@@ -478,7 +583,7 @@ class InterferenceHelper : public Object
      */
     double CalculatePayloadPer(Ptr<const Event> event,
                                uint16_t channelWidth,
-                               NiChangesPerBand* nis,
+                               const EventNiChanges& ni,
                                WifiSpectrumBand band,
                                const FrequencyRange& range,
                                uint16_t staId,
@@ -488,7 +593,7 @@ class InterferenceHelper : public Object
      * can be divided into multiple chunks (e.g. due to interference from other transmissions).
      *
      * \param event the event
-     * \param nis the NiChanges
+     * \param ni the NI changes during the event
      * \param channelWidth the channel width (in MHz) for header measurement
      * \param band the band
      * \param range the frequency range
@@ -497,7 +602,7 @@ class InterferenceHelper : public Object
      * \return the error rate of the HT PHY header
      */
     double CalculatePhyHeaderPer(Ptr<const Event> event,
-                                 NiChangesPerBand* nis,
+                                 const EventNiChanges& ni,
                                  uint16_t channelWidth,
                                  WifiSpectrumBand band,
                                  const FrequencyRange& range,
@@ -506,7 +611,7 @@ class InterferenceHelper : public Object
      * Calculate the success rate of the PHY header sections for the provided event.
      *
      * \param event the event
-     * \param nis the NiChanges
+     * \param ni the NI changes during the event
      * \param channelWidth the channel width (in MHz) for header measurement
      * \param band the band
      * \param range the frequency range
@@ -515,7 +620,7 @@ class InterferenceHelper : public Object
      * \return the success rate of the PHY header sections
      */
     double CalculatePhyHeaderSectionPsr(Ptr<const Event> event,
-                                        NiChangesPerBand* nis,
+                                        const EventNiChanges& ni,
                                         uint16_t channelWidth,
                                         WifiSpectrumBand band,
                                         const FrequencyRange& range,
@@ -524,9 +629,18 @@ class InterferenceHelper : public Object
     double m_noiseFigure;                 //!< noise figure (linear)
     Ptr<ErrorRateModel> m_errorRateModel; //!< error rate model
     uint8_t m_numRxAntennas; //!< the number of RX antennas in the corresponding receiver
-    NiChangesPerBandPerRange m_niChanges;    //!< NI Changes for each band in each range
-    FirstPowerPerBandPerRange m_firstPowers; //!< first power of each band in watts
-    bool m_rxing;                            //!< flag whether it is in receiving state
+    bool m_flat;                                  //!< whether NI changes are in flat arrays
+    NiChangesPerBandPerRange m_niChanges;         //!< NI Changes for each band in each range
+    FlatNiChangesPerBandPerRange m_flatNiChanges; //!< flat NI Changes for each band in each range
+    FirstPowerPerBandPerRange m_firstPowers;      //!< first power of each band in watts
+    bool m_rxing;                                 //!< flag whether it is in receiving state
+
+    /**
+     * Set whether the NI changes are stored in flat arrays.
+     *
+     * \param enable true to store the NI changes in flat arrays, false to store them in multimaps
+     */
+    void SetFlatNiChanges(bool enable);
 
     /**
      * Returns an iterator to the first NiChange that is later than moment
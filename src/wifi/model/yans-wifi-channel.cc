@@ -24,7 +24,10 @@
 #include "wifi-utils.h"
 #include "yans-wifi-phy.h"
 
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/log.h"
+#include "ns3/mobility-grid-index.h"
 #include "ns3/mobility-model.h"
 #include "ns3/node.h"
 #include "ns3/pointer.h"
@@ -33,6 +36,10 @@
 #include "ns3/simulator.h"
 #include "ns3/wifi-net-device.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace ns3
 {
 
@@ -57,11 +64,31 @@ YansWifiChannel::GetTypeId()
                           "A pointer to the propagation delay model attached to this channel.",
                           PointerValue(),
                           MakePointerAccessor(&YansWifiChannel::m_delay),
-                          MakePointerChecker<PropagationDelayModel>());
+                          MakePointerChecker<PropagationDelayModel>())
+            .AddAttribute("MaxRange",
+                          "The maximum distance (m) between the sender and the receiving "
+                          "PHYs. Signals are not propagated to the PHYs beyond this "
+                          "distance, not even as interference. The PHYs in range are "
+                          "found with a spatial index following the course changes of "
+                          "their mobility models.",
+                          DoubleValue(std::numeric_limits<double>::infinity()),
+                          MakeDoubleAccessor(&YansWifiChannel::m_maxRange),
+                          MakeDoubleChecker<double>(0, std::numeric_limits<double>::infinity()))
+            .AddAttribute("BatchReceptions",
+                          "If true, the receptions of a PPDU which start at the same time, "
+                          "i.e., with the same propagation delay, are started by a single "
+                          "event rather than one event per receiver, in the same order. The "
+                          "receptions of a batch run in the context of the node of its "
+                          "first receiver, hence this is not suitable for the parallel "
+                          "simulator implementations.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&YansWifiChannel::m_batchReceptions),
+                          MakeBooleanChecker());
     return tid;
 }
 
 YansWifiChannel::YansWifiChannel()
+    : m_batchReceptions(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -70,6 +97,8 @@ YansWifiChannel::~YansWifiChannel()
 {
     NS_LOG_FUNCTION(this);
     m_phyList.clear();
+    m_rxIndex = nullptr;
+    m_rxPhysInRange.clear();
 }
 
 void
@@ -92,7 +121,29 @@ YansWifiChannel::Send(Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double
     NS_LOG_FUNCTION(this << sender << ppdu << txPowerDbm);
     Ptr<MobilityModel> senderMobility = sender->GetMobility();
     NS_ASSERT(senderMobility);
-    for (PhyList::const_iterator i = m_phyList.begin(); i != m_phyList.end(); i++)
+
+    // PHYs beyond range are skipped altogether
+    const PhyList* rxPhys = &m_phyList;
+    if (!std::isinf(m_maxRange))
+    {
+        if (!m_rxIndex)
+        {
+            m_rxIndex = Create<MobilityGridIndex>(std::max(m_maxRange, 1.0));
+            for (uint32_t id = 0; id < m_phyList.size(); ++id)
+            {
+                m_rxIndex->Add(id, m_phyList[id]->GetMobility());
+            }
+        }
+        m_rxIndex->GetNeighbors(senderMobility->GetPosition(), m_maxRange, m_rxIds);
+        m_rxPhysInRange.clear();
+        for (uint32_t id : m_rxIds)
+        {
+            m_rxPhysInRange.push_back(m_phyList[id]);
+        }
+        rxPhys = &m_rxPhysInRange;
+    }
+
+    for (PhyList::const_iterator i = rxPhys->begin(); i != rxPhys->end(); i++)
     {
         if (sender != (*i))
         {
@@ -109,18 +160,12 @@ YansWifiChannel::Send(Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double
                          << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, "
                          << "distance=" << senderMobility->GetDistanceFrom(receiverMobility)
                          << "m, delay=" << delay);
-            Ptr<NetDevice> dstNetDevice = (*i)->GetDevice();
-            uint32_t dstNode;
-            if (!dstNetDevice)
-            {
-                dstNode = 0xffffffff;
-            }
-            else
+            if (m_batchReceptions)
             {
-                dstNode = dstNetDevice->GetNode()->GetId();
+                m_rxBatches.emplace_back(delay, Rx(*i, rxPowerDbm));
+                continue;
             }
-
-            Simulator::ScheduleWithContext(dstNode,
+            Simulator::ScheduleWithContext(GetContext(*i),
                                            delay,
                                            &YansWifiChannel::Receive,
                                            (*i),
@@ -128,6 +173,68 @@ YansWifiChannel::Send(Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double
                                            rxPowerDbm);
         }
     }
+
+    if (m_rxBatches.empty())
+    {
+        return;
+    }
+    std::stable_sort(m_rxBatches.begin(), m_rxBatches.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    for (auto first = m_rxBatches.begin(); first != m_rxBatches.end();)
+    {
+        Time delay = first->first;
+        auto last = std::find_if(first, m_rxBatches.end(), [delay](const auto& rx) {
+            return rx.first != delay;
+        });
+        if (last - first == 1)
+        {
+            Simulator::ScheduleWithContext(GetContext(first->second.first),
+                                           delay,
+                                           &YansWifiChannel::Receive,
+                                           first->second.first,
+                                           ppdu,
+                                           first->second.second);
+            first = last;
+            continue;
+        }
+        std::vector<Rx> batch;
+        batch.reserve(last - first);
+        for (auto it = first; it != last; ++it)
+        {
+            batch.push_back(std::move(it->second));
+        }
+        NS_LOG_LOGIC("batch of " << batch.size() << " receptions in " << delay);
+        // the receptions run in the context of the node of the first receiver
+        Simulator::ScheduleWithContext(GetContext(batch.front().first),
+                                       delay,
+                                       &YansWifiChannel::ReceiveBatch,
+                                       std::move(batch),
+                                       ppdu);
+        first = last;
+    }
+    m_rxBatches.clear();
+}
+
+uint32_t
+YansWifiChannel::GetContext(Ptr<YansWifiPhy> phy)
+{
+    Ptr<NetDevice> dstNetDevice = phy->GetDevice();
+    if (!dstNetDevice)
+    {
+        return 0xffffffff;
+    }
+    return dstNetDevice->GetNode()->GetId();
+}
+
+void
+YansWifiChannel::ReceiveBatch(const std::vector<Rx>& batch, Ptr<const WifiPpdu> ppdu)
+{
+    NS_LOG_FUNCTION(batch.size() << ppdu);
+    for (const auto& [phy, rxPowerDbm] : batch)
+    {
+        Receive(phy, ppdu, rxPowerDbm);
+    }
 }
 
 void
@@ -166,6 +273,7 @@ YansWifiChannel::Add(Ptr<YansWifiPhy> phy)
 {
     NS_LOG_FUNCTION(this << phy);
     m_phyList.push_back(phy);
+    m_rxIndex = nullptr;
 }
 
 int64_t
@@ -21,16 +21,20 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include "ns3/channel.h"
+#include "ns3/nstime.h"
+
+#include <utility>
+#include <vector>
 
 namespace ns3
 {
 
+class MobilityGridIndex;
 class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
 class YansWifiPhy;
 class Packet;
-class Time;
 class WifiPpdu;
 
 /**
@@ -41,6 +45,10 @@ class WifiPpdu;
  * class and supports an ns3::PropagationLossModel and an
  * ns3::PropagationDelayModel.  By default, no propagation models are set;
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * If the MaxRange attribute is set, the PHYs beyond this distance from the
+ * sender are found with a spatial index and skipped, so that the cost of a
+ * transmission does not grow with the number of distant PHYs.
  */
 class YansWifiChannel : public Channel
 {
@@ -113,9 +121,38 @@ class YansWifiChannel : public Channel
      */
     static void Receive(Ptr<YansWifiPhy> receiver, Ptr<const WifiPpdu> ppdu, double txPowerDbm);
 
+    /// A reception to start, and the reception power (dBm)
+    using Rx = std::pair<Ptr<YansWifiPhy>, double>;
+
+    /**
+     * This method is scheduled by Send for each batch of receptions with the
+     * same propagation delay, if BatchReceptions is set. It calls Receive for
+     * each reception of the batch, in order.
+     *
+     * \param batch the receptions
+     * \param ppdu the PPDU being sent
+     */
+    static void ReceiveBatch(const std::vector<Rx>& batch, Ptr<const WifiPpdu> ppdu);
+
+    /**
+     * \param phy a PHY
+     * \returns the ID of the node of the PHY, used as the context of its receptions
+     */
+    static uint32_t GetContext(Ptr<YansWifiPhy> phy);
+
     PhyList m_phyList;                  //!< List of YansWifiPhys connected to this YansWifiChannel
     Ptr<PropagationLossModel> m_loss;   //!< Propagation loss model
     Ptr<PropagationDelayModel> m_delay; //!< Propagation delay model
+
+    double m_maxRange; //!< Maximum distance between the sender and the receivers (m)
+    /// Spatial index of m_phyList, built on the first transmission following a change
+    mutable Ptr<MobilityGridIndex> m_rxIndex;
+    mutable std::vector<uint32_t> m_rxIds; //!< Positions in m_phyList of the PHYs in range
+    mutable PhyList m_rxPhysInRange;       //!< PHYs within range of the current transmission
+
+    bool m_batchReceptions; //!< Whether the receptions with the same delay are batched
+    /// Receptions of the current transmission to batch, with their propagation delay
+    mutable std::vector<std::pair<Time, Rx>> m_rxBatches;
 };
 
 } // namespace ns3
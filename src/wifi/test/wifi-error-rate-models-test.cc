@@ -25,11 +25,16 @@
 #include <gsl/gsl_sf_bessel.h>
 #endif
 
+#include "ns3/cached-error-rate-model.h"
 #include "ns3/dsss-error-rate-model.h"
 #include "ns3/he-phy.h" //includes HT and VHT
 #include "ns3/interference-helper.h"
 #include "ns3/log.h"
 #include "ns3/nist-error-rate-model.h"
+#include "ns3/object-factory.h"
+#include "ns3/pointer.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/string.h"
 #include "ns3/table-based-error-rate-model.h"
 #include "ns3/test.h"
 #include "ns3/wifi-phy.h"
@@ -1039,6 +1044,132 @@ TableBasedErrorRateTestCase::DoRun()
     }
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Error rate model counting the chunk success rates computed by a NIST model
+ */
+class CountingErrorRateModel : public ErrorRateModel
+{
+  public:
+    uint32_t m_count{0}; ///< the number of chunk success rates computed
+
+  private:
+    double DoGetChunkSuccessRate(WifiMode mode,
+                                 const WifiTxVector& txVector,
+                                 double snr,
+                                 uint64_t nbits,
+                                 uint8_t numRxAntennas,
+                                 WifiPpduField field,
+                                 uint16_t staId) const override
+    {
+        ++const_cast<CountingErrorRateModel*>(this)->m_count;
+        return m_nist->GetChunkSuccessRate(mode, txVector, snr, nbits, numRxAntennas, field, staId);
+    }
+
+    Ptr<NistErrorRateModel> m_nist{CreateObject<NistErrorRateModel>()}; ///< the NIST model
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Cached Error Rate Model Test Case
+ *
+ * Compare the chunk success rates interpolated by CachedErrorRateModel with
+ * those of the NIST and YANS models, and check that the tables are read back
+ * from the cache file.
+ */
+class CachedErrorRateModelTestCase : public TestCase
+{
+  public:
+    CachedErrorRateModelTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+CachedErrorRateModelTestCase::CachedErrorRateModelTestCase()
+    : TestCase("Check the accuracy of CachedErrorRateModel and its cache file")
+{
+}
+
+void
+CachedErrorRateModelTestCase::DoRun()
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+    Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+
+    const std::vector<std::pair<WifiMode, WifiPreamble>> modes{
+        {OfdmPhy::GetOfdmRate6Mbps(), WIFI_PREAMBLE_LONG},
+        {OfdmPhy::GetOfdmRate54Mbps(), WIFI_PREAMBLE_LONG},
+        {HtPhy::GetHtMcs3(), WIFI_PREAMBLE_HT_MF},
+        {VhtPhy::GetVhtMcs8(), WIFI_PREAMBLE_VHT_SU},
+        {HePhy::GetHeMcs11(), WIFI_PREAMBLE_HE_SU}};
+    const std::vector<Ptr<ErrorRateModel>> models{CreateObject<NistErrorRateModel>(),
+                                                  CreateObject<YansErrorRateModel>()};
+    for (const auto& model : models)
+    {
+        Ptr<CachedErrorRateModel> cached = CreateObject<CachedErrorRateModel>();
+        cached->SetErrorRateModel(model);
+        for (const auto& [mode, preamble] : modes)
+        {
+            WifiTxVector txVector;
+            txVector.SetMode(mode);
+            txVector.SetPreambleType(preamble);
+            txVector.SetChannelWidth(20);
+            for (uint32_t i = 0; i < 2000; ++i)
+            {
+                double snr = DbToRatio(random->GetValue(-5, 45));
+                uint64_t nbits = random->GetInteger(1, 100000);
+                double expected = model->GetChunkSuccessRate(mode, txVector, snr, nbits);
+                double csr = cached->GetChunkSuccessRate(mode, txVector, snr, nbits);
+                NS_TEST_ASSERT_MSG_EQ_TOL(csr,
+                                          expected,
+                                          0.001,
+                                          "Inaccurate chunk success rate for " << mode);
+            }
+        }
+    }
+
+    // the first model writes the tables to the cache file, the second reads them
+    std::string cacheFile = CreateTempDirFilename("cached-error-rate-model.txt");
+    WifiTxVector txVector;
+    txVector.SetMode(HePhy::GetHeMcs5());
+    txVector.SetPreambleType(WIFI_PREAMBLE_HE_SU);
+    txVector.SetChannelWidth(40);
+    std::vector<double> values;
+    for (uint32_t run = 0; run < 2; ++run)
+    {
+        Ptr<CountingErrorRateModel> counting = CreateObject<CountingErrorRateModel>();
+        Ptr<CachedErrorRateModel> cached = CreateObjectWithAttributes<CachedErrorRateModel>(
+            "ErrorRateModel",
+            PointerValue(counting),
+            "CacheFile",
+            StringValue(cacheFile));
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            double csr = cached->GetChunkSuccessRate(txVector.GetMode(),
+                                                     txVector,
+                                                     DbToRatio(10 + 0.17 * i),
+                                                     1000 + 37 * i);
+            if (run == 0)
+            {
+                values.push_back(csr);
+            }
+            else
+            {
+                NS_TEST_EXPECT_MSG_EQ(csr, values[i], "Different value read from the cache file");
+            }
+        }
+        NS_TEST_EXPECT_MSG_EQ((counting->m_count == 0),
+                              (run == 1),
+                              "The table should only be computed in the first run");
+    }
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -1106,6 +1237,7 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite()
                                                 HePhy::GetHeMcs11(),
                                                 1458),
                 TestCase::QUICK);
+    AddTestCase(new CachedErrorRateModelTestCase, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite; ///< the test suite
@@ -4683,6 +4683,225 @@ TestPrimary20CoveredByPpdu::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Flat NI changes test
+ *
+ * This test checks that the InterferenceHelper computes the same SNRs, PERs and energy
+ * durations whether it stores the NI changes in flat arrays or in multimaps. PPDUs are
+ * received while interfering signals start before, during and after their PHY header.
+ */
+class TestFlatNiChanges : public TestCase
+{
+  public:
+    TestFlatNiChanges();
+
+  private:
+    void DoRun() override;
+
+    /// The events of a signal in each interference helper
+    using Events = std::pair<Ptr<Event>, Ptr<Event>>;
+
+    /**
+     * Add a signal, starting now, to both interference helpers.
+     * \param duration the duration of the signal
+     * \param rxPowerW the received power in watts
+     * \return the events of the signal
+     */
+    Events AddSignal(Time duration, double rxPowerW);
+    /**
+     * Schedule the reception of a PPDU in 200 us, and interfering signals starting from
+     * now to the end of the reception.
+     * \param rxPowerW the received power in watts
+     */
+    void ScheduleReception(double rxPowerW);
+    /**
+     * Start receiving a PPDU.
+     * \param duration the duration of the PPDU
+     * \param rxPowerW the received power in watts
+     */
+    void StartReception(Time duration, double rxPowerW);
+    /**
+     * Check the SNR and the PER of the PHY header and of the MPDUs of the PPDU being
+     * received, and end its reception.
+     * \param events the events of the PPDU
+     */
+    void EndReception(Events events);
+    /**
+     * Check the SNR of the PPDU being received.
+     * \param events the events of the PPDU
+     */
+    void CheckSnr(Events events);
+    /**
+     * Check the duration the energy on the medium is above a threshold.
+     * \param energyW the threshold in watts
+     */
+    void CheckEnergyDuration(double energyW);
+
+    Ptr<InterferenceHelper> m_multimap; ///< the interference helper using multimaps
+    Ptr<InterferenceHelper> m_flat;     ///< the interference helper using flat arrays
+    WifiSpectrumBand m_band;            ///< the band
+    WifiTxVector m_txVector;            ///< the TXVECTOR of the signals
+    Ptr<UniformRandomVariable> m_random; ///< the random variable
+};
+
+TestFlatNiChanges::TestFlatNiChanges()
+    : TestCase("Check that the InterferenceHelper gives the same results whether the NI changes "
+               "are stored in flat arrays or in multimaps"),
+      m_band(1, 242),
+      m_txVector(HePhy::GetHeMcs(5), 0, WIFI_PREAMBLE_HE_SU, 800, 1, 1, 0, 20, false)
+{
+}
+
+TestFlatNiChanges::Events
+TestFlatNiChanges::AddSignal(Time duration, double rxPowerW)
+{
+    WifiMacHeader hdr;
+    hdr.SetType(WIFI_MAC_QOSDATA);
+    hdr.SetQosTid(0);
+    Ptr<WifiPpdu> ppdu = Create<WifiPpdu>(Create<WifiPsdu>(Create<Packet>(1000), hdr),
+                                          m_txVector,
+                                          WifiPhyOperatingChannel());
+    RxPowerWattPerChannelBand rxPowerMultimap{{m_band, rxPowerW}};
+    RxPowerWattPerChannelBand rxPowerFlat{{m_band, rxPowerW}};
+    return {m_multimap->Add(ppdu, m_txVector, duration, rxPowerMultimap, WHOLE_WIFI_SPECTRUM),
+            m_flat->Add(ppdu, m_txVector, duration, rxPowerFlat, WHOLE_WIFI_SPECTRUM)};
+}
+
+void
+TestFlatNiChanges::ScheduleReception(double rxPowerW)
+{
+    Time start = MicroSeconds(200);
+    Time duration = WifiPhy::CalculateTxDuration(3000, m_txVector, WIFI_PHY_BAND_5GHZ);
+    Simulator::Schedule(start, &TestFlatNiChanges::StartReception, this, duration, rxPowerW);
+    uint32_t nSignals = m_random->GetInteger(0, 6);
+    for (uint32_t i = 0; i < nSignals; ++i)
+    {
+        Time interferenceStart =
+            MicroSeconds(m_random->GetInteger(0, (start + duration).GetMicroSeconds()));
+        Simulator::Schedule(interferenceStart,
+                            &TestFlatNiChanges::AddSignal,
+                            this,
+                            MicroSeconds(m_random->GetInteger(1, 400)),
+                            rxPowerW * m_random->GetValue(0.01, 0.5));
+    }
+    Simulator::Schedule(start + MicroSeconds(m_random->GetInteger(0, duration.GetMicroSeconds())),
+                        &TestFlatNiChanges::CheckEnergyDuration,
+                        this,
+                        rxPowerW * m_random->GetValue(0.01, 1));
+}
+
+void
+TestFlatNiChanges::StartReception(Time duration, double rxPowerW)
+{
+    Events events = AddSignal(duration, rxPowerW);
+    m_multimap->NotifyRxStart();
+    m_flat->NotifyRxStart();
+    Simulator::Schedule(duration / 2, &TestFlatNiChanges::CheckSnr, this, events);
+    Simulator::Schedule(duration, &TestFlatNiChanges::EndReception, this, events);
+}
+
+void
+TestFlatNiChanges::CheckSnr(Events events)
+{
+    double multimap = m_multimap->CalculateSnr(events.first, 20, 1, m_band, WHOLE_WIFI_SPECTRUM);
+    double flat = m_flat->CalculateSnr(events.second, 20, 1, m_band, WHOLE_WIFI_SPECTRUM);
+    NS_TEST_EXPECT_MSG_EQ(flat, multimap, "Different SNRs at " << Simulator::Now());
+}
+
+void
+TestFlatNiChanges::EndReception(Events events)
+{
+    for (auto header : {WIFI_PPDU_FIELD_NON_HT_HEADER, WIFI_PPDU_FIELD_SIG_A})
+    {
+        auto multimap = m_multimap->CalculatePhyHeaderSnrPer(events.first,
+                                                             20,
+                                                             m_band,
+                                                             WHOLE_WIFI_SPECTRUM,
+                                                             header);
+        auto flat = m_flat->CalculatePhyHeaderSnrPer(events.second,
+                                                     20,
+                                                     m_band,
+                                                     WHOLE_WIFI_SPECTRUM,
+                                                     header);
+        NS_TEST_EXPECT_MSG_EQ(flat.snr, multimap.snr, "Different header SNRs");
+        NS_TEST_EXPECT_MSG_EQ(flat.per, multimap.per, "Different header PERs");
+    }
+
+    // an A-MPDU of 3 MPDUs
+    Time payloadDuration = events.first->GetDuration() -
+                           WifiPhy::CalculatePhyPreambleAndHeaderDuration(m_txVector);
+    for (int64_t i = 0; i < 3; ++i)
+    {
+        std::pair<Time, Time> window{payloadDuration * i / 3, payloadDuration * (i + 1) / 3};
+        auto multimap = m_multimap->CalculatePayloadSnrPer(events.first,
+                                                           20,
+                                                           m_band,
+                                                           WHOLE_WIFI_SPECTRUM,
+                                                           SU_STA_ID,
+                                                           window);
+        auto flat = m_flat->CalculatePayloadSnrPer(events.second,
+                                                   20,
+                                                   m_band,
+                                                   WHOLE_WIFI_SPECTRUM,
+                                                   SU_STA_ID,
+                                                   window);
+        NS_TEST_EXPECT_MSG_EQ(flat.snr, multimap.snr, "Different payload SNRs");
+        NS_TEST_EXPECT_MSG_EQ(flat.per, multimap.per, "Different payload PERs");
+    }
+
+    m_multimap->NotifyRxEnd(Simulator::Now(), WHOLE_WIFI_SPECTRUM);
+    m_flat->NotifyRxEnd(Simulator::Now(), WHOLE_WIFI_SPECTRUM);
+}
+
+void
+TestFlatNiChanges::CheckEnergyDuration(double energyW)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_flat->GetEnergyDuration(energyW, m_band, WHOLE_WIFI_SPECTRUM),
+                          m_multimap->GetEnergyDuration(energyW, m_band, WHOLE_WIFI_SPECTRUM),
+                          "Different energy durations at " << Simulator::Now());
+}
+
+void
+TestFlatNiChanges::DoRun()
+{
+    m_random = CreateObject<UniformRandomVariable>();
+    m_random->SetStream(1);
+    m_multimap = CreateObjectWithAttributes<InterferenceHelper>("FlatNiChanges",
+                                                                BooleanValue(false));
+    m_flat = CreateObjectWithAttributes<InterferenceHelper>("FlatNiChanges", BooleanValue(true));
+    for (auto interference : {m_multimap, m_flat})
+    {
+        interference->SetNoiseFigure(DbToRatio(7));
+        interference->SetErrorRateModel(CreateObject<NistErrorRateModel>());
+        interference->AddBand(m_band, WHOLE_WIFI_SPECTRUM);
+    }
+
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        // received power from -82 dBm to -62 dBm
+        Simulator::Schedule(MilliSeconds(2 * i + 1),
+                            &TestFlatNiChanges::ScheduleReception,
+                            this,
+                            DbmToW(-82 + 20 * m_random->GetValue()));
+    }
+    // as when the channel is switched
+    for (auto interference : {m_multimap, m_flat})
+    {
+        Simulator::Schedule(MilliSeconds(200),
+                            &InterferenceHelper::EraseEvents,
+                            interference,
+                            WHOLE_WIFI_SPECTRUM);
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+
+    m_multimap->Dispose();
+    m_flat->Dispose();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -4706,6 +4925,7 @@ WifiPhyReceptionTestSuite::WifiPhyReceptionTestSuite()
     AddTestCase(new TestUnsupportedModulationReception(), TestCase::QUICK);
     AddTestCase(new TestUnsupportedBandwidthReception(), TestCase::QUICK);
     AddTestCase(new TestPrimary20CoveredByPpdu(), TestCase::QUICK);
+    AddTestCase(new TestFlatNiChanges(), TestCase::QUICK);
 }
 
 static WifiPhyReceptionTestSuite wifiPhyReceptionTestSuite; ///< the test suite
@@ -23,6 +23,7 @@
 
 #include "ns3/command-line.h"
 #include "ns3/packet-metadata.h"
+#include "ns3/packet-tag-list.h"
 #include "ns3/packet.h"
 #include "ns3/system-wall-clock-ms.h"
 
@@ -332,6 +333,60 @@ benchFragment(uint32_t n)
     }
 }
 
+static void
+benchAggregation(uint32_t n)
+{
+    BenchHeader<30> mac;
+    BenchHeader<4> delimiter;
+    const uint32_t mpduSize = 1500 + 30 + 4;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        /* Aggregate 32 MPDUs, as done for an A-MPDU */
+        Ptr<Packet> ampdu = Create<Packet>();
+        for (uint32_t j = 0; j < 32; j++)
+        {
+            Ptr<Packet> mpdu = Create<Packet>(1500);
+            mpdu->AddHeader(mac);
+            mpdu->AddHeader(delimiter);
+            ampdu->AddAtEnd(mpdu);
+        }
+
+        /* Deaggregate */
+        for (uint32_t offset = 0; offset < ampdu->GetSize(); offset += mpduSize)
+        {
+            Ptr<Packet> mpdu = ampdu->CreateFragment(offset, mpduSize);
+            mpdu->RemoveHeader(delimiter);
+            mpdu->RemoveHeader(mac);
+        }
+    }
+}
+
+static void
+benchSegmentation(uint32_t n)
+{
+    BenchHeader<20> tcp;
+    uint8_t payload[4096];
+    std::fill(payload, payload + sizeof(payload), 0x42);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        /* Queue 16 application writes, as done by a TCP sender */
+        Ptr<Packet> txBuffer = Create<Packet>();
+        for (uint32_t j = 0; j < 16; j++)
+        {
+            txBuffer->AddAtEnd(Create<Packet>(payload, sizeof(payload)));
+        }
+
+        /* Cut segments */
+        for (uint32_t offset = 0; offset + 1448 <= txBuffer->GetSize(); offset += 1448)
+        {
+            Ptr<Packet> segment = txBuffer->CreateFragment(offset, 1448);
+            segment->AddHeader(tcp);
+        }
+    }
+}
+
 static void
 benchByteTags(uint32_t n)
 {
@@ -350,6 +405,40 @@ benchByteTags(uint32_t n)
     }
 }
 
+static void
+benchForwarding(uint32_t n)
+{
+    BenchHeader<25> ipv4;
+    BenchHeader<8> udp;
+    BenchTag<4> flowId;
+    BenchTag<3> bearer;
+    BenchTag<2> phy;
+    BenchTag<8> snr;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(1000);
+        p->AddHeader(udp);
+        p->AddHeader(ipv4);
+        p->AddPacketTag(flowId);
+        for (uint32_t hop = 0; hop < 10; hop++)
+        {
+            // The sender tags the packet, the channel delivers a copy of it
+            p->AddPacketTag(bearer);
+            p->AddPacketTag(phy);
+            Ptr<Packet> rx = p->Copy();
+            rx->AddPacketTag(snr);
+            // The receiver strips the per hop tags and forwards the packet
+            rx->RemovePacketTag(phy);
+            rx->RemovePacketTag(snr);
+            rx->RemovePacketTag(bearer);
+            rx->RemoveHeader(ipv4);
+            rx->AddHeader(ipv4);
+            p = rx;
+        }
+    }
+}
+
 static uint64_t
 runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
 {
@@ -364,16 +453,21 @@ static void
 runBench(void (*bench)(uint32_t), uint32_t n, uint32_t minIterations, const char* name)
 {
     uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    uint64_t allocations = PacketTagList::GetHeapAllocations();
     for (uint32_t i = 0; i < minIterations; i++)
     {
         uint64_t delay = runBenchOneIteration(bench, n);
         minDelay = std::min(minDelay, delay);
     }
+    allocations = PacketTagList::GetHeapAllocations() - allocations;
     double ps = n;
     ps *= 1000;
     ps /= minDelay;
+    double tagAllocations = allocations;
+    tagAllocations /= static_cast<double>(n) * minIterations;
     std::cout << ps << " packets/s"
-              << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+              << " (" << minDelay << " ms elapsed, " << tagAllocations
+              << " packet tag allocations/packet)\t" << name << std::endl;
 }
 
 int
@@ -382,6 +476,7 @@ main(int argc, char* argv[])
     uint32_t n = 0;
     uint32_t minIterations = 1;
     bool enablePrinting = false;
+    bool compact = false;
 
     CommandLine cmd(__FILE__);
     cmd.Usage("Benchmark Packet class");
@@ -390,8 +485,20 @@ main(int argc, char* argv[])
                  "number of subiterations to minimize iteration time over",
                  minIterations);
     cmd.AddValue("enable-printing", "enable packet printing", enablePrinting);
+    cmd.AddValue("compact",
+                 "enable packet printing with the compact metadata encoding",
+                 compact);
     cmd.Parse(argc, argv);
 
+    if (compact)
+    {
+        Packet::EnableCompactPrinting();
+    }
+    else if (enablePrinting)
+    {
+        Packet::EnablePrinting();
+    }
+
     if (n == 0)
     {
         std::cerr << "Error-- number of packets must be specified "
@@ -406,7 +513,10 @@ main(int argc, char* argv[])
     runBench(&benchC, n, minIterations, "Remove by func call");
     runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags");
     runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
+    runBench(&benchAggregation, n, minIterations, "Aggregation and deaggregation");
+    runBench(&benchSegmentation, n, minIterations, "Segmentation of a send buffer");
     runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
+    runBench(&benchForwarding, n, minIterations, "Forwarding through a 10-hop chain");
 
     return 0;
 }
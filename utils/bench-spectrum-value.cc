@@ -0,0 +1,183 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the SpectrumValue arithmetic for the
+// value sizes of a 100 RB LTE carrier and of a 996 tone HE resource unit.
+// Sample usage:  ./ns3 run 'bench-spectrum-value --n=100000'
+
+#include "ns3/command-line.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+
+using namespace ns3;
+
+/// The operands of the benchmarks
+struct BenchValues
+{
+    /**
+     * Create the operands.
+     * \param size the number of values
+     */
+    BenchValues(uint32_t size);
+
+    SpectrumValue a;     //!< the first operand
+    SpectrumValue b;     //!< the second operand
+    SpectrumValue c;     //!< the third operand
+    SpectrumValue noise; //!< a noise power spectral density
+    double sink;         //!< accumulates the results, so that they are not optimized out
+};
+
+BenchValues::BenchValues(uint32_t size)
+    : sink(0)
+{
+    std::vector<double> freqs;
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        freqs.push_back(2.4e9 + i * 78125);
+    }
+    Ptr<SpectrumModel> model = Create<SpectrumModel>(freqs);
+    a = SpectrumValue(model);
+    b = SpectrumValue(model);
+    c = SpectrumValue(model);
+    noise = SpectrumValue(model);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        a[i] = 1e-12 * (2 + std::sin(i));
+        b[i] = 1e-12 * (2 + std::cos(i));
+        c[i] = 1 + 0.5 * std::sin(0.1 * i);
+        noise[i] = 4e-21;
+    }
+}
+
+static void
+benchOperators(BenchValues& v, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        SpectrumValue x = v.a + v.b * v.c;
+        v.sink += x[0];
+    }
+}
+
+static void
+benchMultiplyAdd(BenchValues& v, uint32_t n)
+{
+    SpectrumValue x = v.a;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        x.MultiplyAdd(v.b, v.c);
+    }
+    v.sink += x[0];
+}
+
+static void
+benchScaleAdd(BenchValues& v, uint32_t n)
+{
+    SpectrumValue x = v.a;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        x.ScaleAdd(1e-6, v.b);
+    }
+    v.sink += x[0];
+}
+
+static void
+benchSinr(BenchValues& v, uint32_t n)
+{
+    // as computed by SpectrumInterference for each chunk
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        SpectrumValue sinr = v.a / (v.b - v.a + v.noise);
+        v.sink += sinr[0];
+    }
+}
+
+static void
+benchIntegral(BenchValues& v, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        v.sink += Integral(v.a * v.c);
+    }
+}
+
+static void
+benchLog2(BenchValues& v, uint32_t n)
+{
+    // as computed by ShannonSpectrumErrorModel for each chunk
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        SpectrumValue capacity = Log2(1 + v.c);
+        v.sink += capacity[0];
+    }
+}
+
+static void
+runBench(void (*bench)(BenchValues&, uint32_t),
+         BenchValues& values,
+         uint32_t n,
+         uint32_t minIterations,
+         const std::string& name)
+{
+    uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    for (uint32_t i = 0; i < minIterations; i++)
+    {
+        SystemWallClockMs time;
+        time.Start();
+        (*bench)(values, n);
+        minDelay = std::min<uint64_t>(minDelay, time.End());
+    }
+    double ns = minDelay * 1e6 / n;
+    std::cout << ns << " ns/op"
+              << " (" << minDelay << " ms elapsed)\t" << name << " [" << values.a.GetValuesN()
+              << " values]" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 100000;
+    uint32_t minIterations = 3;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark SpectrumValue arithmetic");
+    cmd.AddValue("n", "number of operations", n);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    double sink = 0;
+    // 100 RB LTE carrier, 996 tone HE resource unit
+    for (uint32_t size : {100, 996})
+    {
+        BenchValues values(size);
+        runBench(&benchOperators, values, n, minIterations, "x = a + b * c");
+        runBench(&benchMultiplyAdd, values, n, minIterations, "x.MultiplyAdd (b, c)");
+        runBench(&benchScaleAdd, values, n, minIterations, "x.ScaleAdd (s, b)");
+        runBench(&benchSinr, values, n, minIterations, "sinr = a / (b - a + noise)");
+        runBench(&benchIntegral, values, n, minIterations, "Integral (a * c)");
+        runBench(&benchLog2, values, n, minIterations, "Log2 (1 + c)");
+        sink += values.sink;
+    }
+    std::cout << "(checksum " << sink << ")" << std::endl;
+
+    return 0;
+}